@@ -0,0 +1,242 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "pixel_codec.h"
+
+#include <limits>
+
+#include "securec.h"
+
+namespace OHOS {
+namespace UDMF {
+namespace {
+constexpr size_t PIXEL_BYTES = 4;
+constexpr size_t HEADER_SIZE = sizeof(uint32_t);
+constexpr size_t INDEX_SIZE = 64;
+constexpr size_t MAX_RUN = 62;
+// the largest op, and the most raw bytes a single op byte stands for
+constexpr size_t MAX_OP_SIZE = 5;
+// the most bytes written for a pixel: the run ended by the pixel and the op of the pixel
+constexpr size_t MAX_STEP_SIZE = 1 + MAX_OP_SIZE;
+constexpr size_t MAX_EXPANSION = MAX_RUN * PIXEL_BYTES;
+
+constexpr uint8_t OP_INDEX = 0x00;
+constexpr uint8_t OP_DIFF = 0x40;
+constexpr uint8_t OP_LUMA = 0x80;
+constexpr uint8_t OP_RUN = 0xc0;
+constexpr uint8_t OP_RGB = 0xfe;
+constexpr uint8_t OP_RGBA = 0xff;
+constexpr uint8_t OP_MASK = 0xc0;
+
+struct Pixel {
+    uint8_t r = 0;
+    uint8_t g = 0;
+    uint8_t b = 0;
+    uint8_t a = 0xff;
+
+    bool operator==(const Pixel &other) const
+    {
+        return r == other.r && g == other.g && b == other.b && a == other.a;
+    }
+};
+
+inline size_t Hash(const Pixel &pixel)
+{
+    constexpr uint32_t r = 3;
+    constexpr uint32_t g = 5;
+    constexpr uint32_t b = 7;
+    constexpr uint32_t a = 11;
+    return (pixel.r * r + pixel.g * g + pixel.b * b + pixel.a * a) % INDEX_SIZE;
+}
+
+size_t ReadHeader(const std::vector<uint8_t> &encoded)
+{
+    size_t size = 0;
+    for (size_t i = 0; i < HEADER_SIZE && i < encoded.size(); ++i) {
+        size = (size << 8) | encoded[i];
+    }
+    return size;
+}
+} // namespace
+
+bool PixelCodec::Encode(const std::vector<uint8_t> &raw, std::vector<uint8_t> &encoded)
+{
+    if (raw.size() < MIN_ENCODE_SIZE || raw.size() > std::numeric_limits<uint32_t>::max()) {
+        return false;
+    }
+    size_t count = raw.size() / PIXEL_BYTES;
+    size_t tail = raw.size() % PIXEL_BYTES;
+    // encoding stops as soon as it is no smaller than the raw data
+    size_t limit = raw.size() - tail;
+    std::vector<uint8_t> out(HEADER_SIZE + limit + MAX_STEP_SIZE + tail);
+    uint8_t *dst = out.data();
+    auto size = static_cast<uint32_t>(raw.size());
+    for (size_t i = 0; i < HEADER_SIZE; ++i) {
+        dst[i] = static_cast<uint8_t>(size >> ((HEADER_SIZE - 1 - i) * 8));
+    }
+    size_t pos = HEADER_SIZE;
+    Pixel index[INDEX_SIZE] = {};
+    Pixel prev;
+    size_t run = 0;
+    const uint8_t *src = raw.data();
+    for (size_t i = 0; i < count; ++i, src += PIXEL_BYTES) {
+        // checked for every pixel, runs included, so the bytes of a step always fit in the room left past the limit
+        if (pos > limit) {
+            return false;
+        }
+        Pixel pixel = { src[0], src[1], src[2], src[3] };
+        if (pixel == prev) {
+            if (++run == MAX_RUN || i + 1 == count) {
+                dst[pos++] = static_cast<uint8_t>(OP_RUN | (run - 1));
+                run = 0;
+            }
+            continue;
+        }
+        if (run > 0) {
+            dst[pos++] = static_cast<uint8_t>(OP_RUN | (run - 1));
+            run = 0;
+        }
+        size_t hash = Hash(pixel);
+        if (index[hash] == pixel) {
+            dst[pos++] = static_cast<uint8_t>(OP_INDEX | hash);
+            prev = pixel;
+            continue;
+        }
+        index[hash] = pixel;
+        if (pixel.a != prev.a) {
+            dst[pos++] = OP_RGBA;
+            dst[pos++] = pixel.r;
+            dst[pos++] = pixel.g;
+            dst[pos++] = pixel.b;
+            dst[pos++] = pixel.a;
+            prev = pixel;
+            continue;
+        }
+        auto dr = static_cast<int8_t>(pixel.r - prev.r);
+        auto dg = static_cast<int8_t>(pixel.g - prev.g);
+        auto db = static_cast<int8_t>(pixel.b - prev.b);
+        auto drg = static_cast<int8_t>(dr - dg);
+        auto dbg = static_cast<int8_t>(db - dg);
+        if (dr >= -2 && dr <= 1 && dg >= -2 && dg <= 1 && db >= -2 && db <= 1) {
+            dst[pos++] = static_cast<uint8_t>(OP_DIFF | ((dr + 2) << 4) | ((dg + 2) << 2) | (db + 2));
+        } else if (dg >= -32 && dg <= 31 && drg >= -8 && drg <= 7 && dbg >= -8 && dbg <= 7) {
+            dst[pos++] = static_cast<uint8_t>(OP_LUMA | (dg + 32));
+            dst[pos++] = static_cast<uint8_t>(((drg + 8) << 4) | (dbg + 8));
+        } else {
+            dst[pos++] = OP_RGB;
+            dst[pos++] = pixel.r;
+            dst[pos++] = pixel.g;
+            dst[pos++] = pixel.b;
+        }
+        prev = pixel;
+    }
+    if (pos + tail >= raw.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < tail; ++i) {
+        dst[pos++] = src[i];
+    }
+    out.resize(pos);
+    encoded = std::move(out);
+    return true;
+}
+
+bool PixelCodec::IsValidHeader(const std::vector<uint8_t> &encoded)
+{
+    if (encoded.size() < HEADER_SIZE) {
+        return false;
+    }
+    size_t size = ReadHeader(encoded);
+    return size <= (encoded.size() - HEADER_SIZE) * MAX_EXPANSION &&
+        encoded.size() >= HEADER_SIZE + size % PIXEL_BYTES;
+}
+
+size_t PixelCodec::GetDecodedSize(const std::vector<uint8_t> &encoded)
+{
+    return IsValidHeader(encoded) ? ReadHeader(encoded) : 0;
+}
+
+bool PixelCodec::Decode(const std::vector<uint8_t> &encoded, std::vector<uint8_t> &raw)
+{
+    // checked before allocating, so a forged size can not take more memory than the ops could fill
+    if (!IsValidHeader(encoded)) {
+        return false;
+    }
+    size_t size = ReadHeader(encoded);
+    size_t count = size / PIXEL_BYTES;
+    size_t tail = size % PIXEL_BYTES;
+    std::vector<uint8_t> out(size);
+    uint8_t *dst = out.data();
+    const uint8_t *src = encoded.data();
+    size_t end = encoded.size() - tail;
+    size_t pos = HEADER_SIZE;
+    Pixel index[INDEX_SIZE] = {};
+    Pixel pixel;
+    for (size_t i = 0; i < count;) {
+        if (pos >= end) {
+            return false;
+        }
+        uint8_t op = src[pos++];
+        size_t run = 1;
+        if (op == OP_RGB || op == OP_RGBA) {
+            size_t length = op == OP_RGB ? 3 : 4;
+            if (end - pos < length) {
+                return false;
+            }
+            pixel.r = src[pos++];
+            pixel.g = src[pos++];
+            pixel.b = src[pos++];
+            pixel.a = op == OP_RGB ? pixel.a : src[pos++];
+        } else if ((op & OP_MASK) == OP_INDEX) {
+            pixel = index[op & ~OP_MASK];
+        } else if ((op & OP_MASK) == OP_DIFF) {
+            pixel.r = static_cast<uint8_t>(pixel.r + ((op >> 4) & 0x03) - 2);
+            pixel.g = static_cast<uint8_t>(pixel.g + ((op >> 2) & 0x03) - 2);
+            pixel.b = static_cast<uint8_t>(pixel.b + (op & 0x03) - 2);
+        } else if ((op & OP_MASK) == OP_LUMA) {
+            if (pos >= end) {
+                return false;
+            }
+            uint8_t next = src[pos++];
+            int32_t dg = (op & ~OP_MASK) - 32;
+            pixel.r = static_cast<uint8_t>(pixel.r + dg - 8 + ((next >> 4) & 0x0f));
+            pixel.g = static_cast<uint8_t>(pixel.g + dg);
+            pixel.b = static_cast<uint8_t>(pixel.b + dg - 8 + (next & 0x0f));
+        } else {
+            run = (op & ~OP_MASK) + 1;
+            if (run > count - i) {
+                return false;
+            }
+        }
+        index[Hash(pixel)] = pixel;
+        i += run;
+        for (; run > 0; --run, dst += PIXEL_BYTES) {
+            dst[0] = pixel.r;
+            dst[1] = pixel.g;
+            dst[2] = pixel.b;
+            dst[3] = pixel.a;
+        }
+    }
+    if (pos != end) {
+        return false;
+    }
+    if (tail > 0 && memcpy_s(dst, tail, src + end, tail) != EOK) {
+        return false;
+    }
+    raw = std::move(out);
+    return true;
+}
+} // namespace UDMF
+} // namespace OHOS
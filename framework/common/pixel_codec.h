@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_PIXEL_CODEC_H
+#define UDMF_PIXEL_CODEC_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "unified_types.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * Lossless encoding of raw data made of four-byte pixels, in the way of QOI: a pixel is written as a run of the
+ * previous one, a reference to a recently seen one, a small difference to the previous one or in full. The bytes
+ * past the last whole pixel are kept as they are. Encoded data starts with the size of the raw data.
+ */
+class PixelCodec {
+public:
+    // the encodings this build decodes
+    static constexpr uint32_t DECODABLE = (1u << PIXEL_ENCODING_RAW) | (1u << PIXEL_ENCODING_QOI);
+    // raw data smaller than this is not worth encoding
+    static constexpr size_t MIN_ENCODE_SIZE = 4 * 1024;
+
+    // false if the raw data is too small or too large, or does not get smaller
+    static bool Encode(const std::vector<uint8_t> &raw, std::vector<uint8_t> &encoded);
+    static bool Decode(const std::vector<uint8_t> &encoded, std::vector<uint8_t> &raw);
+    // size of the raw data of encoded data, without decoding it; 0 if the header is not valid
+    static size_t GetDecodedSize(const std::vector<uint8_t> &encoded);
+    // false if the size in the header is more than the ops of the encoded data could fill, so a forged header is
+    // refused before anything is sized or allocated by it
+    static bool IsValidHeader(const std::vector<uint8_t> &encoded);
+
+    static bool IsDecodable(uint32_t encodings, int32_t encoding)
+    {
+        return encoding == PIXEL_ENCODING_RAW ||
+            (encoding > PIXEL_ENCODING_RAW && encoding < PIXEL_ENCODING_BUTT && (encodings & (1u << encoding)) != 0);
+    }
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_PIXEL_CODEC_H
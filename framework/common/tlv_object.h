@@ -46,6 +46,9 @@ struct TLVHead {
 
 class TLVObject {
 public:
+    // the most entries of a map or items of a counted list a reader takes
+    static constexpr uint32_t MAX_ITEM_COUNT = 16 * 1024;
+
     TLVObject() = default;
     ~TLVObject() = default;
     explicit TLVObject(std::vector<std::uint8_t> &buffer)
@@ -183,7 +186,7 @@ public:
         if (!ReadHead(head)) {
             return false;
         }
-        if (head.len == 0) {
+        if (head.len != sizeof(T)) {
             return false;
         }
         if (!HasExpectBuffer(head.len)) {
@@ -222,7 +225,7 @@ public:
         if (!ReadHead(head)) {
             return false;
         }
-        if (!HasExpectBuffer(head.len)) {
+        if (!HasExpectBuffer(head.len) || !Allocate(head.len)) {
             return false;
         }
         value.append(reinterpret_cast<const char *>(buffer_->data() + cursor_), head.len);
@@ -254,7 +257,7 @@ public:
         if (!ReadHead(head)) {
             return false;
         }
-        if (!HasExpectBuffer(head.len)) {
+        if (!HasExpectBuffer(head.len) || !Allocate(head.len)) {
             return false;
         }
         std::vector<uint8_t> buff(buffer_->data() + cursor_, buffer_->data() + cursor_ + head.len);
@@ -327,6 +330,7 @@ public:
         if (!HasExpectBuffer(head.len)) {
             return false;
         }
+        auto valueEnd = cursor_ + head.len;
         switch (head.tag) {
             case static_cast<uint16_t>(TAG::TAG_INT32): {
                 int32_t int32Value;
@@ -380,7 +384,8 @@ public:
                 return false;
             }
         }
-        return true;
+        // the value is to fill the variant exactly, a value overrunning it belongs to the next item
+        return cursor_ == valueEnd;
     }
 
     bool WriteMap(const UDDetails &value)
@@ -416,7 +421,11 @@ public:
             return false;
         }
         auto mapEnd = cursor_ + head.len;
+        uint32_t count = 0;
         while (cursor_ < mapEnd) {
+            if (++count > MAX_ITEM_COUNT) {
+                return false;
+            }
             std::string itemKey;
             if (!ReadString(itemKey)) {
                 return false;
@@ -427,6 +436,16 @@ public:
             }
             value.emplace(itemKey, itemValue);
         }
+        return cursor_ == mapEnd;
+    }
+
+    // the tag of the next item, which is not read
+    bool PeekTag(uint16_t &tag) const
+    {
+        if (!HasExpectBuffer(sizeof(TLVHead))) {
+            return false;
+        }
+        tag = NetToHost(reinterpret_cast<const TLVHead *>(buffer_->data() + cursor_)->tag);
         return true;
     }
 
@@ -459,8 +478,19 @@ private:
         return buffer_->size() >= cursor_ && buffer_->size() - cursor_ >= expectLen;
     }
 
+    // the strings and vectors read from a buffer never add up to more than the buffer itself
+    inline bool Allocate(const uint32_t len)
+    {
+        if (len > buffer_->size() - allocated_) {
+            return false;
+        }
+        allocated_ += len;
+        return true;
+    }
+
     std::size_t total_ = 0;
     std::size_t cursor_ = 0;
+    std::size_t allocated_ = 0;
     std::vector<std::uint8_t> *buffer_;
 };
 } // namespace UDMF
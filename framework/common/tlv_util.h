@@ -45,11 +45,11 @@ using namespace OHOS::UDMF;
 template<typename T>
 bool CountBufferSize(const T &input, TLVObject &data);
 
-template<>
-bool CountBufferSize(const std::shared_ptr<UnifiedRecord> &input, TLVObject &data)
+// counts a record written with the given uid in place of its own
+bool CountBufferSize(const std::shared_ptr<UnifiedRecord> &input, const std::string &uid, TLVObject &data)
 {
     data.Count(input->GetType());
-    data.Count(input->GetUid());
+    data.Count(uid);
     auto type = input->GetType();
     switch (type) {
         case UDType::TEXT: {
@@ -202,7 +202,10 @@ bool CountBufferSize(const std::shared_ptr<UnifiedRecord> &input, TLVObject &dat
             if (pixelMap == nullptr) {
                 return false;
             }
-            data.Count(pixelMap->GetRawData());
+            if (pixelMap->GetEncoding() != PIXEL_ENCODING_RAW) {
+                data.Count(pixelMap->GetEncoding());
+            }
+            data.Count(pixelMap->GetEncodedData());
             auto sdRecord = static_cast<SystemDefinedRecord *>(input.get());
             if (sdRecord == nullptr) {
                 return false;
@@ -226,6 +229,12 @@ bool CountBufferSize(const std::shared_ptr<UnifiedRecord> &input, TLVObject &dat
     return true;
 }
 
+template<>
+bool CountBufferSize(const std::shared_ptr<UnifiedRecord> &input, TLVObject &data)
+{
+    return CountBufferSize(input, input->GetUid(), data);
+}
+
 template<>
 bool CountBufferSize(const Runtime &input, TLVObject &data)
 {
@@ -246,6 +255,28 @@ bool CountBufferSize(const Runtime &input, TLVObject &data)
     return true;
 }
 
+template<>
+bool CountBufferSize(const Summary &input, TLVObject &data)
+{
+    int32_t size = input.summary.size();
+    data.Count(size);
+    for (const auto &item : input.summary) {
+        data.Count(item.first);
+        data.Count(item.second);
+    }
+    data.Count(input.totalSize);
+    return true;
+}
+
+template<>
+bool CountBufferSize(const Preview &input, TLVObject &data)
+{
+    data.Count(input.width);
+    data.Count(input.height);
+    data.Count(input.pixels);
+    return true;
+}
+
 template<typename T>
 bool Writing(const T &input, TLVObject &data);
 
@@ -735,7 +766,11 @@ bool Reading(SystemDefinedAppItem &output, TLVObject &data)
 template<>
 bool Writing(const SystemDefinedPixelMap &input, TLVObject &data)
 {
-    if (!Writing(input.GetRawData(), data)) {
+    // raw data is written alone, as before there were encodings
+    if (input.GetEncoding() != PIXEL_ENCODING_RAW && !Writing(input.GetEncoding(), data)) {
+        return false;
+    }
+    if (!Writing(input.GetEncodedData(), data)) {
         return false;
     }
     return true;
@@ -744,15 +779,22 @@ bool Writing(const SystemDefinedPixelMap &input, TLVObject &data)
 template<>
 bool Reading(SystemDefinedPixelMap &output, TLVObject &data)
 {
+    int32_t encoding = PIXEL_ENCODING_RAW;
     std::vector<uint8_t> rawData;
     UDDetails details;
+    uint16_t tag = TAG_BUTT;
+    if (!data.PeekTag(tag) || (tag == TAG_INT32 && !Reading(encoding, data))) {
+        return false;
+    }
     if (!Reading(rawData, data)) {
         return false;
     }
     if (!Reading(details, data)) {
         return false;
     }
-    output.SetRawData(rawData);
+    if (!output.SetEncodedData(std::move(rawData), encoding)) {
+        return false;
+    }
     output.SetDetails(details);
     return true;
 }
@@ -781,14 +823,14 @@ bool Reading(ApplicationDefinedRecord &output, TLVObject &data)
         return false;
     }
     output.SetApplicationDefinedType(type);
-    output.SetRawData(rawData);
+    output.SetRawData(std::move(rawData));
     return true;
 }
 
-template<>
-bool Writing(const std::shared_ptr<UnifiedRecord> &input, TLVObject &data)
+// writes a record with the given uid in place of its own, e.g. an empty one for a record stored apart from its uid
+bool Writing(const std::shared_ptr<UnifiedRecord> &input, const std::string &uid, TLVObject &data)
 {
-    if (!CountBufferSize(input, data)) {
+    if (!CountBufferSize(input, uid, data)) {
         return false;
     }
     data.UpdateSize();
@@ -796,7 +838,7 @@ bool Writing(const std::shared_ptr<UnifiedRecord> &input, TLVObject &data)
     if (!Writing(input->GetType(), data)) {
         return false;
     }
-    if (!Writing(input->GetUid(), data)) {
+    if (!Writing(uid, data)) {
         return false;
     }
     auto type = input->GetType();
@@ -961,6 +1003,12 @@ bool Writing(const std::shared_ptr<UnifiedRecord> &input, TLVObject &data)
     }
 }
 
+template<>
+bool Writing(const std::shared_ptr<UnifiedRecord> &input, TLVObject &data)
+{
+    return Writing(input, input->GetUid(), data);
+}
+
 template<>
 bool Reading(std::shared_ptr<UnifiedRecord> &output, TLVObject &data)
 {
@@ -1188,7 +1236,7 @@ bool Reading(DataStatus &output, TLVObject &data)
     if (!Reading(status, data)) {
         return false;
     }
-    if (status < DataStatus::WORKING || status >= DataStatus::FADE) {
+    if (status < DataStatus::WORKING || status > DataStatus::FADE) {
         return false;
     }
     output = static_cast<DataStatus>(status);
@@ -1262,6 +1310,9 @@ bool Reading(Runtime &output, TLVObject &data)
     if (!Reading(size, data)) {
         return false;
     }
+    if (size < 0 || static_cast<uint32_t>(size) > TLVObject::MAX_ITEM_COUNT) {
+        return false;
+    }
     for (int i = 0; i < size; ++i) {
         Privilege privilege;
         if (!Reading(privilege, data)) {
@@ -1302,6 +1353,74 @@ bool Reading(Runtime &output, TLVObject &data)
     output.deviceId = deviceId;
     return true;
 }
+
+template<>
+bool Writing(const Summary &input, TLVObject &data)
+{
+    (void)CountBufferSize(input, data);
+    data.UpdateSize();
+    int32_t size = input.summary.size();
+    if (!Writing(size, data)) {
+        return false;
+    }
+    for (const auto &item : input.summary) {
+        if (!Writing(item.first, data)) {
+            return false;
+        }
+        if (!Writing(item.second, data)) {
+            return false;
+        }
+    }
+    if (!Writing(input.totalSize, data)) {
+        return false;
+    }
+    return true;
+}
+
+template<>
+bool Reading(Summary &output, TLVObject &data)
+{
+    int32_t size;
+    if (!Reading(size, data)) {
+        return false;
+    }
+    if (size < 0 || static_cast<uint32_t>(size) > TLVObject::MAX_ITEM_COUNT) {
+        return false;
+    }
+    std::map<std::string, int64_t> summary;
+    for (int i = 0; i < size; ++i) {
+        std::string type;
+        int64_t typeSize;
+        if (!Reading(type, data)) {
+            return false;
+        }
+        if (!Reading(typeSize, data)) {
+            return false;
+        }
+        summary[type] = typeSize;
+    }
+    int64_t totalSize;
+    if (!Reading(totalSize, data)) {
+        return false;
+    }
+    output.summary = summary;
+    output.totalSize = totalSize;
+    return true;
+}
+
+template<>
+bool Writing(const Preview &input, TLVObject &data)
+{
+    (void)CountBufferSize(input, data);
+    data.UpdateSize();
+    return Writing(input.width, data) && Writing(input.height, data) && Writing(input.pixels, data);
+}
+
+template<>
+bool Reading(Preview &output, TLVObject &data)
+{
+    return Reading(output.width, data) && Reading(output.height, data) && Reading(output.pixels, data);
+}
 } // namespace TLVUtil
 } // namespace OHOS
 #endif // UDMF_TLV_UTIL_H
\ No newline at end of file
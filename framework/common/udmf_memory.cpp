@@ -0,0 +1,101 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udmf_memory.h"
+
+namespace OHOS {
+namespace UDMF {
+static constexpr const char *CATEGORY_NAMES[MEMORY_CATEGORY_BUTT] = {
+    "decodedRecord",
+    "tlvBuffer",
+    "parcel",
+    "cache",
+    "kvEntry",
+};
+
+MemoryAccount &MemoryAccount::GetInstance()
+{
+    static MemoryAccount instance;
+    return instance;
+}
+
+void MemoryAccount::Add(MemoryCategory category, int64_t bytes)
+{
+    if (category < 0 || category >= MEMORY_CATEGORY_BUTT || bytes <= 0) {
+        return;
+    }
+    Counter &counter = counters_[category];
+    int64_t current = counter.current.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    int64_t peak = counter.peak.load(std::memory_order_relaxed);
+    while (current > peak && !counter.peak.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+        // a failed exchange has reloaded the peak, which is raised again unless another thread raised it higher
+    }
+}
+
+void MemoryAccount::Release(MemoryCategory category, int64_t bytes)
+{
+    if (category < 0 || category >= MEMORY_CATEGORY_BUTT || bytes <= 0) {
+        return;
+    }
+    counters_[category].current.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+int64_t MemoryAccount::GetCurrent(MemoryCategory category) const
+{
+    if (category < 0 || category >= MEMORY_CATEGORY_BUTT) {
+        return 0;
+    }
+    return counters_[category].current.load(std::memory_order_relaxed);
+}
+
+int64_t MemoryAccount::GetPeak(MemoryCategory category) const
+{
+    if (category < 0 || category >= MEMORY_CATEGORY_BUTT) {
+        return 0;
+    }
+    return counters_[category].peak.load(std::memory_order_relaxed);
+}
+
+std::string MemoryAccount::Dump() const
+{
+    std::string result;
+    for (int32_t category = 0; category < MEMORY_CATEGORY_BUTT; ++category) {
+        result += "  " + std::string(CATEGORY_NAMES[category]) + ": current=" +
+            std::to_string(counters_[category].current.load(std::memory_order_relaxed)) + " peak=" +
+            std::to_string(counters_[category].peak.load(std::memory_order_relaxed)) + "\n";
+    }
+    return result;
+}
+
+MemoryCharge::MemoryCharge(MemoryCategory category, int64_t bytes) : category_(category)
+{
+    Add(bytes);
+}
+
+MemoryCharge::~MemoryCharge()
+{
+    MemoryAccount::GetInstance().Release(category_, bytes_);
+}
+
+void MemoryCharge::Add(int64_t bytes)
+{
+    if (bytes <= 0) {
+        return;
+    }
+    MemoryAccount::GetInstance().Add(category_, bytes);
+    bytes_ += bytes;
+}
+} // namespace UDMF
+} // namespace OHOS
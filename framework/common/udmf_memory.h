@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_MEMORY_H
+#define UDMF_MEMORY_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace UDMF {
+enum MemoryCategory : int32_t {
+    MEMORY_DECODED_RECORD = 0,
+    MEMORY_TLV_BUFFER,
+    MEMORY_PARCEL,
+    MEMORY_CACHE,
+    MEMORY_KV_ENTRY,
+    MEMORY_CATEGORY_BUTT
+};
+
+/*
+ * Counts the bytes held by the process in each category, together with the most ever held at once.
+ */
+class MemoryAccount {
+public:
+    static MemoryAccount &GetInstance();
+
+    void Add(MemoryCategory category, int64_t bytes);
+    void Release(MemoryCategory category, int64_t bytes);
+    int64_t GetCurrent(MemoryCategory category) const;
+    int64_t GetPeak(MemoryCategory category) const;
+    // a line per category with the bytes held now and the high-water mark
+    std::string Dump() const;
+
+private:
+    struct Counter {
+        std::atomic<int64_t> current{ 0 };
+        std::atomic<int64_t> peak{ 0 };
+    };
+
+    MemoryAccount() = default;
+
+    Counter counters_[MEMORY_CATEGORY_BUTT];
+};
+
+/*
+ * Charges bytes to a category from its construction to its destruction.
+ */
+class MemoryCharge {
+public:
+    MemoryCharge(MemoryCategory category, int64_t bytes);
+    ~MemoryCharge();
+    MemoryCharge(const MemoryCharge &) = delete;
+    MemoryCharge &operator=(const MemoryCharge &) = delete;
+    void Add(int64_t bytes);
+
+private:
+    MemoryCategory category_;
+    int64_t bytes_ = 0;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_MEMORY_H
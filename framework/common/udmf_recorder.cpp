@@ -0,0 +1,324 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udmf_recorder.h"
+
+#include <cerrno>
+#include <cstdlib>
+#include <fcntl.h>
+#include <fstream>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "logger.h"
+#include "udmf_tracer.h"
+
+namespace OHOS {
+namespace UDMF {
+struct CurrentRequest {
+    bool active = false;
+    int64_t begin = 0;
+    RecordedRequest request;
+    std::vector<std::string> keys;
+};
+
+static thread_local CurrentRequest g_current;
+
+static bool WriteAll(int fd, const std::string &text)
+{
+    const char *data = text.data();
+    size_t size = text.size();
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+static bool ParseInt(const std::string &text, int64_t &value)
+{
+    if (text.empty()) {
+        return false;
+    }
+    char *end = nullptr;
+    errno = 0;
+    value = strtoll(text.c_str(), &end, 10);
+    return errno == 0 && end == text.c_str() + text.size();
+}
+
+static std::vector<std::string> Split(const std::string &text, char separator)
+{
+    std::vector<std::string> pieces;
+    size_t begin = 0;
+    while (true) {
+        size_t end = text.find(separator, begin);
+        pieces.push_back(text.substr(begin, end == std::string::npos ? std::string::npos : end - begin));
+        if (end == std::string::npos) {
+            return pieces;
+        }
+        begin = end + 1;
+    }
+}
+
+RequestRecorder &RequestRecorder::GetInstance()
+{
+    static RequestRecorder instance;
+    return instance;
+}
+
+Status RequestRecorder::Start(const std::string &path)
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+    fd_ = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd_ < 0 || !WriteAll(fd_, std::string(HEADER) + "\n")) {
+        LOG_ERROR(UDMF_SERVICE, "Open recording failed, errno: %{public}d.", errno);
+        if (fd_ >= 0) {
+            close(fd_);
+            fd_ = -1;
+        }
+        recording_.store(false, std::memory_order_relaxed);
+        return E_ERROR;
+    }
+    start_ = Tracer::Now();
+    count_ = 0;
+    keyRefs_.clear();
+    recording_.store(true, std::memory_order_relaxed);
+    return E_OK;
+}
+
+void RequestRecorder::Stop()
+{
+    recording_.store(false, std::memory_order_relaxed);
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (fd_ >= 0) {
+        fsync(fd_);
+        close(fd_);
+        fd_ = -1;
+    }
+    keyRefs_.clear();
+}
+
+void RequestRecorder::Begin(uint32_t code)
+{
+    g_current = CurrentRequest();
+    if (!IsRecording()) {
+        return;
+    }
+    g_current.active = true;
+    g_current.begin = Tracer::Now();
+    g_current.request.code = code;
+}
+
+void RequestRecorder::SetIntention(int32_t intention)
+{
+    if (g_current.active) {
+        g_current.request.intention = intention;
+    }
+}
+
+void RequestRecorder::SetQuery(const std::string &key, int32_t version)
+{
+    if (!g_current.active) {
+        return;
+    }
+    g_current.request.version = version;
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = keyRefs_.find(key);
+    if (it != keyRefs_.end()) {
+        g_current.request.keyRef = it->second.first;
+        g_current.request.keyPos = it->second.second;
+    }
+}
+
+void RequestRecorder::AddData(UnifiedData &unifiedData)
+{
+    if (!g_current.active) {
+        return;
+    }
+    std::vector<std::pair<int32_t, int64_t>> records;
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record != nullptr) {
+            records.emplace_back(record->GetType(), record->GetSize());
+        }
+    }
+    g_current.request.datas.push_back(std::move(records));
+}
+
+void RequestRecorder::AddRecord(const std::shared_ptr<UnifiedRecord> &record)
+{
+    if (!g_current.active || record == nullptr) {
+        return;
+    }
+    g_current.request.datas.push_back({ { record->GetType(), record->GetSize() } });
+}
+
+void RequestRecorder::SetResult(const std::string &key)
+{
+    if (g_current.active) {
+        g_current.keys = { key };
+    }
+}
+
+void RequestRecorder::SetResult(const std::vector<std::string> &keys)
+{
+    if (g_current.active) {
+        g_current.keys = keys;
+    }
+}
+
+void RequestRecorder::End(int32_t status)
+{
+    if (!g_current.active) {
+        return;
+    }
+    g_current.active = false;
+    RecordedRequest &request = g_current.request;
+    request.duration = Tracer::Now() - g_current.begin;
+    request.status = status;
+    std::lock_guard<std::mutex> lock(mutex_);
+    // the request may have stopped the recording, or started a new one
+    if (fd_ < 0 || g_current.begin < start_) {
+        return;
+    }
+    request.offset = g_current.begin - start_;
+    int32_t index = count_++;
+    if (keyRefs_.size() + g_current.keys.size() > MAX_KEY_COUNT) {
+        keyRefs_.clear();
+    }
+    for (size_t pos = 0; pos < g_current.keys.size() && pos < MAX_KEY_COUNT; ++pos) {
+        keyRefs_[g_current.keys[pos]] = { index, static_cast<int32_t>(pos) };
+    }
+    if (!WriteAll(fd_, Format(request) + "\n")) {
+        LOG_ERROR(UDMF_SERVICE, "Write recording failed, errno: %{public}d.", errno);
+    }
+}
+
+std::string RequestRecorder::Format(const RecordedRequest &request)
+{
+    std::string line = std::to_string(request.code) + " " + std::to_string(request.offset) + " " +
+        std::to_string(request.duration) + " " + std::to_string(request.status) + " " +
+        std::to_string(request.intention) + " " + std::to_string(request.version) + " " +
+        std::to_string(request.keyRef) + " " + std::to_string(request.keyPos) + " ";
+    if (request.datas.empty()) {
+        return line + "-";
+    }
+    for (size_t i = 0; i < request.datas.size(); ++i) {
+        line += i == 0 ? "" : ";";
+        for (size_t j = 0; j < request.datas[i].size(); ++j) {
+            line += (j == 0 ? "" : ",") + std::to_string(request.datas[i][j].first) + ":" +
+                std::to_string(request.datas[i][j].second);
+        }
+    }
+    return line;
+}
+
+bool RequestRecorder::Parse(const std::string &line, RecordedRequest &request)
+{
+    // eight numbers, then the datas up to the end of the line
+    std::vector<std::string> fields = Split(line, ' ');
+    constexpr size_t fieldCount = 9;
+    int64_t values[fieldCount - 1] = {};
+    if (fields.size() != fieldCount) {
+        return false;
+    }
+    for (size_t i = 0; i < fieldCount - 1; ++i) {
+        if (!ParseInt(fields[i], values[i])) {
+            return false;
+        }
+    }
+    size_t index = 0;
+    request = RecordedRequest();
+    request.code = static_cast<uint32_t>(values[index++]);
+    request.offset = values[index++];
+    request.duration = values[index++];
+    request.status = static_cast<int32_t>(values[index++]);
+    request.intention = static_cast<int32_t>(values[index++]);
+    request.version = static_cast<int32_t>(values[index++]);
+    request.keyRef = static_cast<int32_t>(values[index++]);
+    request.keyPos = static_cast<int32_t>(values[index++]);
+    if (fields.back() == "-") {
+        return true;
+    }
+    for (const auto &data : Split(fields.back(), ';')) {
+        std::vector<std::pair<int32_t, int64_t>> records;
+        for (const auto &record : data.empty() ? std::vector<std::string>() : Split(data, ',')) {
+            size_t colon = record.find(':');
+            int64_t type = 0;
+            int64_t size = 0;
+            if (colon == std::string::npos || !ParseInt(record.substr(0, colon), type) ||
+                !ParseInt(record.substr(colon + 1), size)) {
+                return false;
+            }
+            records.emplace_back(static_cast<int32_t>(type), size);
+        }
+        request.datas.push_back(std::move(records));
+    }
+    return true;
+}
+
+Status RequestRecorder::Save(const std::string &path, const std::vector<RecordedRequest> &requests)
+{
+    std::string text = std::string(HEADER) + "\n";
+    for (const auto &request : requests) {
+        text += Format(request) + "\n";
+    }
+    int fd = open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        LOG_ERROR(UDMF_SERVICE, "Open recording failed, errno: %{public}d.", errno);
+        return E_ERROR;
+    }
+    bool result = WriteAll(fd, text) && fsync(fd) == 0;
+    close(fd);
+    if (!result) {
+        LOG_ERROR(UDMF_SERVICE, "Write recording failed, errno: %{public}d.", errno);
+        return E_ERROR;
+    }
+    return E_OK;
+}
+
+Status RequestRecorder::Load(const std::string &path, std::vector<RecordedRequest> &requests)
+{
+    std::ifstream file(path);
+    std::string line;
+    if (!file.is_open() || !std::getline(file, line) || line != HEADER) {
+        LOG_ERROR(UDMF_SERVICE, "Invalid recording header.");
+        return E_INVALID_PARAMETERS;
+    }
+    requests.clear();
+    while (std::getline(file, line)) {
+        if (line.empty() || line[0] == '#') {
+            continue;
+        }
+        RecordedRequest request;
+        if (!Parse(line, request)) {
+            LOG_ERROR(UDMF_SERVICE, "Invalid recording line: %{public}zu.", requests.size());
+            return E_INVALID_PARAMETERS;
+        }
+        requests.push_back(std::move(request));
+    }
+    return E_OK;
+}
+} // namespace UDMF
+} // namespace OHOS
@@ -0,0 +1,98 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_RECORDER_H
+#define UDMF_RECORDER_H
+
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "error_code.h"
+#include "unified_data.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * The shape of a request: its code, timing and result, and the type and size of each record it carried.
+ * Keys, bundle names and contents are left out; a queried key is kept as the request which returned it.
+ */
+struct RecordedRequest {
+    uint32_t code = 0;
+    // microseconds from the start of the recording to the request, and spent in the request
+    int64_t offset = 0;
+    int64_t duration = 0;
+    int32_t status = 0;
+    int32_t intention = UD_INTENTION_BUTT;
+    int32_t version = 0;
+    // index in the recording of the request which returned the key queried and the position of the key in its
+    // result, -1 for no key or a key returned before the recording started
+    int32_t keyRef = -1;
+    int32_t keyPos = 0;
+    // type and size of each record of each data carried
+    std::vector<std::vector<std::pair<int32_t, int64_t>>> datas;
+};
+
+/*
+ * Records the requests of the service to a file, one line per request. The handler of a request describes it on
+ * the thread of the request, between Begin and End.
+ */
+class RequestRecorder {
+public:
+    static RequestRecorder &GetInstance();
+
+    Status Start(const std::string &path);
+    void Stop();
+    bool IsRecording() const
+    {
+        return recording_.load(std::memory_order_relaxed);
+    }
+    void Begin(uint32_t code);
+    void SetIntention(int32_t intention);
+    void SetQuery(const std::string &key, int32_t version);
+    void AddData(UnifiedData &unifiedData);
+    void AddRecord(const std::shared_ptr<UnifiedRecord> &record);
+    void SetResult(const std::string &key);
+    void SetResult(const std::vector<std::string> &keys);
+    void End(int32_t status);
+
+    static Status Save(const std::string &path, const std::vector<RecordedRequest> &requests);
+    static Status Load(const std::string &path, std::vector<RecordedRequest> &requests);
+    static std::string Format(const RecordedRequest &request);
+    static bool Parse(const std::string &line, RecordedRequest &request);
+
+private:
+    static constexpr const char *HEADER = "# udmf requests 1";
+    // keys are forgotten past this count, so a long recording does not grow without bound
+    static constexpr size_t MAX_KEY_COUNT = 4096;
+
+    RequestRecorder() = default;
+
+    std::atomic<bool> recording_{ false };
+    std::mutex mutex_;
+    int fd_ = -1;
+    int64_t start_ = 0;
+    int32_t count_ = 0;
+    // request index and position of each key returned
+    std::map<std::string, std::pair<int32_t, int32_t>> keyRefs_;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_RECORDER_H
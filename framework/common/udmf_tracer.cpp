@@ -0,0 +1,144 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udmf_tracer.h"
+
+#include <chrono>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace OHOS {
+namespace UDMF {
+static thread_local uint64_t g_requestId = 0;
+
+Tracer &Tracer::GetInstance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::SetEnabled(bool enabled)
+{
+    enabled_.store(enabled, std::memory_order_relaxed);
+}
+
+uint64_t Tracer::NewRequestId()
+{
+    // the pid keeps the ids of different processes apart
+    uint64_t count = requestCount_.fetch_add(1, std::memory_order_relaxed) + 1;
+    return (static_cast<uint64_t>(getpid()) << 32) | count;
+}
+
+uint64_t Tracer::GetRequestId()
+{
+    return g_requestId;
+}
+
+void Tracer::SetRequestId(uint64_t requestId)
+{
+    g_requestId = requestId;
+}
+
+int64_t Tracer::Now()
+{
+    // the monotonic clock is shared by all processes, so the spans of the client and the service line up
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Tracer::Record(const char *name, uint64_t requestId, int64_t begin, int64_t duration)
+{
+    static thread_local int32_t tid = static_cast<int32_t>(syscall(SYS_gettid));
+    uint64_t ticket = head_.fetch_add(1, std::memory_order_relaxed);
+    Slot &slot = slots_[ticket % CAPACITY];
+    slot.sequence.store(ticket * 2 + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.name.store(name, std::memory_order_relaxed);
+    slot.requestId.store(requestId, std::memory_order_relaxed);
+    slot.begin.store(begin, std::memory_order_relaxed);
+    slot.duration.store(duration, std::memory_order_relaxed);
+    slot.tid.store(tid, std::memory_order_relaxed);
+    slot.sequence.store(ticket * 2 + 2, std::memory_order_release);
+}
+
+std::string Tracer::DumpEvents() const
+{
+    std::string events;
+    int32_t pid = getpid();
+    for (const auto &slot : slots_) {
+        uint64_t sequence = slot.sequence.load(std::memory_order_acquire);
+        if (sequence == 0 || sequence % 2 != 0) {
+            continue;
+        }
+        const char *name = slot.name.load(std::memory_order_relaxed);
+        uint64_t requestId = slot.requestId.load(std::memory_order_relaxed);
+        int64_t begin = slot.begin.load(std::memory_order_relaxed);
+        int64_t duration = slot.duration.load(std::memory_order_relaxed);
+        int32_t tid = slot.tid.load(std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_acquire);
+        // a slot rewritten while it was read is skipped
+        if (name == nullptr || slot.sequence.load(std::memory_order_relaxed) != sequence) {
+            continue;
+        }
+        if (!events.empty()) {
+            events += ",";
+        }
+        events += "{\"name\":\"" + std::string(name) + "\",\"cat\":\"udmf\",\"ph\":\"X\",\"ts\":" +
+            std::to_string(begin) + ",\"dur\":" + std::to_string(duration) + ",\"pid\":" + std::to_string(pid) +
+            ",\"tid\":" + std::to_string(tid) + ",\"args\":{\"requestId\":\"" + std::to_string(requestId) + "\"}}";
+    }
+    return events;
+}
+
+std::string Tracer::ToChromeTrace(const std::string &events)
+{
+    return "{\"traceEvents\":[" + events + "],\"displayTimeUnit\":\"ms\"}";
+}
+
+TraceSpan::TraceSpan(const char *name, bool root)
+{
+    if (!Tracer::GetInstance().IsEnabled()) {
+        return;
+    }
+    name_ = name;
+    if (root && Tracer::GetRequestId() == 0) {
+        Tracer::SetRequestId(Tracer::GetInstance().NewRequestId());
+        ownRequest_ = true;
+    }
+    begin_ = Tracer::Now();
+}
+
+TraceSpan::~TraceSpan()
+{
+    if (name_ == nullptr) {
+        return;
+    }
+    Tracer::GetInstance().Record(name_, Tracer::GetRequestId(), begin_, Tracer::Now() - begin_);
+    if (ownRequest_) {
+        Tracer::SetRequestId(0);
+    }
+}
+
+TraceRequest::TraceRequest(uint64_t requestId) : previous_(Tracer::GetRequestId())
+{
+    Tracer::SetRequestId(requestId);
+}
+
+TraceRequest::~TraceRequest()
+{
+    Tracer::SetRequestId(previous_);
+}
+} // namespace UDMF
+} // namespace OHOS
\ No newline at end of file
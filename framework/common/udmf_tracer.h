@@ -0,0 +1,100 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_TRACER_H
+#define UDMF_TRACER_H
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * Keeps the latest spans of the process in a ring buffer. A span belongs to the request id of its thread, which is
+ * carried in the parcels from the client to the service, so the spans of a request can be followed across processes.
+ */
+class Tracer {
+public:
+    static Tracer &GetInstance();
+
+    void SetEnabled(bool enabled);
+    bool IsEnabled() const
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+    uint64_t NewRequestId();
+    static uint64_t GetRequestId();
+    static void SetRequestId(uint64_t requestId);
+    // name is a string literal, only the pointer is kept
+    void Record(const char *name, uint64_t requestId, int64_t begin, int64_t duration);
+    // the spans in the ring buffer as the events of the chrome trace format, separated by commas
+    std::string DumpEvents() const;
+    static std::string ToChromeTrace(const std::string &events);
+    static int64_t Now();
+
+private:
+    static constexpr uint32_t CAPACITY = 1024;
+    struct Slot {
+        // odd while the slot is written, the ticket of the span after that
+        std::atomic<uint64_t> sequence{ 0 };
+        std::atomic<const char *> name{ nullptr };
+        std::atomic<uint64_t> requestId{ 0 };
+        std::atomic<int64_t> begin{ 0 };
+        std::atomic<int64_t> duration{ 0 };
+        std::atomic<int32_t> tid{ 0 };
+    };
+
+    Tracer() = default;
+
+    std::atomic<bool> enabled_{ false };
+    std::atomic<uint64_t> head_{ 0 };
+    std::atomic<uint32_t> requestCount_{ 0 };
+    Slot slots_[CAPACITY];
+};
+
+/*
+ * Records the time from its construction to its destruction. A root span starts a request on a thread without one.
+ */
+class TraceSpan {
+public:
+    explicit TraceSpan(const char *name, bool root = false);
+    ~TraceSpan();
+
+private:
+    const char *name_ = nullptr;
+    int64_t begin_ = 0;
+    bool ownRequest_ = false;
+};
+
+/*
+ * Sets the request id of the thread for a scope, such as the request id read from a parcel.
+ */
+class TraceRequest {
+public:
+    explicit TraceRequest(uint64_t requestId);
+    ~TraceRequest();
+
+private:
+    uint64_t previous_ = 0;
+};
+
+#define UDMF_TRACE_CONCAT_INNER(a, b) a##b
+#define UDMF_TRACE_CONCAT(a, b) UDMF_TRACE_CONCAT_INNER(a, b)
+#define UDMF_TRACE_SPAN(name) OHOS::UDMF::TraceSpan UDMF_TRACE_CONCAT(udmfTraceSpan, __LINE__)(name)
+#define UDMF_TRACE_REQUEST(name) OHOS::UDMF::TraceSpan UDMF_TRACE_CONCAT(udmfTraceSpan, __LINE__)(name, true)
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_TRACER_H
\ No newline at end of file
@@ -254,6 +254,12 @@ template<> bool Marshalling(const UnifiedData &input, MessageParcel &parcel)
 
 template<> bool Unmarshalling(UnifiedData &output, MessageParcel &parcel)
 {
+    // the vector reader allocates all the records it is told of, so the count is checked before
+    size_t position = parcel.GetReadPosition();
+    int32_t count = parcel.ReadInt32();
+    if (count < 0 || static_cast<uint32_t>(count) > UnifiedData::MAX_RECORD_NUM || !parcel.RewindRead(position)) {
+        return false;
+    }
     std::vector<std::shared_ptr<UnifiedRecord>> records;
     if (!ITypesUtil::Unmarshal(parcel, records)) {
         return false;
@@ -272,6 +278,36 @@ template<> bool Unmarshalling(Summary &output, MessageParcel &parcel)
     return ITypesUtil::Unmarshal(parcel, output.summary, output.totalSize);
 }
 
+template<> bool Marshalling(const Preview &input, MessageParcel &parcel)
+{
+    return ITypesUtil::Marshal(parcel, input.width, input.height, input.pixels);
+}
+
+template<> bool Unmarshalling(Preview &output, MessageParcel &parcel)
+{
+    return ITypesUtil::Unmarshal(parcel, output.width, output.height, output.pixels);
+}
+
+template<> bool Marshalling(const FolderEntry &input, MessageParcel &parcel)
+{
+    return ITypesUtil::Marshal(parcel, input.name, input.type, input.size, input.uri);
+}
+
+template<> bool Unmarshalling(FolderEntry &output, MessageParcel &parcel)
+{
+    return ITypesUtil::Unmarshal(parcel, output.name, output.type, output.size, output.uri);
+}
+
+template<> bool Marshalling(const FolderBatch &input, MessageParcel &parcel)
+{
+    return ITypesUtil::Marshal(parcel, input.entries, input.cursor);
+}
+
+template<> bool Unmarshalling(FolderBatch &output, MessageParcel &parcel)
+{
+    return ITypesUtil::Unmarshal(parcel, output.entries, output.cursor);
+}
+
 template<> bool Marshalling(const Privilege &input, MessageParcel &parcel)
 {
     return ITypesUtil::Marshal(parcel, input.tokenId, input.pid, input.readPermission, input.writePermission);
@@ -294,12 +330,79 @@ template<> bool Unmarshalling(CustomOption &output, MessageParcel &parcel)
 
 template<> bool Marshalling(const QueryOption &input, MessageParcel &parcel)
 {
-    return ITypesUtil::Marshal(parcel, input.key);
+    int32_t validatorType = input.validatorType;
+    return ITypesUtil::Marshal(parcel, input.key, input.version, input.validator, validatorType, input.encodings);
 }
 
 template<> bool Unmarshalling(QueryOption &output, MessageParcel &parcel)
 {
-    return ITypesUtil::Unmarshal(parcel, output.key);
+    int32_t validatorType;
+    if (!ITypesUtil::Unmarshal(parcel, output.key, output.version, output.validator, validatorType,
+        output.encodings)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Unmarshal QueryOption failed!");
+        return false;
+    }
+    if (validatorType < VERSION_VALIDATOR || validatorType >= VALIDATOR_BUTT) {
+        LOG_ERROR(UDMF_FRAMEWORK, "invalid ValidatorType!");
+        return false;
+    }
+    output.validatorType = static_cast<ValidatorType>(validatorType);
+    return true;
+}
+
+template<> bool Marshalling(const QueryCondition &input, MessageParcel &parcel)
+{
+    int32_t type = input.type;
+    return ITypesUtil::Marshal(parcel, input.intention, input.bundleName, type,
+        static_cast<int64_t>(input.beginTime), static_cast<int64_t>(input.endTime), input.cursor, input.pageSize);
+}
+
+template<> bool Unmarshalling(QueryCondition &output, MessageParcel &parcel)
+{
+    int32_t type;
+    int64_t beginTime;
+    int64_t endTime;
+    if (!ITypesUtil::Unmarshal(parcel, output.intention, output.bundleName, type, beginTime, endTime,
+        output.cursor, output.pageSize)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Unmarshal QueryCondition failed!");
+        return false;
+    }
+    if (type < UDType::TEXT || type > UDType::UD_BUTT) {
+        LOG_ERROR(UDMF_FRAMEWORK, "invalid UDType!");
+        return false;
+    }
+    output.type = static_cast<UDType>(type);
+    output.beginTime = beginTime;
+    output.endTime = endTime;
+    return true;
+}
+
+template<> bool Marshalling(const SubscribeOption &input, MessageParcel &parcel)
+{
+    return ITypesUtil::Marshal(parcel, input.intention, input.types);
+}
+
+template<> bool Unmarshalling(SubscribeOption &output, MessageParcel &parcel)
+{
+    if (!ITypesUtil::Unmarshal(parcel, output.intention, output.types)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Unmarshal SubscribeOption failed!");
+        return false;
+    }
+    return true;
+}
+
+template<> bool Marshalling(const ChangeNotice &input, MessageParcel &parcel)
+{
+    return ITypesUtil::Marshal(parcel, input.key, input.summary);
+}
+
+template<> bool Unmarshalling(ChangeNotice &output, MessageParcel &parcel)
+{
+    if (!ITypesUtil::Unmarshal(parcel, output.key, output.summary)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Unmarshal ChangeNotice failed!");
+        return false;
+    }
+    return true;
 }
 
 template<> bool Marshalling(const Text &input, MessageParcel &parcel)
@@ -532,18 +635,21 @@ template<> bool Unmarshalling(SystemDefinedAppItem &output, MessageParcel &parce
 
 template<> bool Marshalling(const SystemDefinedPixelMap &input, MessageParcel &parcel)
 {
-    return ITypesUtil::Marshal(parcel, input.GetRawData(), input.GetDetails());
+    return ITypesUtil::Marshal(parcel, input.GetEncoding(), input.GetEncodedData(), input.GetDetails());
 }
 
 template<> bool Unmarshalling(SystemDefinedPixelMap &output, MessageParcel &parcel)
 {
+    int32_t encoding = PIXEL_ENCODING_RAW;
     std::vector<uint8_t> rawData;
     UDDetails details;
-    if (!ITypesUtil::Unmarshal(parcel, rawData, details)) {
+    if (!ITypesUtil::Unmarshal(parcel, encoding, rawData, details)) {
         LOG_ERROR(UDMF_FRAMEWORK, "Unmarshal UDPixelMap failed!");
         return false;
     }
-    output.SetRawData(rawData);
+    if (!output.SetEncodedData(std::move(rawData), encoding)) {
+        return false;
+    }
     output.SetDetails(details);
     return true;
 }
@@ -562,7 +668,7 @@ template<> bool Unmarshalling(ApplicationDefinedRecord &output, MessageParcel &p
         return false;
     }
     output.SetApplicationDefinedType(type);
-    output.SetRawData(rawData);
+    output.SetRawData(std::move(rawData));
     return true;
 }
 
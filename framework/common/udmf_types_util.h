@@ -41,9 +41,15 @@ namespace ITypesUtil {
 using UnifiedRecord = UDMF::UnifiedRecord;
 using UnifiedData = UDMF::UnifiedData;
 using Summary = UDMF::Summary;
+using Preview = UDMF::Preview;
+using FolderEntry = UDMF::FolderEntry;
+using FolderBatch = UDMF::FolderBatch;
 using Privilege = UDMF::Privilege;
 using CustomOption = UDMF::CustomOption;
 using QueryOption = UDMF::QueryOption;
+using QueryCondition = UDMF::QueryCondition;
+using SubscribeOption = UDMF::SubscribeOption;
+using ChangeNotice = UDMF::ChangeNotice;
 using Text = UDMF::Text;
 using PlainText = UDMF::PlainText;
 using Html = UDMF::Html;
@@ -69,6 +75,15 @@ template<> bool Unmarshalling(UnifiedData &output, MessageParcel &parcel);
 template<> bool Marshalling(const Summary &input, MessageParcel &parcel);
 template<> bool Unmarshalling(Summary &output, MessageParcel &parcel);
 
+template<> bool Marshalling(const Preview &input, MessageParcel &parcel);
+template<> bool Unmarshalling(Preview &output, MessageParcel &parcel);
+
+template<> bool Marshalling(const FolderEntry &input, MessageParcel &parcel);
+template<> bool Unmarshalling(FolderEntry &output, MessageParcel &parcel);
+
+template<> bool Marshalling(const FolderBatch &input, MessageParcel &parcel);
+template<> bool Unmarshalling(FolderBatch &output, MessageParcel &parcel);
+
 template<> bool Marshalling(const Privilege &input, MessageParcel &parcel);
 template<> bool Unmarshalling(Privilege &output, MessageParcel &parcel);
 
@@ -78,6 +93,15 @@ template<> bool Unmarshalling(CustomOption &output, MessageParcel &parcel);
 template<> bool Marshalling(const QueryOption &input, MessageParcel &parcel);
 template<> bool Unmarshalling(QueryOption &output, MessageParcel &parcel);
 
+template<> bool Marshalling(const QueryCondition &input, MessageParcel &parcel);
+template<> bool Unmarshalling(QueryCondition &output, MessageParcel &parcel);
+
+template<> bool Marshalling(const SubscribeOption &input, MessageParcel &parcel);
+template<> bool Unmarshalling(SubscribeOption &output, MessageParcel &parcel);
+
+template<> bool Marshalling(const ChangeNotice &input, MessageParcel &parcel);
+template<> bool Unmarshalling(ChangeNotice &output, MessageParcel &parcel);
+
 template<> bool Marshalling(const Text &input, MessageParcel &parcel);
 template<> bool Unmarshalling(Text &output, MessageParcel &parcel);
 
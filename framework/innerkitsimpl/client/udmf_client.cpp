@@ -15,12 +15,62 @@
 
 #include "udmf_client.h"
 
+#include <optional>
+#include <type_traits>
+
 #include "error_code.h"
 #include "logger.h"
+#include "pixel_codec.h"
+#include "system_defined_pixelmap.h"
+#include "udmf_observer_stub.h"
+#include "udmf_memory.h"
 #include "udmf_service_client.h"
+#include "udmf_tracer.h"
+#include "udmf_types_util.h"
 
 namespace OHOS {
 namespace UDMF {
+class ObserverBridge : public UdmfObserverStub {
+public:
+    explicit ObserverBridge(std::shared_ptr<DataObserver> observer) : observer_(observer)
+    {
+    }
+
+    void OnChange(const std::vector<ChangeNotice> &notices) override
+    {
+        observer_->OnChange(notices);
+    }
+
+private:
+    std::shared_ptr<DataObserver> observer_;
+};
+
+// pixel maps are sent encoded, and the service stores and hands them out without decoding them; an encoded copy
+// of a pixel map is sent, so the records of the caller are left as they are
+static std::shared_ptr<UnifiedRecord> EncodePixelMap(const std::shared_ptr<UnifiedRecord> &record)
+{
+    if (record == nullptr || record->GetType() != SYSTEM_DEFINED_PIXEL_MAP) {
+        return record;
+    }
+    auto pixelMap = static_cast<SystemDefinedPixelMap *>(record.get());
+    if (pixelMap->GetEncoding() != PIXEL_ENCODING_RAW) {
+        return record;
+    }
+    auto encoded = std::make_shared<SystemDefinedPixelMap>(*pixelMap);
+    return encoded->Encode(PIXEL_ENCODING_QOI) ? encoded : record;
+}
+
+static UnifiedData EncodePixelMaps(const UnifiedData &unifiedData)
+{
+    UnifiedData encoded = unifiedData;
+    auto records = unifiedData.GetRecords();
+    for (auto &record : records) {
+        record = EncodePixelMap(record);
+    }
+    encoded.SetRecords(std::move(records));
+    return encoded;
+}
+
 UdmfClient &UdmfClient::GetInstance()
 {
     static auto instance_ = new UdmfClient();
@@ -30,45 +80,252 @@ UdmfClient &UdmfClient::GetInstance()
 Status UdmfClient::SetData(CustomOption &option, UnifiedData &unifiedData, std::string &key)
 {
     LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.SetData");
     auto service = UdmfServiceClient::GetInstance();
     if (service == nullptr) {
         LOG_ERROR(UDMF_CLIENT, "Service unavailable");
         return E_ERROR;
     }
 
-    int32_t ret = service->SetData(option, unifiedData, key);
+    UnifiedData encoded = EncodePixelMaps(unifiedData);
+    int32_t ret = service->SetData(option, encoded, key);
     return static_cast<Status>(ret);
 }
 
-Status UdmfClient::GetData(QueryOption &query, UnifiedData &unifiedData)
+Status UdmfClient::SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+    std::vector<std::string> &keys)
 {
     LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.SetBatchData");
     auto service = UdmfServiceClient::GetInstance();
     if (service == nullptr) {
         LOG_ERROR(UDMF_CLIENT, "Service unavailable");
         return E_ERROR;
     }
 
-    int32_t ret = service->GetData(query, unifiedData);
+    std::vector<UnifiedData> encoded;
+    encoded.reserve(unifiedDatas.size());
+    for (const auto &unifiedData : unifiedDatas) {
+        encoded.push_back(EncodePixelMaps(unifiedData));
+    }
+    int32_t ret = service->SetBatchData(option, encoded, keys);
     return static_cast<Status>(ret);
 }
 
+Status UdmfClient::AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.AppendRecord");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    auto encoded = EncodePixelMap(record);
+    int32_t ret = service->AppendRecord(query, encoded);
+    // the uid given to the record sent is the one of the record of the caller
+    if (encoded != record) {
+        record->SetUid(encoded->GetUid());
+    }
+    return static_cast<Status>(ret);
+}
+
+Status UdmfClient::ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.ReplaceRecord");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    int32_t ret = service->ReplaceRecord(query, EncodePixelMap(record));
+    return static_cast<Status>(ret);
+}
+
+// a cached data marshalled takes less than this
+static constexpr size_t MAX_COPY_CAPACITY = 1024 * 1024;
+
+// the records of a data are shared pointers, so a data is copied through a parcel into and out of the cache, and
+// no caller sees the records of another
+template<typename T>
+static bool CopyResult(const T &source, T &target)
+{
+    if constexpr (std::is_same_v<T, UnifiedData>) {
+        MessageParcel parcel;
+        parcel.SetMaxCapacity(MAX_COPY_CAPACITY);
+        return ITypesUtil::Marshal(parcel, source) && ITypesUtil::Unmarshal(parcel, target);
+    } else {
+        target = source;
+        return true;
+    }
+}
+
+template<typename T, typename Fetch>
+Status UdmfClient::GetCached(QueryOption &query, Cache<T> &cache, T &result, Fetch fetch)
+{
+    std::string cacheKey = query.key + "#" + std::to_string(query.version) + "#" + std::to_string(query.validatorType);
+    {
+        std::lock_guard<std::mutex> lock(cacheMutex_);
+        auto it = cache.entries.find(cacheKey);
+        if (it != cache.entries.end()) {
+            query.validator = it->second.validator;
+        }
+    }
+    int32_t ret = fetch(query, result);
+    if (ret == E_NOT_MODIFIED) {
+        // the records of the cache are never modified, so they are copied for the caller out of the lock
+        std::optional<T> cached;
+        {
+            std::lock_guard<std::mutex> lock(cacheMutex_);
+            auto it = cache.entries.find(cacheKey);
+            if (it != cache.entries.end() && it->second.validator == query.validator) {
+                cached = it->second.result;
+                cache.recency.splice(cache.recency.begin(), cache.recency, it->second.recency);
+            }
+        }
+        if (cached.has_value() && CopyResult(*cached, result)) {
+            return E_OK;
+        }
+    }
+    if (ret == E_NOT_MODIFIED) {
+        // the entry is replaced or evicted by another caller meanwhile, so the result is fetched again
+        query.validator.clear();
+        ret = fetch(query, result);
+    }
+
+    CacheEntry<T> entry;
+    bool cacheable = ret == E_OK && !query.validator.empty();
+    if constexpr (std::is_same_v<T, UnifiedData>) {
+        cacheable = cacheable && result.GetSize() <= static_cast<int64_t>(MAX_CACHED_DATA_SIZE);
+    }
+    cacheable = cacheable && CopyResult(result, entry.result);
+
+    std::lock_guard<std::mutex> lock(cacheMutex_);
+    auto erase = [&cache](typename std::map<std::string, CacheEntry<T>>::iterator it) {
+        MemoryAccount::GetInstance().Release(MEMORY_CACHE, it->second.size);
+        cache.recency.erase(it->second.recency);
+        cache.entries.erase(it);
+    };
+    // the entry of the key is dropped, and put back below if the result is cacheable
+    auto it = cache.entries.find(cacheKey);
+    if (it != cache.entries.end()) {
+        erase(it);
+    }
+    if (!cacheable) {
+        return static_cast<Status>(ret);
+    }
+    int64_t size = static_cast<int64_t>(cacheKey.size() + query.validator.size());
+    if constexpr (std::is_same_v<T, UnifiedData>) {
+        size += result.GetSize();
+    } else if constexpr (std::is_same_v<T, Preview>) {
+        size += static_cast<int64_t>(result.pixels.size());
+    } else {
+        for (const auto &item : result.summary) {
+            size += static_cast<int64_t>(item.first.size() + sizeof(item.second));
+        }
+    }
+    entry.validator = query.validator;
+    entry.size = size;
+    if (cache.entries.size() >= MAX_CACHE_COUNT) {
+        erase(cache.entries.find(cache.recency.back()));
+    }
+    entry.recency = cache.recency.insert(cache.recency.begin(), cacheKey);
+    cache.entries.emplace(cacheKey, std::move(entry));
+    MemoryAccount::GetInstance().Add(MEMORY_CACHE, size);
+    return E_OK;
+}
+
+Status UdmfClient::GetData(QueryOption &query, UnifiedData &unifiedData)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.GetData");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+
+    query.encodings = PixelCodec::DECODABLE;
+    if (!query.validator.empty()) {
+        int32_t ret = service->GetData(query, unifiedData);
+        return static_cast<Status>(ret);
+    }
+    return GetCached(query, dataCache_, unifiedData, [&service](QueryOption &option, UnifiedData &result) {
+        return service->GetData(option, result);
+    });
+}
+
 Status UdmfClient::GetSummary(QueryOption &query, Summary &summary)
 {
     LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.GetSummary");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+
+    if (!query.validator.empty()) {
+        int32_t ret = service->GetSummary(query, summary);
+        return static_cast<Status>(ret);
+    }
+    return GetCached(query, summaryCache_, summary, [&service](QueryOption &option, Summary &result) {
+        return service->GetSummary(option, result);
+    });
+}
+
+Status UdmfClient::GetPreview(QueryOption &query, Preview &preview)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.GetPreview");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+
+    if (!query.validator.empty()) {
+        int32_t ret = service->GetPreview(query, preview);
+        return static_cast<Status>(ret);
+    }
+    return GetCached(query, previewCache_, preview, [&service](QueryOption &option, Preview &result) {
+        return service->GetPreview(option, result);
+    });
+}
+
+Status UdmfClient::EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor,
+    uint32_t count, FolderBatch &batch)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.EnumerateFolder");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    int32_t ret = service->EnumerateFolder(query, uri, cursor, count, batch);
+    return static_cast<Status>(ret);
+}
+
+Status UdmfClient::QueryKeys(QueryCondition &condition, std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.QueryKeys");
     auto service = UdmfServiceClient::GetInstance();
     if (service == nullptr) {
         LOG_ERROR(UDMF_CLIENT, "Service unavailable");
         return E_ERROR;
     }
 
-    int32_t ret = service->GetSummary(query, summary);
+    int32_t ret = service->QueryKeys(condition, keys);
     return static_cast<Status>(ret);
 }
 
 Status UdmfClient::AddPrivilege(QueryOption &query, Privilege &privilege)
 {
     LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.AddPrivilege");
     auto service = UdmfServiceClient::GetInstance();
     if (service == nullptr) {
         LOG_ERROR(UDMF_CLIENT, "Service unavailable");
@@ -82,6 +339,7 @@ Status UdmfClient::AddPrivilege(QueryOption &query, Privilege &privilege)
 Status UdmfClient::Sync(const QueryOption &query, const std::vector<std::string> &devices)
 {
     LOG_INFO(UDMF_CLIENT, "start.");
+    UDMF_TRACE_REQUEST("client.Sync");
     auto service = UdmfServiceClient::GetInstance();
     if (service == nullptr) {
         LOG_ERROR(UDMF_CLIENT, "Service unavailable");
@@ -91,5 +349,118 @@ Status UdmfClient::Sync(const QueryOption &query, const std::vector<std::string>
     int32_t ret = service->Sync(query, devices);
     return static_cast<Status>(ret);
 }
+
+Status UdmfClient::SetTraceEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    int32_t ret = service->SetTraceEnabled(enabled);
+    if (ret == E_OK) {
+        Tracer::GetInstance().SetEnabled(enabled);
+    }
+    return static_cast<Status>(ret);
+}
+
+Status UdmfClient::DumpTrace(std::string &trace)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    std::string events;
+    int32_t ret = service->DumpTrace(events);
+    if (ret != E_OK) {
+        return static_cast<Status>(ret);
+    }
+    std::string localEvents = Tracer::GetInstance().DumpEvents();
+    if (!localEvents.empty() && !events.empty()) {
+        events += ",";
+    }
+    trace = Tracer::ToChromeTrace(events + localEvents);
+    return E_OK;
+}
+
+Status UdmfClient::DumpStats(std::string &stats)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    std::string serviceStats;
+    int32_t ret = service->DumpStats(serviceStats);
+    if (ret != E_OK) {
+        return static_cast<Status>(ret);
+    }
+    stats = "service " + serviceStats + "client memory:\n" + MemoryAccount::GetInstance().Dump();
+    return E_OK;
+}
+
+Status UdmfClient::SetRecordEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+    int32_t ret = service->SetRecordEnabled(enabled);
+    return static_cast<Status>(ret);
+}
+
+Status UdmfClient::Subscribe(const SubscribeOption &option, std::shared_ptr<DataObserver> observer)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    if (observer == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Invalid observer");
+        return E_INVALID_PARAMETERS;
+    }
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (observers_.find(observer) != observers_.end()) {
+        LOG_ERROR(UDMF_CLIENT, "Observer is subscribed already");
+        return E_INVALID_OPERATION;
+    }
+    sptr<ObserverBridge> bridge = new (std::nothrow) ObserverBridge(observer);
+    if (bridge == nullptr) {
+        return E_ERROR;
+    }
+    int32_t ret = service->Subscribe(option, bridge->AsObject());
+    if (ret == E_OK) {
+        observers_[observer] = bridge->AsObject();
+    }
+    return static_cast<Status>(ret);
+}
+
+Status UdmfClient::Unsubscribe(std::shared_ptr<DataObserver> observer)
+{
+    LOG_INFO(UDMF_CLIENT, "start.");
+    auto service = UdmfServiceClient::GetInstance();
+    if (service == nullptr) {
+        LOG_ERROR(UDMF_CLIENT, "Service unavailable");
+        return E_ERROR;
+    }
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = observers_.find(observer);
+    if (it == observers_.end()) {
+        return E_INVALID_PARAMETERS;
+    }
+    int32_t ret = service->Unsubscribe(it->second);
+    observers_.erase(it);
+    return static_cast<Status>(ret);
+}
 } // namespace UDMF
 } // namespace OHOS
\ No newline at end of file
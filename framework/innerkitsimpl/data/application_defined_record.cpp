@@ -59,5 +59,10 @@ void ApplicationDefinedRecord::SetRawData(const std::vector<uint8_t> &rawData)
 {
     this->rawData_ = rawData;
 }
+
+void ApplicationDefinedRecord::SetRawData(std::vector<uint8_t> &&rawData)
+{
+    this->rawData_ = std::move(rawData);
+}
 } // namespace UDMF
 } // namespace OHOS
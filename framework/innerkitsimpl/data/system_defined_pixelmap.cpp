@@ -15,6 +15,9 @@
 
 #include "system_defined_pixelmap.h"
 
+#include "logger.h"
+#include "pixel_codec.h"
+
 namespace OHOS {
 namespace UDMF {
 SystemDefinedPixelMap::SystemDefinedPixelMap()
@@ -30,17 +33,78 @@ SystemDefinedPixelMap::SystemDefinedPixelMap(std::vector<uint8_t> &data)
 
 int64_t SystemDefinedPixelMap::GetSize()
 {
-    return UnifiedDataUtils::GetDetailsSize(this->details_) + rawData_.size();
+    size_t size = encoding_ == PIXEL_ENCODING_RAW ? rawData_.size() : PixelCodec::GetDecodedSize(rawData_);
+    return UnifiedDataUtils::GetDetailsSize(this->details_) + static_cast<int64_t>(size);
 }
 
 std::vector<uint8_t> SystemDefinedPixelMap::GetRawData() const
 {
-    return this->rawData_;
+    if (encoding_ == PIXEL_ENCODING_RAW) {
+        return this->rawData_;
+    }
+    std::vector<uint8_t> rawData;
+    if (!PixelCodec::Decode(rawData_, rawData)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Decode pixel map failed, encoding: %{public}d.", encoding_);
+    }
+    return rawData;
 }
 
 void SystemDefinedPixelMap::SetRawData(const std::vector<uint8_t> &rawData)
 {
     this->rawData_ = rawData;
+    this->encoding_ = PIXEL_ENCODING_RAW;
+}
+
+void SystemDefinedPixelMap::SetRawData(std::vector<uint8_t> &&rawData)
+{
+    this->rawData_ = std::move(rawData);
+    this->encoding_ = PIXEL_ENCODING_RAW;
+}
+
+int32_t SystemDefinedPixelMap::GetEncoding() const
+{
+    return encoding_;
+}
+
+const std::vector<uint8_t> &SystemDefinedPixelMap::GetEncodedData() const
+{
+    return rawData_;
+}
+
+bool SystemDefinedPixelMap::SetEncodedData(std::vector<uint8_t> data, int32_t encoding)
+{
+    if (encoding < PIXEL_ENCODING_RAW || encoding >= PIXEL_ENCODING_BUTT) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid pixel map encoding: %{public}d.", encoding);
+        return false;
+    }
+    // the size of the pixel map is taken from the header, which is refused if forged
+    if (encoding != PIXEL_ENCODING_RAW && !PixelCodec::IsValidHeader(data)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid pixel map header, size: %{public}zu.", data.size());
+        return false;
+    }
+    this->rawData_ = std::move(data);
+    this->encoding_ = encoding;
+    return true;
+}
+
+bool SystemDefinedPixelMap::Encode(int32_t encoding)
+{
+    if (encoding == encoding_) {
+        return true;
+    }
+    if (encoding == PIXEL_ENCODING_RAW) {
+        std::vector<uint8_t> rawData;
+        if (!PixelCodec::Decode(rawData_, rawData)) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Decode pixel map failed, encoding: %{public}d.", encoding_);
+            return false;
+        }
+        return SetEncodedData(std::move(rawData), PIXEL_ENCODING_RAW);
+    }
+    std::vector<uint8_t> encoded;
+    if (encoding != PIXEL_ENCODING_QOI || encoding_ != PIXEL_ENCODING_RAW || !PixelCodec::Encode(rawData_, encoded)) {
+        return false;
+    }
+    return SetEncodedData(std::move(encoded), encoding);
 }
 } // namespace UDMF
 } // namespace OHOS
\ No newline at end of file
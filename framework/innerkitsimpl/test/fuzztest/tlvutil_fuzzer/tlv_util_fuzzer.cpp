@@ -0,0 +1,123 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "tlv_util_fuzzer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "system_defined_pixelmap.h"
+#include "tlv_util.h"
+
+using namespace OHOS;
+using namespace OHOS::UDMF;
+
+namespace OHOS {
+// an input decoding slower or into more than this is a pathology of the decoder, not a crash but still reported
+static constexpr auto TIME_BUDGET = std::chrono::milliseconds(100);
+static constexpr size_t ALLOCATION_RATIO = 4;
+
+void CheckBudget(std::chrono::steady_clock::time_point begin, size_t size, size_t decoded)
+{
+    if (std::chrono::steady_clock::now() - begin > TIME_BUDGET || decoded > size * ALLOCATION_RATIO) {
+        abort();
+    }
+}
+
+size_t SizeOf(const UDDetails &details)
+{
+    size_t size = 0;
+    for (const auto &[key, value] : details) {
+        size += key.size();
+        if (auto str = std::get_if<std::string>(&value); str != nullptr) {
+            size += str->size();
+        } else if (auto vec = std::get_if<std::vector<uint8_t>>(&value); vec != nullptr) {
+            size += vec->size();
+        }
+    }
+    return size;
+}
+
+void ReadingRecordFuzz(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> buffer(data, data + size);
+    auto tlv = TLVObject(buffer);
+    std::shared_ptr<UnifiedRecord> record;
+    auto begin = std::chrono::steady_clock::now();
+    if (!TLVUtil::Reading(record, tlv) || record == nullptr) {
+        CheckBudget(begin, size, 0);
+        return;
+    }
+    size_t decoded = record->GetUid().size() + static_cast<size_t>(std::max<int64_t>(record->GetSize(), 0));
+    if (record->GetType() == SYSTEM_DEFINED_PIXEL_MAP) {
+        // the size of a pixel map is the one of its raw data, while only the encoded data is held
+        auto pixelMap = static_cast<SystemDefinedPixelMap *>(record.get());
+        decoded = record->GetUid().size() + pixelMap->GetEncodedData().size() + SizeOf(pixelMap->GetDetails());
+    }
+    CheckBudget(begin, size, decoded);
+}
+
+void ReadingDetailsFuzz(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> buffer(data, data + size);
+    auto tlv = TLVObject(buffer);
+    UDDetails details;
+    auto begin = std::chrono::steady_clock::now();
+    TLVUtil::Reading(details, tlv);
+    CheckBudget(begin, size, SizeOf(details));
+}
+
+void ReadingRuntimeFuzz(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> buffer(data, data + size);
+    auto tlv = TLVObject(buffer);
+    Runtime runtime;
+    auto begin = std::chrono::steady_clock::now();
+    TLVUtil::Reading(runtime, tlv);
+    size_t decoded = runtime.key.key.size() + runtime.key.intention.size() + runtime.key.bundleName.size() +
+        runtime.key.groupId.size() + runtime.sourcePackage.size() + runtime.createPackage.size() +
+        runtime.deviceId.size();
+    for (const auto &privilege : runtime.privileges) {
+        decoded += privilege.readPermission.size() + privilege.writePermission.size();
+    }
+    CheckBudget(begin, size, decoded);
+}
+
+void ReadingSummaryFuzz(const uint8_t *data, size_t size)
+{
+    std::vector<uint8_t> buffer(data, data + size);
+    auto tlv = TLVObject(buffer);
+    Summary summary;
+    auto begin = std::chrono::steady_clock::now();
+    TLVUtil::Reading(summary, tlv);
+    size_t decoded = 0;
+    for (const auto &item : summary.summary) {
+        decoded += item.first.size();
+    }
+    CheckBudget(begin, size, decoded);
+}
+}
+
+/* Fuzzer entry point */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    /* Run your code on data */
+    OHOS::ReadingRecordFuzz(data, size);
+    OHOS::ReadingDetailsFuzz(data, size);
+    OHOS::ReadingRuntimeFuzz(data, size);
+    OHOS::ReadingSummaryFuzz(data, size);
+    return 0;
+}
@@ -0,0 +1,106 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "types_util_fuzzer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+#include "message_parcel.h"
+#include "udmf_types_util.h"
+
+using namespace OHOS;
+using namespace OHOS::UDMF;
+
+namespace OHOS {
+// an input decoding slower or into more than this is a pathology of the decoder, not a crash but still reported
+static constexpr auto TIME_BUDGET = std::chrono::milliseconds(100);
+static constexpr size_t ALLOCATION_RATIO = 4;
+
+void CheckBudget(std::chrono::steady_clock::time_point begin, size_t size, size_t decoded)
+{
+    if (std::chrono::steady_clock::now() - begin > TIME_BUDGET || decoded > size * ALLOCATION_RATIO) {
+        abort();
+    }
+}
+
+size_t SizeOf(const std::shared_ptr<UnifiedRecord> &record)
+{
+    if (record == nullptr) {
+        return 0;
+    }
+    return record->GetUid().size() + static_cast<size_t>(std::max<int64_t>(record->GetSize(), 0));
+}
+
+void UnmarshalRecordFuzz(const uint8_t *data, size_t size)
+{
+    MessageParcel parcel;
+    parcel.WriteBuffer(data, size);
+    std::shared_ptr<UnifiedRecord> record;
+    auto begin = std::chrono::steady_clock::now();
+    ITypesUtil::Unmarshal(parcel, record);
+    CheckBudget(begin, size, SizeOf(record));
+}
+
+void UnmarshalDataFuzz(const uint8_t *data, size_t size)
+{
+    MessageParcel parcel;
+    parcel.WriteBuffer(data, size);
+    UnifiedData unifiedData;
+    auto begin = std::chrono::steady_clock::now();
+    ITypesUtil::Unmarshal(parcel, unifiedData);
+    size_t decoded = 0;
+    for (const auto &record : unifiedData.GetRecords()) {
+        decoded += SizeOf(record);
+    }
+    CheckBudget(begin, size, decoded);
+}
+
+void UnmarshalSummaryFuzz(const uint8_t *data, size_t size)
+{
+    MessageParcel parcel;
+    parcel.WriteBuffer(data, size);
+    Summary summary;
+    auto begin = std::chrono::steady_clock::now();
+    ITypesUtil::Unmarshal(parcel, summary);
+    size_t decoded = 0;
+    for (const auto &item : summary.summary) {
+        decoded += item.first.size();
+    }
+    CheckBudget(begin, size, decoded);
+}
+
+void UnmarshalQueryFuzz(const uint8_t *data, size_t size)
+{
+    MessageParcel parcel;
+    parcel.WriteBuffer(data, size);
+    QueryOption query;
+    auto begin = std::chrono::steady_clock::now();
+    ITypesUtil::Unmarshal(parcel, query);
+    CheckBudget(begin, size, query.key.size() + query.validator.size());
+}
+}
+
+/* Fuzzer entry point */
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t *data, size_t size)
+{
+    /* Run your code on data */
+    OHOS::UnmarshalRecordFuzz(data, size);
+    OHOS::UnmarshalDataFuzz(data, size);
+    OHOS::UnmarshalSummaryFuzz(data, size);
+    OHOS::UnmarshalQueryFuzz(data, size);
+    return 0;
+}
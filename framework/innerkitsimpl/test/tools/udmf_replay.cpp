@@ -0,0 +1,414 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <map>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "accesstoken_kit.h"
+#include "application_defined_record.h"
+#include "data_manager.h"
+#include "file.h"
+#include "folder.h"
+#include "html.h"
+#include "image.h"
+#include "link.h"
+#include "plain_text.h"
+#include "system_defined_pixelmap.h"
+#include "token_setproc.h"
+#include "udmf_recorder.h"
+#include "udmf_service.h"
+#include "video.h"
+
+using namespace OHOS::Security::AccessToken;
+using namespace OHOS::UDMF;
+
+namespace {
+constexpr int USER_ID = 100;
+constexpr int INST_INDEX = 0;
+constexpr const char *BUNDLE_NAME = "ohos.test.udmf.replay";
+constexpr const char *DEFAULT_STORE_DIR = "/data/local/tmp/udmf_replay";
+// a corrupted size is not worth running out of memory for
+constexpr int64_t MAX_RECORD_SIZE = 64 * 1024 * 1024;
+// statuses of the requests which are not replayed
+constexpr int32_t SKIPPED = -1;
+
+const std::map<uint32_t, const char *> CODE_NAMES = {
+    { UdmfService::SET_DATA, "SetData" },
+    { UdmfService::GET_DATA, "GetData" },
+    { UdmfService::GET_SUMMARY, "GetSummary" },
+    { UdmfService::ADD_PRIVILEGE, "AddPrivilege" },
+    { UdmfService::SYNC, "Sync" },
+    { UdmfService::QUERY_KEYS, "QueryKeys" },
+    { UdmfService::SUBSCRIBE, "Subscribe" },
+    { UdmfService::UNSUBSCRIBE, "Unsubscribe" },
+    { UdmfService::SET_BATCH_DATA, "SetBatchData" },
+    { UdmfService::APPEND_RECORD, "AppendRecord" },
+    { UdmfService::REPLACE_RECORD, "ReplaceRecord" },
+    { UdmfService::GET_PREVIEW, "GetPreview" },
+    { UdmfService::ENUMERATE_FOLDER, "EnumerateFolder" },
+};
+
+struct Latency {
+    int32_t count = 0;
+    int32_t failed = 0;
+    int64_t p50 = 0;
+    int64_t p90 = 0;
+    int64_t p99 = 0;
+    int64_t max = 0;
+};
+
+const char *GetName(uint32_t code)
+{
+    auto it = CODE_NAMES.find(code);
+    return it == CODE_NAMES.end() ? "Other" : it->second;
+}
+
+int64_t Percentile(const std::vector<int64_t> &sorted, int32_t percent)
+{
+    return sorted.empty() ? 0 : sorted[(sorted.size() - 1) * percent / 100];
+}
+
+std::map<uint32_t, Latency> Summarize(const std::vector<RecordedRequest> &requests)
+{
+    std::map<uint32_t, std::vector<int64_t>> durations;
+    std::map<uint32_t, Latency> latencies;
+    for (const auto &request : requests) {
+        if (request.status == SKIPPED) {
+            continue;
+        }
+        durations[request.code].push_back(request.duration);
+        latencies[request.code].failed += request.status == E_OK ? 0 : 1;
+    }
+    for (auto &[code, values] : durations) {
+        std::sort(values.begin(), values.end());
+        Latency &latency = latencies[code];
+        latency.count = static_cast<int32_t>(values.size());
+        latency.p50 = Percentile(values, 50);
+        latency.p90 = Percentile(values, 90);
+        latency.p99 = Percentile(values, 99);
+        latency.max = values.back();
+    }
+    return latencies;
+}
+
+void PrintLatencies(const char *title, const std::map<uint32_t, Latency> &latencies)
+{
+    printf("%s (us)\n", title);
+    printf("  %-14s %8s %8s %10s %10s %10s %10s\n", "code", "count", "failed", "p50", "p90", "p99", "max");
+    for (const auto &[code, latency] : latencies) {
+        printf("  %-14s %8d %8d %10lld %10lld %10lld %10lld\n", GetName(code), latency.count, latency.failed,
+            static_cast<long long>(latency.p50), static_cast<long long>(latency.p90),
+            static_cast<long long>(latency.p99), static_cast<long long>(latency.max));
+    }
+}
+
+double Change(int64_t base, int64_t target)
+{
+    return base == 0 ? 0.0 : (static_cast<double>(target) - static_cast<double>(base)) * 100.0 / base;
+}
+
+void PrintChanges(const std::map<uint32_t, Latency> &base, const std::map<uint32_t, Latency> &target)
+{
+    printf("change from base to target\n");
+    printf("  %-14s %10s %10s %10s\n", "code", "p50", "p90", "p99");
+    for (const auto &[code, latency] : target) {
+        auto it = base.find(code);
+        if (it == base.end()) {
+            continue;
+        }
+        printf("  %-14s %+9.1f%% %+9.1f%% %+9.1f%%\n", GetName(code), Change(it->second.p50, latency.p50),
+            Change(it->second.p90, latency.p90), Change(it->second.p99, latency.p99));
+    }
+}
+
+std::shared_ptr<UnifiedRecord> BuildRecord(int32_t type, int64_t size)
+{
+    size = std::clamp<int64_t>(size, 0, MAX_RECORD_SIZE);
+    std::string content(static_cast<size_t>(size), 'x');
+    std::vector<uint8_t> rawData(static_cast<size_t>(size), 0);
+    std::shared_ptr<File> file;
+    switch (type) {
+        case UDType::TEXT:
+        case UDType::PLAIN_TEXT:
+        case UDType::STYLED_TEXT:
+            return std::make_shared<PlainText>(content, "");
+        case UDType::HYPERLINK:
+            return std::make_shared<Link>(content);
+        case UDType::HTML:
+            return std::make_shared<Html>(content, "");
+        case UDType::FILE:
+        case UDType::MEDIA:
+        case UDType::AUDIO:
+        case UDType::OFFICE:
+        case UDType::EBOOK:
+        case UDType::COMPRESSION:
+        case UDType::GENERAL:
+            file = std::make_shared<File>();
+            break;
+        case UDType::FOLDER:
+            file = std::make_shared<Folder>();
+            break;
+        case UDType::IMAGE:
+            file = std::make_shared<Image>();
+            break;
+        case UDType::VIDEO:
+            file = std::make_shared<Video>();
+            break;
+        case UDType::SYSTEM_DEFINED_PIXEL_MAP:
+            return std::make_shared<SystemDefinedPixelMap>(rawData);
+        default:
+            return std::make_shared<ApplicationDefinedRecord>("ApplicationDefinedType", rawData);
+    }
+    // only a local uri is granted to the reader, so the size is carried by the remote one
+    file->SetRemoteUri(content);
+    return file;
+}
+
+UnifiedData BuildData(const std::vector<std::pair<int32_t, int64_t>> &records)
+{
+    UnifiedData unifiedData;
+    for (const auto &[type, size] : records) {
+        unifiedData.AddRecord(BuildRecord(type, size));
+    }
+    return unifiedData;
+}
+
+class Replayer {
+public:
+    explicit Replayer(int32_t tokenId) : tokenId_(tokenId) {}
+
+    RecordedRequest Replay(const RecordedRequest &request)
+    {
+        RecordedRequest replayed = request;
+        std::vector<std::string> keys;
+        auto begin = std::chrono::steady_clock::now();
+        replayed.status = Execute(request, keys);
+        replayed.duration = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        results_.push_back(std::move(keys));
+        return replayed;
+    }
+
+private:
+    bool GetQuery(const RecordedRequest &request, QueryOption &query)
+    {
+        if (request.keyRef < 0 || static_cast<size_t>(request.keyRef) >= results_.size() || request.keyPos < 0 ||
+            static_cast<size_t>(request.keyPos) >= results_[request.keyRef].size()) {
+            return false;
+        }
+        query.key = results_[request.keyRef][request.keyPos];
+        query.version = request.version;
+        query.tokenId = tokenId_;
+        return true;
+    }
+
+    int32_t Execute(const RecordedRequest &request, std::vector<std::string> &keys)
+    {
+        auto &manager = DataManager::GetInstance();
+        bool hasIntention = request.intention >= UD_INTENTION_DRAG && request.intention < UD_INTENTION_BUTT;
+        CustomOption option = { static_cast<Intention>(request.intention), tokenId_ };
+        QueryOption query;
+        switch (request.code) {
+            case UdmfService::SET_DATA: {
+                if (!hasIntention || request.datas.size() != 1) {
+                    return SKIPPED;
+                }
+                UnifiedData unifiedData = BuildData(request.datas[0]);
+                keys.emplace_back();
+                return manager.SaveData(option, unifiedData, keys.back());
+            }
+            case UdmfService::SET_BATCH_DATA: {
+                if (!hasIntention) {
+                    return SKIPPED;
+                }
+                std::vector<UnifiedData> unifiedDatas;
+                for (const auto &records : request.datas) {
+                    unifiedDatas.push_back(BuildData(records));
+                }
+                return manager.SaveBatchData(option, unifiedDatas, keys);
+            }
+            case UdmfService::APPEND_RECORD:
+            case UdmfService::REPLACE_RECORD: {
+                if (!GetQuery(request, query) || request.datas.size() != 1 || request.datas[0].size() != 1) {
+                    return SKIPPED;
+                }
+                auto record = BuildRecord(request.datas[0][0].first, request.datas[0][0].second);
+                return request.code == UdmfService::APPEND_RECORD ? manager.AppendRecord(query, record) :
+                    manager.ReplaceRecord(query, record);
+            }
+            case UdmfService::GET_DATA: {
+                UnifiedData unifiedData;
+                return GetQuery(request, query) ? manager.RetrieveData(query, unifiedData) : SKIPPED;
+            }
+            case UdmfService::GET_SUMMARY: {
+                Summary summary;
+                return GetQuery(request, query) ? manager.GetSummary(query, summary) : SKIPPED;
+            }
+            case UdmfService::GET_PREVIEW: {
+                Preview preview;
+                return GetQuery(request, query) ? manager.GetPreview(query, preview) : SKIPPED;
+            }
+            case UdmfService::QUERY_KEYS: {
+                if (!hasIntention) {
+                    return SKIPPED;
+                }
+                QueryCondition condition;
+                condition.intention = static_cast<Intention>(request.intention);
+                condition.tokenId = tokenId_;
+                return manager.QueryKeys(condition, keys);
+            }
+            default:
+                // subscriptions, privileges and syncs involve other processes and are not replayed, nor are
+                // folder enumerations, whose uris are not recorded
+                return SKIPPED;
+        }
+    }
+
+    int32_t tokenId_;
+    // keys returned by each request replayed, in the order of the recording
+    std::vector<std::vector<std::string>> results_;
+};
+
+int32_t AllocToken()
+{
+    HapInfoParams info = {
+        .userID = USER_ID,
+        .bundleName = BUNDLE_NAME,
+        .instIndex = INST_INDEX,
+        .appIDDesc = BUNDLE_NAME
+    };
+    HapPolicyParams policy = {
+        .apl = APL_NORMAL,
+        .domain = "test.domain",
+    };
+    auto tokenId = AccessTokenKit::AllocHapToken(info, policy);
+    SetSelfTokenID(tokenId.tokenIDEx);
+    return static_cast<int32_t>(tokenId.tokenIdExStruct.tokenID);
+}
+
+void FreeToken()
+{
+    auto tokenId = AccessTokenKit::GetHapTokenID(USER_ID, BUNDLE_NAME, INST_INDEX);
+    AccessTokenKit::DeleteToken(tokenId);
+}
+
+int Replay(const std::string &path, double speed, const std::string &storeDir, const std::string &output)
+{
+    std::vector<RecordedRequest> requests;
+    if (RequestRecorder::Load(path, requests) != E_OK) {
+        fprintf(stderr, "invalid recording: %s\n", path.c_str());
+        return EXIT_FAILURE;
+    }
+    DataManager::GetInstance().SetStoreDir(storeDir);
+    Replayer replayer(AllocToken());
+    std::vector<RecordedRequest> replayed;
+    int32_t changed = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (const auto &request : requests) {
+        if (speed > 0) {
+            auto offset = static_cast<int64_t>(request.offset / speed);
+            std::this_thread::sleep_until(start + std::chrono::microseconds(offset));
+        }
+        auto offset = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start);
+        replayed.push_back(replayer.Replay(request));
+        replayed.back().offset = offset.count();
+        if (replayed.back().status != SKIPPED && (replayed.back().status == E_OK) != (request.status == E_OK)) {
+            changed++;
+        }
+    }
+    FreeToken();
+
+    auto skipped = std::count_if(replayed.begin(), replayed.end(),
+        [](const RecordedRequest &request) { return request.status == SKIPPED; });
+    printf("requests: %zu, skipped: %lld, outcome changed: %d\n", replayed.size(), static_cast<long long>(skipped),
+        changed);
+    auto recorded = Summarize(requests);
+    auto latencies = Summarize(replayed);
+    PrintLatencies("recorded", recorded);
+    PrintLatencies("replayed", latencies);
+    PrintChanges(recorded, latencies);
+    if (!output.empty() && RequestRecorder::Save(output, replayed) != E_OK) {
+        fprintf(stderr, "write failed: %s\n", output.c_str());
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
+
+int Compare(const std::string &basePath, const std::string &targetPath)
+{
+    std::vector<RecordedRequest> base;
+    std::vector<RecordedRequest> target;
+    if (RequestRecorder::Load(basePath, base) != E_OK || RequestRecorder::Load(targetPath, target) != E_OK) {
+        fprintf(stderr, "invalid recording\n");
+        return EXIT_FAILURE;
+    }
+    auto baseLatencies = Summarize(base);
+    auto targetLatencies = Summarize(target);
+    PrintLatencies("base", baseLatencies);
+    PrintLatencies("target", targetLatencies);
+    PrintChanges(baseLatencies, targetLatencies);
+    return EXIT_SUCCESS;
+}
+
+void Usage()
+{
+    printf("usage:\n"
+        "  udmf_replay <recording> [--speed <factor>] [--store <dir>] [--output <file>]\n"
+        "    re-drives the recorded requests against the data manager with the stores in <dir>, at <factor> times\n"
+        "    the recorded pace (1 by default, 0 for no waits), and prints the latencies of each request code;\n"
+        "    the replayed requests are written to <file> for comparing builds\n"
+        "  udmf_replay --compare <base> <target>\n"
+        "    prints the latencies of each request code in two recordings and the change from base to target\n");
+}
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    constexpr int compareArgc = 4;
+    if (argc == compareArgc && strcmp(argv[1], "--compare") == 0) {
+        return Compare(argv[2], argv[3]);
+    }
+    if (argc < 2 || argv[1][0] == '-') {
+        Usage();
+        return EXIT_FAILURE;
+    }
+    if (argc % 2 != 0) {
+        Usage();
+        return EXIT_FAILURE;
+    }
+    double speed = 1.0;
+    std::string storeDir = DEFAULT_STORE_DIR;
+    std::string output;
+    for (int i = 2; i + 1 < argc; i += 2) {
+        if (strcmp(argv[i], "--speed") == 0) {
+            speed = atof(argv[i + 1]);
+        } else if (strcmp(argv[i], "--store") == 0) {
+            storeDir = argv[i + 1];
+        } else if (strcmp(argv[i], "--output") == 0) {
+            output = argv[i + 1];
+        } else {
+            Usage();
+            return EXIT_FAILURE;
+        }
+    }
+    return Replay(argv[1], speed, storeDir, output);
+}
@@ -13,7 +13,16 @@
  * limitations under the License.
  */
 
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstring>
+#include <fstream>
 #include <gtest/gtest.h>
+#include <map>
+#include <mutex>
+#include <set>
+#include <thread>
 
 #include <unistd.h>
 
@@ -35,6 +44,7 @@
 #include "system_defined_pixelmap.h"
 #include "system_defined_record.h"
 #include "text.h"
+#include "udmf_tracer.h"
 #include "video.h"
 
 using namespace testing::ext;
@@ -1207,4 +1217,967 @@ HWTEST_F(UdmfClientTest, GetSelfData002, TestSize.Level1)
     GetEmptyData(option2);
 
     LOG_INFO(UDMF_TEST, "GetSelfData002 end.");
-}
\ No newline at end of file
+}
+
+/**
+* @tc.name: GetSummary003
+* @tc.desc: Get summary of large data before its records are written, and get the whole data by self
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetSummary003, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetSummary003 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    std::string key;
+    ApplicationDefinedRecord record1;
+    std::vector<uint8_t> rawData1(1024 * 1024, 1);
+    record1.SetApplicationDefinedType("ApplicationDefinedType");
+    record1.SetRawData(rawData1);
+    std::shared_ptr<UnifiedRecord> record = std::make_shared<ApplicationDefinedRecord>(record1);
+    data1.AddRecord(record);
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key };
+    Summary summary;
+    status = UdmfClient::GetInstance().GetSummary(option2, summary);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(summary.totalSize, record->GetSize());
+    EXPECT_EQ(summary.summary[UD_TYPE_MAP.at(UDType::APPLICATION_DEFINED_RECORD)], record->GetSize());
+
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option2, data2);
+    ASSERT_EQ(status, E_OK);
+    std::shared_ptr<UnifiedRecord> record2 = data2.GetRecordAt(0);
+    ASSERT_NE(record2, nullptr);
+    ASSERT_EQ(record2->GetType(), UDType::APPLICATION_DEFINED_RECORD);
+    auto appRecord2 = static_cast<ApplicationDefinedRecord *>(record2.get());
+    EXPECT_EQ(appRecord2->GetRawData(), rawData1);
+
+    GetEmptyData(option2);
+
+    LOG_INFO(UDMF_TEST, "GetSummary003 end.");
+}
+
+/**
+* @tc.name: GetVersion001
+* @tc.desc: Set sys data several times and get the history by version
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetVersion001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetVersion001 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SYS };
+    std::vector<std::string> contents = { "content1", "content2", "content3" };
+    std::string key;
+    for (const auto &content : contents) {
+        UnifiedData data1;
+        PlainText plainText1;
+        plainText1.SetContent(content);
+        data1.AddRecord(std::make_shared<PlainText>(plainText1));
+        auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+        ASSERT_EQ(status, E_OK);
+    }
+
+    QueryOption option2 = { .key = key };
+    for (int32_t i = 0; i < static_cast<int32_t>(contents.size()); ++i) {
+        option2.version = -i;
+        UnifiedData data2;
+        auto status = UdmfClient::GetInstance().GetData(option2, data2);
+        ASSERT_EQ(status, E_OK);
+        std::shared_ptr<UnifiedRecord> record2 = data2.GetRecordAt(0);
+        ASSERT_NE(record2, nullptr);
+        ASSERT_EQ(record2->GetType(), UDType::PLAIN_TEXT);
+        auto plainText2 = static_cast<PlainText *>(record2.get());
+        EXPECT_EQ(plainText2->GetContent(), contents[contents.size() - 1 - i]);
+    }
+
+    option2.version = -1024;
+    UnifiedData data3;
+    auto status = UdmfClient::GetInstance().GetData(option2, data3);
+    EXPECT_EQ(status, E_OK);
+    EXPECT_TRUE(data3.IsEmpty());
+
+    LOG_INFO(UDMF_TEST, "GetVersion001 end.");
+}
+
+/**
+* @tc.name: QueryKeys001
+* @tc.desc: Set data and query its key page by page by intention, type and creation time
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, QueryKeys001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "QueryKeys001 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SHARE };
+    std::vector<std::string> setKeys;
+    for (int32_t i = 0; i < 3; ++i) {
+        UnifiedData data1;
+        PlainText plainText1;
+        plainText1.SetContent("content" + std::to_string(i));
+        data1.AddRecord(std::make_shared<PlainText>(plainText1));
+        std::string key;
+        auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+        ASSERT_EQ(status, E_OK);
+        setKeys.push_back(key);
+    }
+
+    QueryCondition condition = { .intention = Intention::UD_INTENTION_SHARE, .type = UDType::PLAIN_TEXT };
+    condition.pageSize = 1;
+    std::vector<std::string> keys;
+    do {
+        std::vector<std::string> page;
+        auto status = UdmfClient::GetInstance().QueryKeys(condition, page);
+        ASSERT_EQ(status, E_OK);
+        EXPECT_LE(page.size(), static_cast<size_t>(condition.pageSize));
+        keys.insert(keys.end(), page.begin(), page.end());
+    } while (!condition.cursor.empty());
+    for (const auto &key : setKeys) {
+        EXPECT_NE(std::find(keys.begin(), keys.end(), key), keys.end());
+    }
+
+    condition = { .intention = Intention::UD_INTENTION_SHARE, .type = UDType::HTML };
+    std::vector<std::string> htmlKeys;
+    auto status = UdmfClient::GetInstance().QueryKeys(condition, htmlKeys);
+    ASSERT_EQ(status, E_OK);
+    for (const auto &key : setKeys) {
+        EXPECT_EQ(std::find(htmlKeys.begin(), htmlKeys.end(), key), htmlKeys.end());
+    }
+
+    condition = { .intention = Intention::UD_INTENTION_SHARE, .beginTime = 1, .endTime = 0 };
+    status = UdmfClient::GetInstance().QueryKeys(condition, keys);
+    EXPECT_EQ(status, E_INVALID_PARAMETERS);
+
+    LOG_INFO(UDMF_TEST, "QueryKeys001 end.");
+}
+
+/**
+* @tc.name: Subscribe001
+* @tc.desc: Subscribe to the share intention and get notified of the data saved
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, Subscribe001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Subscribe001 begin.");
+
+    class TestObserver : public DataObserver {
+    public:
+        void OnChange(const std::vector<ChangeNotice> &notices) override
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            notices_.insert(notices_.end(), notices.begin(), notices.end());
+            cv_.notify_all();
+        }
+
+        std::mutex mutex_;
+        std::condition_variable cv_;
+        std::vector<ChangeNotice> notices_;
+    };
+    auto textObserver = std::make_shared<TestObserver>();
+    auto htmlObserver = std::make_shared<TestObserver>();
+    SubscribeOption option1 = { .intention = Intention::UD_INTENTION_SHARE, .types = { UDType::PLAIN_TEXT } };
+    auto status = UdmfClient::GetInstance().Subscribe(option1, textObserver);
+    ASSERT_EQ(status, E_OK);
+    status = UdmfClient::GetInstance().Subscribe(option1, textObserver);
+    EXPECT_EQ(status, E_INVALID_OPERATION);
+    SubscribeOption option2 = { .intention = Intention::UD_INTENTION_SHARE, .types = { UDType::HTML } };
+    status = UdmfClient::GetInstance().Subscribe(option2, htmlObserver);
+    ASSERT_EQ(status, E_OK);
+
+    CustomOption option3 = { .intention = Intention::UD_INTENTION_SHARE };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    status = UdmfClient::GetInstance().SetData(option3, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    {
+        std::unique_lock<std::mutex> lock(textObserver->mutex_);
+        bool notified = textObserver->cv_.wait_for(lock, std::chrono::seconds(1), [&textObserver, &key]() {
+            return std::any_of(textObserver->notices_.begin(), textObserver->notices_.end(),
+                [&key](const ChangeNotice &notice) { return notice.key == key; });
+        });
+        ASSERT_TRUE(notified);
+        auto notice = std::find_if(textObserver->notices_.begin(), textObserver->notices_.end(),
+            [&key](const ChangeNotice &notice) { return notice.key == key; });
+        auto &summary = notice->summary.summary;
+        EXPECT_NE(summary.find(UD_TYPE_MAP.at(UDType::PLAIN_TEXT)), summary.end());
+        EXPECT_EQ(notice->summary.totalSize, data1.GetSize());
+    }
+    {
+        std::lock_guard<std::mutex> lock(htmlObserver->mutex_);
+        EXPECT_TRUE(htmlObserver->notices_.empty());
+    }
+
+    EXPECT_EQ(UdmfClient::GetInstance().Unsubscribe(textObserver), E_OK);
+    EXPECT_EQ(UdmfClient::GetInstance().Unsubscribe(htmlObserver), E_OK);
+    EXPECT_EQ(UdmfClient::GetInstance().Unsubscribe(htmlObserver), E_INVALID_PARAMETERS);
+
+    LOG_INFO(UDMF_TEST, "Subscribe001 end.");
+}
+
+/**
+* @tc.name: GetSummary004
+* @tc.desc: Get the summary and the data again with the validator of the previous result
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetSummary004, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetSummary004 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SYS };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key };
+    Summary summary1;
+    status = UdmfClient::GetInstance().GetSummary(option2, summary1);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_FALSE(option2.validator.empty());
+    Summary summary2;
+    status = UdmfClient::GetInstance().GetSummary(option2, summary2);
+    EXPECT_EQ(status, E_NOT_MODIFIED);
+    EXPECT_TRUE(summary2.summary.empty());
+
+    QueryOption option3 = { .key = key };
+    Summary summary3;
+    status = UdmfClient::GetInstance().GetSummary(option3, summary3);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(summary3.totalSize, summary1.totalSize);
+    EXPECT_EQ(summary3.summary, summary1.summary);
+
+    QueryOption option4 = { .key = key };
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option4, data2);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(data2.GetRecords().size(), static_cast<size_t>(1));
+    UnifiedData data3;
+    status = UdmfClient::GetInstance().GetData(option4, data3);
+    EXPECT_EQ(status, E_NOT_MODIFIED);
+    QueryOption option5 = { .key = key };
+    UnifiedData data4;
+    status = UdmfClient::GetInstance().GetData(option5, data4);
+    ASSERT_EQ(status, E_OK);
+    auto plainText2 = static_cast<PlainText *>(data4.GetRecordAt(0).get());
+    ASSERT_NE(plainText2, nullptr);
+    EXPECT_EQ(plainText2->GetContent(), "content1");
+
+    LOG_INFO(UDMF_TEST, "GetSummary004 end.");
+}
+
+/**
+* @tc.name: GetData002
+* @tc.desc: Get the data again with a content validator, also after a privilege is added
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetData002, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetData002 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SHARE };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key, .validatorType = ValidatorType::CONTENT_VALIDATOR };
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option2, data2);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_FALSE(option2.validator.empty());
+    std::string validator = option2.validator;
+
+    UnifiedData data3;
+    status = UdmfClient::GetInstance().GetData(option2, data3);
+    EXPECT_EQ(status, E_NOT_MODIFIED);
+    EXPECT_TRUE(data3.IsEmpty());
+
+    Summary summary;
+    status = UdmfClient::GetInstance().GetSummary(option2, summary);
+    EXPECT_EQ(status, E_NOT_MODIFIED);
+    EXPECT_EQ(option2.validator, validator);
+
+    QueryOption option3 = {
+        .key = key, .validator = "sha256:0", .validatorType = ValidatorType::CONTENT_VALIDATOR
+    };
+    UnifiedData data4;
+    status = UdmfClient::GetInstance().GetData(option3, data4);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(data4.GetRecords().size(), static_cast<size_t>(1));
+    EXPECT_EQ(option3.validator, validator);
+
+    LOG_INFO(UDMF_TEST, "GetData002 end.");
+}
+
+/**
+* @tc.name: GetData003
+* @tc.desc: Get small data packed into one entry and large data stored by records
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetData003, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetData003 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SHARE };
+    std::vector<std::string> contents = { "content1", std::string(32 * 1024, 'a') };
+    for (const auto &content : contents) {
+        UnifiedData data1;
+        PlainText plainText1;
+        plainText1.SetContent(content);
+        data1.AddRecord(std::make_shared<PlainText>(plainText1));
+        data1.AddRecord(std::make_shared<PlainText>(plainText1));
+        std::string key;
+        auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+        ASSERT_EQ(status, E_OK);
+
+        QueryOption option2 = { .key = key };
+        Summary summary;
+        status = UdmfClient::GetInstance().GetSummary(option2, summary);
+        ASSERT_EQ(status, E_OK);
+        EXPECT_EQ(summary.totalSize, data1.GetSize());
+
+        UnifiedData data2;
+        status = UdmfClient::GetInstance().GetData(option2, data2);
+        ASSERT_EQ(status, E_OK);
+        ASSERT_EQ(data2.GetRecords().size(), static_cast<size_t>(2));
+        auto plainText2 = static_cast<PlainText *>(data2.GetRecordAt(0).get());
+        ASSERT_NE(plainText2, nullptr);
+        EXPECT_EQ(plainText2->GetContent(), content);
+    }
+
+    LOG_INFO(UDMF_TEST, "GetData003 end.");
+}
+
+/**
+* @tc.name: GetData004
+* @tc.desc: Get the data cached in the client twice, each caller getting records of its own
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetData004, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetData004 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SHARE };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key };
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option2, data2);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(data2.GetRecords().size(), static_cast<size_t>(1));
+    auto plainText2 = static_cast<PlainText *>(data2.GetRecordAt(0).get());
+    ASSERT_NE(plainText2, nullptr);
+    plainText2->SetContent("changed");
+
+    QueryOption option3 = { .key = key };
+    UnifiedData data3;
+    status = UdmfClient::GetInstance().GetData(option3, data3);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(data3.GetRecords().size(), static_cast<size_t>(1));
+    EXPECT_NE(data3.GetRecordAt(0), data2.GetRecordAt(0));
+    auto plainText3 = static_cast<PlainText *>(data3.GetRecordAt(0).get());
+    ASSERT_NE(plainText3, nullptr);
+    EXPECT_EQ(plainText3->GetContent(), "content1");
+
+    LOG_INFO(UDMF_TEST, "GetData004 end.");
+}
+
+/**
+* @tc.name: SetBatchData001
+* @tc.desc: Set several data with one call and get each of them by its key
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, SetBatchData001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "SetBatchData001 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_SHARE };
+    std::vector<UnifiedData> datas(3);
+    for (size_t i = 0; i < datas.size(); ++i) {
+        PlainText plainText1;
+        plainText1.SetContent("content" + std::to_string(i));
+        datas[i].AddRecord(std::make_shared<PlainText>(plainText1));
+    }
+    std::vector<std::string> keys;
+    auto status = UdmfClient::GetInstance().SetBatchData(option1, datas, keys);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(keys.size(), datas.size());
+
+    for (size_t i = 0; i < keys.size(); ++i) {
+        QueryOption option2 = { .key = keys[i] };
+        UnifiedData data2;
+        status = UdmfClient::GetInstance().GetData(option2, data2);
+        ASSERT_EQ(status, E_OK);
+        ASSERT_EQ(data2.GetRecords().size(), static_cast<size_t>(1));
+        auto plainText2 = static_cast<PlainText *>(data2.GetRecordAt(0).get());
+        ASSERT_NE(plainText2, nullptr);
+        EXPECT_EQ(plainText2->GetContent(), "content" + std::to_string(i));
+    }
+
+    std::vector<UnifiedData> emptyDatas(1);
+    status = UdmfClient::GetInstance().SetBatchData(option1, emptyDatas, keys);
+    EXPECT_EQ(status, E_INVALID_VALUE);
+
+    LOG_INFO(UDMF_TEST, "SetBatchData001 end.");
+}
+
+/**
+* @tc.name: AppendRecord001
+* @tc.desc: Append a record to saved data, replace it and get the data with both records
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, AppendRecord001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "AppendRecord001 begin.");
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key };
+    PlainText plainText2;
+    plainText2.SetContent("content2");
+    auto record2 = std::make_shared<PlainText>(plainText2);
+    status = UdmfClient::GetInstance().AppendRecord(option2, record2);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_FALSE(record2->GetUid().empty());
+
+    record2->SetContent("content3");
+    status = UdmfClient::GetInstance().ReplaceRecord(option2, record2);
+    ASSERT_EQ(status, E_OK);
+    auto record3 = std::make_shared<PlainText>(plainText2);
+    record3->SetUid("unknown");
+    status = UdmfClient::GetInstance().ReplaceRecord(option2, record3);
+    EXPECT_EQ(status, E_INVALID_PARAMETERS);
+
+    Summary summary;
+    status = UdmfClient::GetInstance().GetSummary(option2, summary);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(summary.totalSize, plainText1.GetSize() + record2->GetSize());
+
+    AddPrivilege(option2);
+    SetHapToken2();
+    status = UdmfClient::GetInstance().AppendRecord(option2, record3);
+    EXPECT_EQ(status, E_NO_PERMISSION);
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option2, data2);
+    ASSERT_EQ(status, E_OK);
+    auto records = data2.GetRecords();
+    ASSERT_EQ(records.size(), static_cast<size_t>(2));
+    auto it = std::find_if(records.begin(), records.end(),
+        [&record2](const auto &record) { return record->GetUid() == record2->GetUid(); });
+    ASSERT_NE(it, records.end());
+    auto plainText3 = static_cast<PlainText *>(it->get());
+    EXPECT_EQ(plainText3->GetContent(), "content3");
+
+    LOG_INFO(UDMF_TEST, "AppendRecord001 end.");
+}
+
+/**
+* @tc.name: DumpTrace001
+* @tc.desc: Trace a request and find its spans in the client, the service and the store
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, DumpTrace001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "DumpTrace001 begin.");
+
+    auto status = UdmfClient::GetInstance().SetTraceEnabled(true);
+    EXPECT_EQ(status, E_NO_PERMISSION);
+    SetNativeToken();
+    status = UdmfClient::GetInstance().SetTraceEnabled(true);
+    ASSERT_EQ(status, E_OK);
+
+    SetHapToken1();
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    SetNativeToken();
+    std::string trace;
+    status = UdmfClient::GetInstance().DumpTrace(trace);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(trace.find("{\"traceEvents\":["), 0);
+    EXPECT_NE(trace.find("\"client.SetData\""), std::string::npos);
+    EXPECT_NE(trace.find("\"proxy.Binder\""), std::string::npos);
+    EXPECT_NE(trace.find("\"manager.SaveData\""), std::string::npos);
+    EXPECT_NE(trace.find("\"store.Put\""), std::string::npos);
+    EXPECT_EQ(UdmfClient::GetInstance().SetTraceEnabled(false), E_OK);
+
+    LOG_INFO(UDMF_TEST, "DumpTrace001 end.");
+}
+
+/**
+* @tc.name: DumpStats001
+* @tc.desc: Dump the memory accounting and the store statistics after saving and getting data
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, DumpStats001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "DumpStats001 begin.");
+
+    SetHapToken1();
+    std::string stats;
+    auto status = UdmfClient::GetInstance().DumpStats(stats);
+    EXPECT_EQ(status, E_NO_PERMISSION);
+
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    SetNativeToken();
+    status = UdmfClient::GetInstance().DumpStats(stats);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(stats.find("service memory:\n"), 0);
+    EXPECT_NE(stats.find("  parcel: current="), std::string::npos);
+    auto drag = stats.find("  drag: data=1 ");
+    ASSERT_NE(drag, std::string::npos);
+    // the data was just saved, so its age in milliseconds is small and not off by the epoch in seconds
+    auto age = stats.find(" oldestAge=", drag);
+    ASSERT_NE(age, std::string::npos);
+    int64_t oldestAge = std::strtoll(stats.c_str() + age + strlen(" oldestAge="), nullptr, 10);
+    EXPECT_GE(oldestAge, 0);
+    EXPECT_LT(oldestAge, 60 * 1000);
+    EXPECT_EQ(stats.compare(stats.find_first_not_of("0123456789", age + strlen(" oldestAge=")), 3, "ms "), 0);
+    EXPECT_NE(stats.find("    " + UD_TYPE_MAP.at(UDType::PLAIN_TEXT) + ": "), std::string::npos);
+    EXPECT_NE(stats.find("client memory:\n"), std::string::npos);
+
+    LOG_INFO(UDMF_TEST, "DumpStats001 end.");
+}
+
+/**
+* @tc.name: AddPrivilege003
+* @tc.desc: Grant the uris of a drag ahead when its privilege is added, then replace the drag before it is read
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, AddPrivilege003, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "AddPrivilege003 begin.");
+
+    SetHapToken2();
+    SetHapToken1();
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    File file1;
+    file1.SetUri("file://ohos.test.demo1/data/storage/el2/base/files/udmf_test.txt");
+    data1.AddRecord(std::make_shared<File>(file1));
+    std::string key1;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key1);
+    ASSERT_EQ(status, E_OK);
+    QueryOption option2 = { .key = key1 };
+    AddPrivilege(option2);
+
+    // the drag is cancelled by the next one, whose grants are not held up by the revoked ones
+    SetHapToken1();
+    UnifiedData data2;
+    File file2;
+    file2.SetRemoteUri("remoteUri");
+    data2.AddRecord(std::make_shared<File>(file2));
+    std::string key2;
+    status = UdmfClient::GetInstance().SetData(option1, data2, key2);
+    ASSERT_EQ(status, E_OK);
+    QueryOption option3 = { .key = key2 };
+    AddPrivilege(option3);
+    SetHapToken2();
+    UnifiedData data3;
+    status = UdmfClient::GetInstance().GetData(option3, data3);
+    ASSERT_EQ(status, E_OK);
+    auto record = data3.GetRecordAt(0);
+    ASSERT_NE(record, nullptr);
+    EXPECT_EQ(static_cast<File *>(record.get())->GetRemoteUri(), file2.GetRemoteUri());
+
+    GetEmptyData(option2);
+
+    LOG_INFO(UDMF_TEST, "AddPrivilege003 end.");
+}
+
+/**
+* @tc.name: GetPreview001
+* @tc.desc: Get the downscaled preview of a dragged pixel map, without consuming the data
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetPreview001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetPreview001 begin.");
+
+    SetHapToken1();
+    constexpr int32_t width = 512;
+    constexpr int32_t height = 256;
+    constexpr uint8_t value = 200;
+    SystemDefinedPixelMap pixelMap;
+    pixelMap.SetRawData(std::vector<uint8_t>(width * height * 4, value));
+    UDDetails details = {
+        { SystemDefinedPixelMap::WIDTH, width },
+        { SystemDefinedPixelMap::HEIGHT, height },
+    };
+    pixelMap.SetDetails(details);
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    data1.AddRecord(std::make_shared<SystemDefinedPixelMap>(pixelMap));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key };
+    Preview preview;
+    status = UdmfClient::GetInstance().GetPreview(option2, preview);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_EQ(preview.width, 128);
+    EXPECT_EQ(preview.height, 64);
+    ASSERT_EQ(preview.pixels.size(), static_cast<size_t>(128 * 64 * 4));
+    EXPECT_TRUE(std::all_of(preview.pixels.begin(), preview.pixels.end(), [](uint8_t pixel) {
+        return pixel == value;
+    }));
+
+    QueryOption option3 = { .key = key };
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option3, data2);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(data2.GetRecords().size(), static_cast<size_t>(1));
+
+    LOG_INFO(UDMF_TEST, "GetPreview001 end.");
+}
+
+/**
+* @tc.name: GetPreview002
+* @tc.desc: Append a pixel map to a large data and replace it, the preview follows the pixel map
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetPreview002, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetPreview002 begin.");
+
+    SetHapToken1();
+    // a text larger than a packed data keeps the records in entries of their own
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent(std::string(64 * 1024, 'x'));
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    constexpr int32_t width = 64;
+    constexpr int32_t height = 32;
+    auto makePixelMap = [width, height](uint8_t value) {
+        auto pixelMap = std::make_shared<SystemDefinedPixelMap>();
+        pixelMap->SetRawData(std::vector<uint8_t>(width * height * 4, value));
+        UDDetails details = {
+            { SystemDefinedPixelMap::WIDTH, width },
+            { SystemDefinedPixelMap::HEIGHT, height },
+        };
+        pixelMap->SetDetails(details);
+        return pixelMap;
+    };
+    auto isFilled = [](const Preview &preview, uint8_t value) {
+        return preview.width == width && preview.height == height &&
+            preview.pixels.size() == static_cast<size_t>(width * height * 4) &&
+            std::all_of(preview.pixels.begin(), preview.pixels.end(), [value](uint8_t pixel) {
+                return pixel == value;
+            });
+    };
+    QueryOption option2 = { .key = key };
+    auto pixelMap1 = makePixelMap(200);
+    status = UdmfClient::GetInstance().AppendRecord(option2, pixelMap1);
+    ASSERT_EQ(status, E_OK);
+    Preview preview1;
+    status = UdmfClient::GetInstance().GetPreview(option2, preview1);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_TRUE(isFilled(preview1, 200));
+
+    auto pixelMap2 = makePixelMap(100);
+    pixelMap2->SetUid(pixelMap1->GetUid());
+    status = UdmfClient::GetInstance().ReplaceRecord(option2, pixelMap2);
+    ASSERT_EQ(status, E_OK);
+    Preview preview2;
+    status = UdmfClient::GetInstance().GetPreview(option2, preview2);
+    ASSERT_EQ(status, E_OK);
+    EXPECT_TRUE(isFilled(preview2, 100));
+
+    LOG_INFO(UDMF_TEST, "GetPreview002 end.");
+}
+
+/**
+* @tc.name: SetData015
+* @tc.desc: Set a pixel map, which is sent and stored encoded and read back as it was
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, SetData015, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "SetData015 begin.");
+
+    constexpr size_t pixelCount = 64 * 1024;
+    std::vector<uint8_t> rawData;
+    for (size_t i = 0; i < pixelCount; ++i) {
+        uint8_t value = static_cast<uint8_t>(i / 256);
+        rawData.insert(rawData.end(), { value, value, static_cast<uint8_t>(i), 0xff });
+    }
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    SystemDefinedPixelMap pixelMap1;
+    pixelMap1.SetRawData(rawData);
+    auto record1 = std::make_shared<SystemDefinedPixelMap>(pixelMap1);
+    data1.AddRecord(record1);
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+    // the record of the caller is not encoded, a copy of it is
+    EXPECT_EQ(record1->GetEncoding(), PIXEL_ENCODING_RAW);
+
+    QueryOption option2 = { .key = key };
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option2, data2);
+    ASSERT_EQ(status, E_OK);
+    std::shared_ptr<UnifiedRecord> record2 = data2.GetRecordAt(0);
+    ASSERT_NE(record2, nullptr);
+    ASSERT_EQ(record2->GetType(), UDType::SYSTEM_DEFINED_PIXEL_MAP);
+    auto pixelMap2 = static_cast<SystemDefinedPixelMap *>(record2.get());
+    EXPECT_EQ(pixelMap2->GetEncoding(), PIXEL_ENCODING_QOI);
+    EXPECT_LT(pixelMap2->GetEncodedData().size(), rawData.size());
+    EXPECT_EQ(pixelMap2->GetSize(), record1->GetSize());
+    EXPECT_EQ(pixelMap2->GetRawData(), rawData);
+
+    LOG_INFO(UDMF_TEST, "SetData015 end.");
+}
+
+/**
+* @tc.name: EnumerateFolder001
+* @tc.desc: Enumerate a dragged folder and a folder in it batch by batch, without consuming the data
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, EnumerateFolder001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "EnumerateFolder001 begin.");
+
+    const std::string folderPath = "/data/app/el2/100/base/ohos.test.demo1/files/udmf_folder";
+    const std::string folderUri = "file://ohos.test.demo1/data/storage/el2/base/files/udmf_folder";
+    constexpr int32_t fileCount = 5;
+    std::string command = "mkdir -p " + folderPath + "/sub";
+    ASSERT_EQ(system(command.c_str()), 0);
+    for (int32_t i = 0; i < fileCount; ++i) {
+        std::ofstream file(folderPath + "/file " + std::to_string(i), std::ios::binary | std::ios::trunc);
+        file << std::string(i, 'x');
+    }
+    std::ofstream(folderPath + "/sub/inner.txt") << "inner";
+
+    SetHapToken1();
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    Folder folder;
+    folder.SetUri(folderUri);
+    data1.AddRecord(std::make_shared<Folder>(folder));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    QueryOption option2 = { .key = key };
+    std::map<std::string, FolderEntry> entries;
+    std::string cursor;
+    int32_t batches = 0;
+    do {
+        FolderBatch batch;
+        status = UdmfClient::GetInstance().EnumerateFolder(option2, folderUri, cursor, 2, batch);
+        ASSERT_EQ(status, E_OK);
+        ASSERT_LE(batch.entries.size(), static_cast<size_t>(2));
+        for (const auto &entry : batch.entries) {
+            entries[entry.name] = entry;
+        }
+        cursor = batch.cursor;
+        ++batches;
+    } while (!cursor.empty() && batches <= fileCount + 1);
+    EXPECT_TRUE(cursor.empty());
+    ASSERT_EQ(entries.size(), static_cast<size_t>(fileCount + 1));
+    EXPECT_EQ(entries["sub"].type, UDType::FOLDER);
+    EXPECT_EQ(entries["file 3"].type, UDType::FILE);
+    EXPECT_EQ(entries["file 3"].size, 3);
+    EXPECT_EQ(entries["file 3"].uri, folderUri + "/file%203");
+
+    FolderBatch batch;
+    status = UdmfClient::GetInstance().EnumerateFolder(option2, entries["sub"].uri, "", 0, batch);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(batch.entries.size(), static_cast<size_t>(1));
+    EXPECT_EQ(batch.entries[0].name, "inner.txt");
+    status = UdmfClient::GetInstance().EnumerateFolder(option2, folderUri + "/../..", "", 0, batch);
+    EXPECT_EQ(status, E_INVALID_PARAMETERS);
+    status = UdmfClient::GetInstance().EnumerateFolder(option2, "file://ohos.test.demo2/data/storage/el2/base/files",
+        "", 0, batch);
+    EXPECT_EQ(status, E_INVALID_PARAMETERS);
+
+    UnifiedData data2;
+    status = UdmfClient::GetInstance().GetData(option2, data2);
+    ASSERT_EQ(status, E_OK);
+    ASSERT_EQ(data2.GetRecords().size(), static_cast<size_t>(1));
+    command = "rm -rf " + folderPath;
+    system(command.c_str());
+
+    LOG_INFO(UDMF_TEST, "EnumerateFolder001 end.");
+}
+
+/**
+* @tc.name: GetSummary005
+* @tc.desc: Get the summary of a data from many readers at once, the reads in flight together share a store read,
+*           and while records are appended each summary matches the validator returned with it
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfClientTest, GetSummary005, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetSummary005 begin.");
+
+    // the spans of the name which began since the time, by the monotonic clock shared with the service
+    auto countSpans = [](const std::string &trace, const std::string &name, int64_t since) {
+        std::string pattern = "{\"name\":\"" + name + "\",";
+        std::string tsField = "\"ts\":";
+        int32_t count = 0;
+        for (size_t pos = trace.find(pattern); pos != std::string::npos; pos = trace.find(pattern, pos + 1)) {
+            size_t ts = trace.find(tsField, pos);
+            if (ts != std::string::npos && std::strtoll(trace.c_str() + ts + tsField.size(), nullptr, 10) >= since) {
+                ++count;
+            }
+        }
+        return count;
+    };
+    SetNativeToken();
+    ASSERT_EQ(UdmfClient::GetInstance().SetTraceEnabled(true), E_OK);
+    SetHapToken1();
+    CustomOption option1 = { .intention = Intention::UD_INTENTION_DRAG };
+    UnifiedData data1;
+    PlainText plainText1;
+    plainText1.SetContent("content1");
+    data1.AddRecord(std::make_shared<PlainText>(plainText1));
+    std::string key;
+    auto status = UdmfClient::GetInstance().SetData(option1, data1, key);
+    ASSERT_EQ(status, E_OK);
+
+    // a validator of no result makes each reader go to the service instead of the cache of the client, and the
+    // readers of a round are let go at once so their reads overlap; a round is tried again while none is shared
+    constexpr int32_t readerCount = 16;
+    constexpr int32_t maxRounds = 10;
+    int32_t fewestReads = readerCount;
+    for (int32_t round = 0; round < maxRounds && fewestReads == readerCount; ++round) {
+        int64_t since = Tracer::Now();
+        std::atomic<int32_t> waiting = readerCount;
+        std::atomic<int32_t> succeeded = 0;
+        std::vector<std::thread> readers;
+        for (int32_t i = 0; i < readerCount; ++i) {
+            readers.emplace_back([&key, &waiting, &succeeded]() {
+                for (--waiting; waiting.load() > 0;) {
+                    std::this_thread::yield();
+                }
+                QueryOption option2 = { .key = key, .validator = "stale" };
+                Summary summary;
+                if (UdmfClient::GetInstance().GetSummary(option2, summary) == E_OK && summary.totalSize > 0) {
+                    ++succeeded;
+                }
+            });
+        }
+        for (auto &reader : readers) {
+            reader.join();
+        }
+        EXPECT_EQ(succeeded.load(), readerCount);
+        SetNativeToken();
+        std::string trace;
+        ASSERT_EQ(UdmfClient::GetInstance().DumpTrace(trace), E_OK);
+        SetHapToken1();
+        int32_t reads = countSpans(trace, "store.GetSummary", since);
+        int32_t joins = countSpans(trace, "manager.JoinSummary", since);
+        LOG_INFO(UDMF_TEST, "round: %{public}d, readers: %{public}d, store reads: %{public}d, joined: %{public}d",
+            round, readerCount, reads, joins);
+        // each reader either reads the store or joins a read in flight
+        EXPECT_EQ(reads + joins, readerCount);
+        fewestReads = std::min(fewestReads, reads);
+    }
+    // without sharing, each reader of every round reads the store once
+    EXPECT_LT(fewestReads, readerCount);
+    SetNativeToken();
+    EXPECT_EQ(UdmfClient::GetInstance().SetTraceEnabled(false), E_OK);
+    SetHapToken1();
+
+    // readers going on while records are appended take a new validator and summary as the data changes
+    constexpr int32_t readCount = 20;
+    constexpr int32_t appendCount = 10;
+    std::mutex mutex;
+    std::map<std::string, std::set<int64_t>> sizes;
+    std::atomic<int32_t> failed = 0;
+    std::vector<std::thread> readers;
+    for (int32_t i = 0; i < readerCount; ++i) {
+        readers.emplace_back([&key, &mutex, &sizes, &failed]() {
+            for (int32_t j = 0; j < readCount; ++j) {
+                QueryOption option2 = { .key = key, .validator = "stale" };
+                Summary summary;
+                if (UdmfClient::GetInstance().GetSummary(option2, summary) != E_OK || option2.validator.empty()) {
+                    ++failed;
+                    continue;
+                }
+                std::lock_guard<std::mutex> lock(mutex);
+                sizes[option2.validator].insert(summary.totalSize);
+            }
+        });
+    }
+    for (int32_t i = 0; i < appendCount; ++i) {
+        QueryOption option3 = { .key = key };
+        PlainText plainText2;
+        plainText2.SetContent("content2");
+        EXPECT_EQ(UdmfClient::GetInstance().AppendRecord(option3, std::make_shared<PlainText>(plainText2)), E_OK);
+    }
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    EXPECT_EQ(failed.load(), 0);
+
+    // a validator always comes with the same summary, the one of the data it validates
+    for (const auto &[validator, totalSizes] : sizes) {
+        EXPECT_EQ(totalSizes.size(), static_cast<size_t>(1)) << validator;
+    }
+    QueryOption option4 = { .key = key, .validator = "stale" };
+    Summary summary;
+    ASSERT_EQ(UdmfClient::GetInstance().GetSummary(option4, summary), E_OK);
+    EXPECT_EQ(summary.totalSize, plainText1.GetSize() * (appendCount + 1));
+    auto it = sizes.find(option4.validator);
+    if (it != sizes.end()) {
+        EXPECT_EQ(*it->second.begin(), summary.totalSize);
+    }
+    for (const auto &[validator, totalSizes] : sizes) {
+        QueryOption option5 = { .key = key, .validator = validator };
+        Summary cached;
+        status = UdmfClient::GetInstance().GetSummary(option5, cached);
+        EXPECT_EQ(status == E_NOT_MODIFIED, validator == option4.validator);
+    }
+
+    LOG_INFO(UDMF_TEST, "GetSummary005 end.");
+}
@@ -0,0 +1,159 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <fcntl.h>
+#include <fstream>
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file.h"
+#include "file_size_resolver.h"
+#include "folder.h"
+#include "folder_utils.h"
+#include "logger.h"
+
+using namespace testing::ext;
+using namespace OHOS::UDMF;
+using namespace OHOS;
+
+class UdmfFileSizeTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() override {}
+    void TearDown() override
+    {
+        unlink((FILES_PATH + "/a.txt").c_str());
+        unlink((FILES_PATH + "/link").c_str());
+        unlink((FILES_PATH + "/dir/link").c_str());
+        unlink((FILES_PATH + "/dir/b.txt").c_str());
+        rmdir((FILES_PATH + "/dir").c_str());
+        unlink((OUTSIDE_PATH + "/c.txt").c_str());
+        rmdir(OUTSIDE_PATH.c_str());
+    }
+
+    static void WriteFile(const std::string &path, size_t size)
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        file << std::string(size, 'x');
+    }
+
+    static int64_t GetFileSize(const std::shared_ptr<UnifiedRecord> &record)
+    {
+        UDDetails details = static_cast<File *>(record.get())->GetDetails();
+        auto it = details.find(File::FILE_SIZE);
+        return it == details.end() ? -1 : std::get<int64_t>(it->second);
+    }
+
+    static constexpr int32_t USER_ID = 100;
+    static inline const std::string BUNDLE_NAME = "ohos.test.filesize";
+    static inline const std::string FILES_URI = "file://" + BUNDLE_NAME + "/data/storage/el2/base/files";
+    static inline const std::string FILES_PATH = "/data/app/el2/100/base/" + BUNDLE_NAME + "/files";
+    static inline const std::string OUTSIDE_PATH = "/data/local/tmp/udmf_file_size_outside";
+};
+
+/**
+* @tc.name: GetPhysicalPath001
+* @tc.desc: Map the file uris of the sandbox of a bundle, refusing those of other bundles or out of the sandbox
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfFileSizeTest, GetPhysicalPath001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetPhysicalPath001 begin.");
+    EXPECT_EQ(FileSizeResolver::GetPhysicalPath(FILES_URI + "/a%20b.txt", BUNDLE_NAME, USER_ID),
+        FILES_PATH + "/a b.txt");
+    EXPECT_EQ(FileSizeResolver::GetPhysicalPath("file://" + BUNDLE_NAME + "/data/storage/el1/database/rdb",
+        BUNDLE_NAME, USER_ID), "/data/app/el1/100/database/" + BUNDLE_NAME + "/rdb");
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath(FILES_URI + "/a.txt", "ohos.test.other", USER_ID).empty());
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath(FILES_URI + "/../../../x", BUNDLE_NAME, USER_ID).empty());
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath(FILES_URI + "/%2E%2E/x", BUNDLE_NAME, USER_ID).empty());
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath(FILES_URI + "/a.txt?x", BUNDLE_NAME, USER_ID).empty());
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath("file://" + BUNDLE_NAME + "/data/storage/..%2F/base/x",
+        BUNDLE_NAME, USER_ID).empty());
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath("file://" + BUNDLE_NAME + "/data/storage/el2/cache/x",
+        BUNDLE_NAME, USER_ID).empty());
+    EXPECT_TRUE(FileSizeResolver::GetPhysicalPath("file://media/Photo/1", BUNDLE_NAME, USER_ID).empty());
+    LOG_INFO(UDMF_TEST, "GetPhysicalPath001 end.");
+}
+
+/**
+* @tc.name: Resolve001
+* @tc.desc: Resolve the sizes of a file and a folder, dropping the sizes claimed for files which are not resolved
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfFileSizeTest, Resolve001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Resolve001 begin.");
+    std::string command = "mkdir -p " + FILES_PATH + "/dir";
+    ASSERT_EQ(system(command.c_str()), 0);
+    WriteFile(FILES_PATH + "/a.txt", 1000);
+    WriteFile(FILES_PATH + "/dir/b.txt", 2000);
+
+    auto file = std::make_shared<File>(FILES_URI + "/a.txt");
+    auto folder = std::make_shared<Folder>();
+    folder->SetUri(FILES_URI);
+    auto remote = std::make_shared<File>("file://media/Photo/1");
+    UDDetails details = { { File::FILE_SIZE, static_cast<int64_t>(1) << 40 } };
+    remote->SetDetails(details);
+    FileSizeResolver::GetInstance().Resolve({ file, folder, remote }, BUNDLE_NAME, USER_ID);
+    EXPECT_EQ(GetFileSize(file), 1000);
+    EXPECT_EQ(GetFileSize(folder), 3000);
+    EXPECT_EQ(GetFileSize(remote), -1);
+    EXPECT_EQ(FileSizeResolver::GetSummarySize(file), file->GetSize() + 1000);
+    EXPECT_EQ(FileSizeResolver::GetSummarySize(remote), remote->GetSize());
+
+    // the sizes are cached, a change is seen once they expire
+    WriteFile(FILES_PATH + "/a.txt", 10);
+    auto again = std::make_shared<File>(FILES_URI + "/a.txt");
+    FileSizeResolver::GetInstance().Resolve({ again }, BUNDLE_NAME, USER_ID);
+    EXPECT_EQ(GetFileSize(again), 1000);
+    LOG_INFO(UDMF_TEST, "Resolve001 end.");
+}
+
+/**
+* @tc.name: Resolve002
+* @tc.desc: Resolve the sizes without following the symbolic links in the sandbox out of it
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfFileSizeTest, Resolve002, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Resolve002 begin.");
+    std::string command = "mkdir -p " + FILES_PATH + "/dir " + OUTSIDE_PATH;
+    ASSERT_EQ(system(command.c_str()), 0);
+    WriteFile(FILES_PATH + "/dir/b.txt", 2000);
+    WriteFile(OUTSIDE_PATH + "/c.txt", 5000);
+    ASSERT_EQ(symlink(OUTSIDE_PATH.c_str(), (FILES_PATH + "/link").c_str()), 0);
+    ASSERT_EQ(symlink(OUTSIDE_PATH.c_str(), (FILES_PATH + "/dir/link").c_str()), 0);
+
+    auto folder = std::make_shared<Folder>();
+    folder->SetUri(FILES_URI + "/dir");
+    auto linked = std::make_shared<File>(FILES_URI + "/link/c.txt");
+    FileSizeResolver::GetInstance().Resolve({ folder, linked }, BUNDLE_NAME, USER_ID);
+    EXPECT_EQ(GetFileSize(folder), 2000);
+    EXPECT_EQ(GetFileSize(linked), 0);
+
+    int fd = FolderUtils::OpenInSandbox(FILES_PATH + "/link", O_RDONLY | O_DIRECTORY);
+    EXPECT_LT(fd, 0);
+    fd = FolderUtils::OpenInSandbox(FILES_PATH + "/link/c.txt", O_RDONLY);
+    EXPECT_LT(fd, 0);
+    fd = FolderUtils::OpenInSandbox(FILES_PATH + "/dir/b.txt", O_RDONLY);
+    EXPECT_GE(fd, 0);
+    close(fd);
+    FolderBatch batch;
+    EXPECT_EQ(FolderUtils::List(FILES_PATH + "/link", "", 0, batch), E_INVALID_PARAMETERS);
+    LOG_INFO(UDMF_TEST, "Resolve002 end.");
+}
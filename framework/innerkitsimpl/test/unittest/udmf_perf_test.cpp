@@ -0,0 +1,457 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cinttypes>
+#include <condition_variable>
+#include <cstring>
+#include <future>
+#include <gtest/gtest.h>
+#include <mutex>
+#include <random>
+#include <thread>
+
+#include "accesstoken_kit.h"
+#include "logger.h"
+#include "pixel_codec.h"
+#include "plain_text.h"
+#include "system_defined_pixelmap.h"
+#include "token_setproc.h"
+#include "udmf_client.h"
+
+using namespace testing::ext;
+using namespace OHOS::Security::AccessToken;
+using namespace OHOS::UDMF;
+using namespace OHOS;
+
+class UdmfPerfTest : public testing::Test {
+public:
+    static void SetUpTestCase();
+    static void TearDownTestCase();
+    void SetUp() override {}
+    void TearDown() override {}
+    static uint64_t AllocHapToken(const std::string &bundleName);
+
+    static constexpr int USER_ID = 100;
+    static constexpr int INST_INDEX = 0;
+    static constexpr const char *BUNDLE_NAME = "ohos.test.perf";
+};
+
+void UdmfPerfTest::SetUpTestCase()
+{
+    SetSelfTokenID(AllocHapToken(BUNDLE_NAME));
+}
+
+uint64_t UdmfPerfTest::AllocHapToken(const std::string &bundleName)
+{
+    HapInfoParams info = {
+        .userID = USER_ID,
+        .bundleName = bundleName,
+        .instIndex = INST_INDEX,
+        .appIDDesc = bundleName
+    };
+    HapPolicyParams policy = {
+        .apl = APL_NORMAL,
+        .domain = "test.domain",
+        .permStateList = {
+            {
+                .permissionName = "ohos.permission.READ_UDMF_DATA",
+                .isGeneral = true,
+                .resDeviceID = { "local" },
+                .grantStatus = { PermissionState::PERMISSION_GRANTED },
+                .grantFlags = { 1 }
+            }
+        }
+    };
+    return AccessTokenKit::AllocHapToken(info, policy).tokenIDEx;
+}
+
+void UdmfPerfTest::TearDownTestCase()
+{
+    auto tokenId = AccessTokenKit::GetHapTokenID(USER_ID, BUNDLE_NAME, INST_INDEX);
+    AccessTokenKit::DeleteToken(tokenId);
+}
+
+class CountingObserver : public DataObserver {
+public:
+    CountingObserver(std::atomic<int32_t> &pending, std::mutex &mutex, std::condition_variable &cv)
+        : pending_(pending), mutex_(mutex), cv_(cv)
+    {
+    }
+
+    void OnChange(const std::vector<ChangeNotice> &notices) override
+    {
+        calls_++;
+        received_ += static_cast<int32_t>(notices.size());
+        if (pending_.fetch_sub(static_cast<int32_t>(notices.size())) <= static_cast<int32_t>(notices.size())) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            cv_.notify_all();
+        }
+    }
+
+    std::atomic<int32_t> calls_ = 0;
+    std::atomic<int32_t> received_ = 0;
+
+private:
+    std::atomic<int32_t> &pending_;
+    std::mutex &mutex_;
+    std::condition_variable &cv_;
+};
+
+/**
+* @tc.name: SubscribeBenchmark001
+* @tc.desc: Measure the fan-out of notices to many subscribers of one intention
+* @tc.type: PERF
+*/
+HWTEST_F(UdmfPerfTest, SubscribeBenchmark001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "SubscribeBenchmark001 begin.");
+    constexpr int32_t subscriberCount = 128;
+    constexpr int32_t subscriberTokenCount = 4;
+    constexpr int32_t saveCount = 32;
+
+    std::atomic<int32_t> pending = subscriberCount * saveCount;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::vector<std::shared_ptr<CountingObserver>> observers;
+    SubscribeOption subscribeOption = { .intention = Intention::UD_INTENTION_SHARE };
+    // the subscribers are apps other than the producer, which hold nothing but the permission to read udmf data
+    auto producerToken = GetSelfTokenID();
+    std::vector<std::string> subscriberBundles;
+    for (int32_t i = 0; i < subscriberTokenCount; ++i) {
+        subscriberBundles.push_back(std::string(BUNDLE_NAME) + ".subscriber" + std::to_string(i));
+    }
+    for (int32_t i = 0; i < subscriberCount; ++i) {
+        if (i % (subscriberCount / subscriberTokenCount) == 0) {
+            SetSelfTokenID(AllocHapToken(subscriberBundles[i / (subscriberCount / subscriberTokenCount)]));
+        }
+        auto observer = std::make_shared<CountingObserver>(pending, mutex, cv);
+        ASSERT_EQ(UdmfClient::GetInstance().Subscribe(subscribeOption, observer), E_OK);
+        observers.push_back(observer);
+    }
+    SetSelfTokenID(producerToken);
+
+    CustomOption option = { .intention = Intention::UD_INTENTION_SHARE };
+    auto begin = std::chrono::steady_clock::now();
+    for (int32_t i = 0; i < saveCount; ++i) {
+        UnifiedData data;
+        PlainText plainText;
+        plainText.SetContent("content" + std::to_string(i));
+        data.AddRecord(std::make_shared<PlainText>(plainText));
+        std::string key;
+        ASSERT_EQ(UdmfClient::GetInstance().SetData(option, data, key), E_OK);
+    }
+    auto saved = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        cv.wait_for(lock, std::chrono::seconds(10), [&pending]() { return pending.load() <= 0; });
+    }
+    auto delivered = std::chrono::steady_clock::now();
+
+    int32_t calls = 0;
+    for (const auto &observer : observers) {
+        EXPECT_EQ(observer->received_.load(), saveCount);
+        calls += observer->calls_.load();
+        EXPECT_EQ(UdmfClient::GetInstance().Unsubscribe(observer), E_OK);
+    }
+    auto saveTime = std::chrono::duration_cast<std::chrono::microseconds>(saved - begin).count();
+    auto fanOutTime = std::chrono::duration_cast<std::chrono::microseconds>(delivered - begin).count();
+    LOG_INFO(UDMF_TEST, "subscribers: %{public}d, saves: %{public}d, save avg: %{public}lld us, "
+        "all delivered: %{public}lld us, callbacks: %{public}d, notices per callback: %{public}.2f",
+        subscriberCount, saveCount, static_cast<long long>(saveTime / saveCount), static_cast<long long>(fanOutTime),
+        calls, calls == 0 ? 0.0 : static_cast<double>(subscriberCount * saveCount) / calls);
+    for (const auto &bundleName : subscriberBundles) {
+        AccessTokenKit::DeleteToken(AccessTokenKit::GetHapTokenID(USER_ID, bundleName, INST_INDEX));
+    }
+
+    LOG_INFO(UDMF_TEST, "SubscribeBenchmark001 end.");
+}
+
+/**
+* @tc.name: SetBatchDataBenchmark001
+* @tc.desc: Compare saving data with one batch call against saving them one by one
+* @tc.type: PERF
+*/
+HWTEST_F(UdmfPerfTest, SetBatchDataBenchmark001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "SetBatchDataBenchmark001 begin.");
+    constexpr int32_t dataCount = 32;
+    constexpr int32_t rounds = 8;
+
+    CustomOption option = { .intention = Intention::UD_INTENTION_DRAG };
+    auto makeDatas = []() {
+        std::vector<UnifiedData> datas(dataCount);
+        for (int32_t i = 0; i < dataCount; ++i) {
+            PlainText plainText;
+            plainText.SetContent("content" + std::to_string(i));
+            datas[i].AddRecord(std::make_shared<PlainText>(plainText));
+        }
+        return datas;
+    };
+
+    int64_t singleTime = 0;
+    int64_t batchTime = 0;
+    for (int32_t round = 0; round < rounds; ++round) {
+        auto datas = makeDatas();
+        auto begin = std::chrono::steady_clock::now();
+        for (auto &data : datas) {
+            std::string key;
+            ASSERT_EQ(UdmfClient::GetInstance().SetData(option, data, key), E_OK);
+        }
+        auto end = std::chrono::steady_clock::now();
+        singleTime += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+
+        datas = makeDatas();
+        std::vector<std::string> keys;
+        begin = std::chrono::steady_clock::now();
+        ASSERT_EQ(UdmfClient::GetInstance().SetBatchData(option, datas, keys), E_OK);
+        end = std::chrono::steady_clock::now();
+        batchTime += std::chrono::duration_cast<std::chrono::microseconds>(end - begin).count();
+        ASSERT_EQ(keys.size(), static_cast<size_t>(dataCount));
+    }
+    auto throughput = [](int64_t time) {
+        return time == 0 ? 0.0 : static_cast<double>(dataCount * rounds) * 1000000 / time;
+    };
+    LOG_INFO(UDMF_TEST, "data: %{public}d x %{public}d, single calls: %{public}lld us (%{public}.1f/s), "
+        "batch calls: %{public}lld us (%{public}.1f/s)", dataCount, rounds, static_cast<long long>(singleTime),
+        throughput(singleTime), static_cast<long long>(batchTime), throughput(batchTime));
+
+    LOG_INFO(UDMF_TEST, "SetBatchDataBenchmark001 end.");
+}
+// snapshots flushed in the background by the store of the intention and their bytes, by the stats of the service
+static std::pair<int64_t, int64_t> GetFlushStats(const std::string &intention)
+{
+    auto selfToken = GetSelfTokenID();
+    SetSelfTokenID(AccessTokenKit::GetNativeTokenId("msdp_sa"));
+    std::string stats;
+    auto status = UdmfClient::GetInstance().DumpStats(stats);
+    SetSelfTokenID(selfToken);
+    auto line = stats.find("  " + intention + ": data=");
+    if (status != E_OK || line == std::string::npos) {
+        return { 0, 0 };
+    }
+    auto flushes = stats.find(" flushes=", line);
+    auto bytes = stats.find(" flushedBytes=", line);
+    if (flushes == std::string::npos || bytes == std::string::npos) {
+        return { 0, 0 };
+    }
+    return { std::strtoll(stats.c_str() + flushes + strlen(" flushes="), nullptr, 10),
+        std::strtoll(stats.c_str() + bytes + strlen(" flushedBytes="), nullptr, 10) };
+}
+
+/**
+* @tc.name: DurabilityBenchmark001
+* @tc.desc: Measure the write latency of the intentions, whose stores are kept in memory, flushed in the background
+*           and written through to the disk, and the bytes the background flushes write
+* @tc.type: PERF
+*/
+HWTEST_F(UdmfPerfTest, DurabilityBenchmark001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "DurabilityBenchmark001 begin.");
+    constexpr int32_t saveCount = 64;
+    // long enough for a relaxed store to go idle and for the flush timer of the service to find it so
+    constexpr auto flushWait = std::chrono::milliseconds(3000);
+    // drag is memory only, share is relaxed and sys is fully durable; sys and share also keep a history of versions
+    for (auto intention : { UD_INTENTION_DRAG, UD_INTENTION_SHARE, UD_INTENTION_SYS }) {
+        std::string name = UD_INTENTION_MAP.at(intention);
+        auto [flushesBefore, bytesBefore] = GetFlushStats(name);
+        CustomOption option = { .intention = intention };
+        int64_t maxTime = 0;
+        auto begin = std::chrono::steady_clock::now();
+        for (int32_t i = 0; i < saveCount; ++i) {
+            UnifiedData data;
+            PlainText plainText;
+            plainText.SetContent("content" + std::to_string(i));
+            data.AddRecord(std::make_shared<PlainText>(plainText));
+            std::string key;
+            auto saveBegin = std::chrono::steady_clock::now();
+            ASSERT_EQ(UdmfClient::GetInstance().SetData(option, data, key), E_OK);
+            auto saveTime = std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - saveBegin).count();
+            maxTime = std::max<int64_t>(maxTime, saveTime);
+        }
+        auto totalTime = std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        std::this_thread::sleep_for(flushWait);
+        auto [flushesAfter, bytesAfter] = GetFlushStats(name);
+        LOG_INFO(UDMF_TEST, "intention: %{public}s, saves: %{public}d, save avg: %{public}lld us, "
+            "max: %{public}lld us, background flushes: %{public}lld, bytes: %{public}lld", name.c_str(), saveCount,
+            static_cast<long long>(totalTime / saveCount), static_cast<long long>(maxTime),
+            static_cast<long long>(flushesAfter - flushesBefore), static_cast<long long>(bytesAfter - bytesBefore));
+        // only the relaxed store writes snapshots in the background
+        if (intention != UD_INTENTION_SHARE) {
+            EXPECT_EQ(flushesAfter, flushesBefore);
+        }
+    }
+
+    LOG_INFO(UDMF_TEST, "DurabilityBenchmark001 end.");
+}
+
+// a screen of flat cards with rows of glyph-like strokes, anti-aliased at their edges
+static std::vector<uint8_t> MakeScreenshot(int32_t width, int32_t height)
+{
+    constexpr int32_t cardHeight = 160;
+    constexpr int32_t lineHeight = 24;
+    constexpr int32_t margin = 32;
+    std::mt19937 random(width);
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    for (int32_t y = 0; y < height; ++y) {
+        bool card = y % cardHeight > margin / 2;
+        bool text = card && y % lineHeight > lineHeight / 4 && y % lineHeight < lineHeight * 3 / 4;
+        for (int32_t x = 0; x < width; ++x) {
+            uint8_t value = card && x > margin && x < width - margin ? 0xff : 0xf0;
+            if (text && x > margin * 2 && x < width - margin * 2 && (x / 7 + y / lineHeight) % 5 != 0 &&
+                random() % 4 == 0) {
+                value = static_cast<uint8_t>(0x20 + random() % 0x60);
+            }
+            uint8_t *pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+            pixel[0] = value;
+            pixel[1] = value;
+            pixel[2] = card ? value : 0xf8;
+            pixel[3] = 0xff;
+        }
+    }
+    return pixels;
+}
+
+// smooth gradients with sensor noise, as in a camera photo
+static std::vector<uint8_t> MakePhoto(int32_t width, int32_t height)
+{
+    constexpr int32_t noise = 5;
+    std::mt19937 random(height);
+    std::vector<uint8_t> pixels(static_cast<size_t>(width) * height * 4);
+    for (int32_t y = 0; y < height; ++y) {
+        for (int32_t x = 0; x < width; ++x) {
+            uint8_t *pixel = &pixels[(static_cast<size_t>(y) * width + x) * 4];
+            int32_t shade = static_cast<int32_t>(random() % noise) - noise / 2;
+            pixel[0] = static_cast<uint8_t>(std::clamp(x * 255 / width + shade, 0, 255));
+            pixel[1] = static_cast<uint8_t>(std::clamp(y * 255 / height + shade, 0, 255));
+            pixel[2] = static_cast<uint8_t>(std::clamp((x + y) * 127 / (width + height) + 64 + shade, 0, 255));
+            pixel[3] = 0xff;
+        }
+    }
+    return pixels;
+}
+
+/**
+* @tc.name: PixelCodecBenchmark001
+* @tc.desc: Measure the encoding and decoding speed of pixel maps and how much smaller they get
+* @tc.type: PERF
+*/
+HWTEST_F(UdmfPerfTest, PixelCodecBenchmark001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "PixelCodecBenchmark001 begin.");
+    constexpr int32_t width = 1080;
+    constexpr int32_t height = 2340;
+    constexpr int32_t rounds = 5;
+    std::vector<std::pair<const char *, std::vector<uint8_t>>> images = {
+        { "screenshot", MakeScreenshot(width, height) },
+        { "photo", MakePhoto(width, height) },
+    };
+    for (const auto &[name, raw] : images) {
+        std::vector<uint8_t> encoded;
+        std::vector<uint8_t> decoded;
+        int64_t encodeTime = 0;
+        int64_t decodeTime = 0;
+        for (int32_t i = 0; i < rounds; ++i) {
+            auto begin = std::chrono::steady_clock::now();
+            ASSERT_TRUE(PixelCodec::Encode(raw, encoded));
+            auto middle = std::chrono::steady_clock::now();
+            ASSERT_TRUE(PixelCodec::Decode(encoded, decoded));
+            auto end = std::chrono::steady_clock::now();
+            encodeTime += std::chrono::duration_cast<std::chrono::microseconds>(middle - begin).count();
+            decodeTime += std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+        }
+        ASSERT_EQ(decoded, raw);
+        // bytes per microsecond are megabytes per second
+        auto megabytes = static_cast<double>(raw.size()) * rounds;
+        LOG_INFO(UDMF_TEST, "%{public}s: %{public}zu -> %{public}zu bytes (%{public}.1f%%), "
+            "encode %{public}.0f MB/s, decode %{public}.0f MB/s", name, raw.size(), encoded.size(),
+            100.0 * static_cast<double>(encoded.size()) / static_cast<double>(raw.size()),
+            megabytes / static_cast<double>(std::max<int64_t>(encodeTime, 1)),
+            megabytes / static_cast<double>(std::max<int64_t>(decodeTime, 1)));
+        EXPECT_LT(encoded.size(), raw.size());
+    }
+    LOG_INFO(UDMF_TEST, "PixelCodecBenchmark001 end.");
+}
+
+/**
+* @tc.name: WorkerHandoffBenchmark001
+* @tc.desc: Measure handing a large data over to a worker by its native handle, against rebuilding it from copies
+*           of its records as a worker does with a plain object
+* @tc.type: PERF
+*/
+HWTEST_F(UdmfPerfTest, WorkerHandoffBenchmark001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "WorkerHandoffBenchmark001 begin.");
+    constexpr int32_t width = 1080;
+    constexpr int32_t height = 2340;
+    constexpr int32_t textCount = 500;
+    constexpr size_t textSize = 4096;
+    constexpr int32_t rounds = 5;
+    auto data = std::make_shared<UnifiedData>();
+    std::vector<uint8_t> pixels = MakePhoto(width, height);
+    data->AddRecord(std::make_shared<SystemDefinedPixelMap>(pixels));
+    for (int32_t i = 0; i < textCount; ++i) {
+        data->AddRecord(std::make_shared<PlainText>(std::string(textSize, static_cast<char>('a' + i % 26)), ""));
+    }
+    size_t recordCount = data->GetRecords().size();
+    int64_t dataSize = data->GetSize();
+
+    int64_t copyTime = 0;
+    int64_t handleTime = 0;
+    for (int32_t i = 0; i < rounds; ++i) {
+        // the values of the records are read out on the sender and the records built again on the worker
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<uint8_t> rawData;
+        std::vector<std::string> texts;
+        for (const auto &record : data->GetRecords()) {
+            if (record->GetType() == SYSTEM_DEFINED_PIXEL_MAP) {
+                rawData = static_cast<SystemDefinedPixelMap *>(record.get())->GetRawData();
+            } else {
+                texts.push_back(static_cast<PlainText *>(record.get())->GetContent());
+            }
+        }
+        auto rebuilt = std::async(std::launch::async, [rawData = std::move(rawData), texts = std::move(texts)]() {
+            auto copy = std::make_shared<UnifiedData>();
+            std::vector<uint8_t> copiedData = rawData;
+            copy->AddRecord(std::make_shared<SystemDefinedPixelMap>(copiedData));
+            for (const auto &text : texts) {
+                copy->AddRecord(std::make_shared<PlainText>(text, ""));
+            }
+            return copy;
+        });
+        ASSERT_EQ(rebuilt.get()->GetRecords().size(), recordCount);
+        auto middle = std::chrono::steady_clock::now();
+
+        // the handle is detached on the sender and attached on the worker, as the native binding does
+        auto *transferred = new std::shared_ptr<UnifiedData>(data);
+        auto attached = std::async(std::launch::async, [transferred]() {
+            std::shared_ptr<UnifiedData> handle = std::move(*transferred);
+            delete transferred;
+            return handle;
+        });
+        ASSERT_EQ(attached.get()->GetRecords().size(), recordCount);
+        auto end = std::chrono::steady_clock::now();
+        copyTime += std::chrono::duration_cast<std::chrono::microseconds>(middle - begin).count();
+        handleTime += std::chrono::duration_cast<std::chrono::microseconds>(end - middle).count();
+    }
+    LOG_INFO(UDMF_TEST, "%{public}zu records, %{public}" PRId64 " bytes: copy %{public}" PRId64 " us, "
+        "handle %{public}" PRId64 " us", recordCount, dataSize, copyTime / rounds, handleTime / rounds);
+    EXPECT_LT(handleTime, copyTime);
+    LOG_INFO(UDMF_TEST, "WorkerHandoffBenchmark001 end.");
+}
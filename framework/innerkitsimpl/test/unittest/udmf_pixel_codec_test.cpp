@@ -0,0 +1,143 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <algorithm>
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+
+#include "logger.h"
+#include "pixel_codec.h"
+#include "system_defined_pixelmap.h"
+
+using namespace testing::ext;
+using namespace OHOS::UDMF;
+using namespace OHOS;
+
+class UdmfPixelCodecTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() override {}
+    void TearDown() override {}
+
+    // a gradient with noise and a transparent band, with a few bytes past the last whole pixel
+    static std::vector<uint8_t> MakePixels(size_t count, size_t tail)
+    {
+        std::mt19937 random(count);
+        std::vector<uint8_t> pixels;
+        for (size_t i = 0; i < count; ++i) {
+            uint8_t base = static_cast<uint8_t>(i / 64);
+            pixels.push_back(static_cast<uint8_t>(base + random() % 3));
+            pixels.push_back(base);
+            pixels.push_back(static_cast<uint8_t>(i % 256));
+            pixels.push_back(i % 1000 < 100 ? 0 : 0xff);
+        }
+        for (size_t i = 0; i < tail; ++i) {
+            pixels.push_back(static_cast<uint8_t>(i + 1));
+        }
+        return pixels;
+    }
+};
+
+/**
+* @tc.name: Codec001
+* @tc.desc: Encode and decode pixels losslessly, leaving small or incompressible data raw
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfPixelCodecTest, Codec001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Codec001 begin.");
+    for (size_t tail = 0; tail < 4; ++tail) {
+        std::vector<uint8_t> raw = MakePixels(64 * 1024, tail);
+        std::vector<uint8_t> encoded;
+        ASSERT_TRUE(PixelCodec::Encode(raw, encoded));
+        EXPECT_LT(encoded.size(), raw.size());
+        EXPECT_EQ(PixelCodec::GetDecodedSize(encoded), raw.size());
+        std::vector<uint8_t> decoded;
+        ASSERT_TRUE(PixelCodec::Decode(encoded, decoded));
+        EXPECT_EQ(decoded, raw);
+    }
+
+    std::vector<uint8_t> encoded;
+    EXPECT_FALSE(PixelCodec::Encode(std::vector<uint8_t>(PixelCodec::MIN_ENCODE_SIZE - 1), encoded));
+    std::mt19937 random(0);
+    std::vector<uint8_t> noise(PixelCodec::MIN_ENCODE_SIZE * 4);
+    for (auto &byte : noise) {
+        byte = static_cast<uint8_t>(random());
+    }
+    EXPECT_FALSE(PixelCodec::Encode(noise, encoded));
+
+    // distinct pixels of alternating alpha take five bytes each and fill the output up to its limit, then a run of
+    // the last of them adds a byte per 62 pixels past it
+    constexpr size_t pixelCount = 100000;
+    constexpr size_t fullCount = pixelCount * 4 / 5;
+    std::vector<uint8_t> filledRun(pixelCount * 4);
+    for (size_t i = 0; i < pixelCount; ++i) {
+        size_t value = std::min(i, fullCount - 1);
+        filledRun[i * 4] = static_cast<uint8_t>(value);
+        filledRun[i * 4 + 1] = static_cast<uint8_t>(value >> 8);
+        filledRun[i * 4 + 2] = static_cast<uint8_t>(value >> 16);
+        filledRun[i * 4 + 3] = static_cast<uint8_t>(value % 2);
+    }
+    EXPECT_FALSE(PixelCodec::Encode(filledRun, encoded));
+
+    SystemDefinedPixelMap pixelMap;
+    std::vector<uint8_t> raw = MakePixels(16 * 1024, 1);
+    pixelMap.SetRawData(raw);
+    ASSERT_TRUE(pixelMap.Encode(PIXEL_ENCODING_QOI));
+    EXPECT_EQ(pixelMap.GetEncoding(), PIXEL_ENCODING_QOI);
+    EXPECT_LT(pixelMap.GetEncodedData().size(), raw.size());
+    EXPECT_EQ(pixelMap.GetSize(), static_cast<int64_t>(raw.size()));
+    EXPECT_EQ(pixelMap.GetRawData(), raw);
+    ASSERT_TRUE(pixelMap.Encode(PIXEL_ENCODING_RAW));
+    EXPECT_EQ(pixelMap.GetEncodedData(), raw);
+    LOG_INFO(UDMF_TEST, "Codec001 end.");
+}
+
+/**
+* @tc.name: Codec002
+* @tc.desc: Reject encoded data which is truncated, padded or claims more pixels than its ops hold
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfPixelCodecTest, Codec002, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Codec002 begin.");
+    std::vector<uint8_t> encoded;
+    ASSERT_TRUE(PixelCodec::Encode(MakePixels(4 * 1024, 2), encoded));
+    std::vector<uint8_t> decoded;
+
+    std::vector<uint8_t> truncated(encoded.begin(), encoded.end() - 3);
+    EXPECT_FALSE(PixelCodec::Decode(truncated, decoded));
+    std::vector<uint8_t> padded = encoded;
+    padded.push_back(0);
+    EXPECT_FALSE(PixelCodec::Decode(padded, decoded));
+    // a single run op claiming four gigabytes is refused before anything is allocated
+    std::vector<uint8_t> forged = { 0xff, 0xff, 0xff, 0xfc, 0xfd };
+    EXPECT_FALSE(PixelCodec::Decode(forged, decoded));
+    EXPECT_FALSE(PixelCodec::Decode({ 0x00, 0x00 }, decoded));
+    EXPECT_TRUE(decoded.empty());
+    EXPECT_EQ(PixelCodec::GetDecodedSize(forged), static_cast<size_t>(0));
+
+    SystemDefinedPixelMap pixelMap;
+    EXPECT_FALSE(pixelMap.SetEncodedData(encoded, PIXEL_ENCODING_BUTT));
+    // a forged header is refused before it sizes the pixel map
+    EXPECT_FALSE(pixelMap.SetEncodedData(forged, PIXEL_ENCODING_QOI));
+    EXPECT_EQ(pixelMap.GetSize(), 0);
+    ASSERT_TRUE(pixelMap.SetEncodedData(truncated, PIXEL_ENCODING_QOI));
+    EXPECT_TRUE(pixelMap.GetRawData().empty());
+    EXPECT_FALSE(pixelMap.Encode(PIXEL_ENCODING_RAW));
+    LOG_INFO(UDMF_TEST, "Codec002 end.");
+}
@@ -0,0 +1,121 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+#include "logger.h"
+#include "plain_text.h"
+#include "udmf_recorder.h"
+
+using namespace testing::ext;
+using namespace OHOS::UDMF;
+using namespace OHOS;
+
+class UdmfRecorderTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() override {}
+    void TearDown() override
+    {
+        RequestRecorder::GetInstance().Stop();
+        unlink(RECORDING_PATH);
+        unlink(REPLAYED_PATH);
+    }
+
+    static constexpr const char *RECORDING_PATH = "/data/local/tmp/udmf_recorder_test.rec";
+    static constexpr const char *REPLAYED_PATH = "/data/local/tmp/udmf_recorder_test_replayed.rec";
+};
+
+/**
+* @tc.name: Record001
+* @tc.desc: Record requests and load their shapes, with the queried keys referring to the requests returning them
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfRecorderTest, Record001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Record001 begin.");
+    auto &recorder = RequestRecorder::GetInstance();
+    ASSERT_EQ(recorder.Start(RECORDING_PATH), E_OK);
+    UnifiedData unifiedData;
+    unifiedData.AddRecord(std::make_shared<PlainText>("content", "abstract"));
+    unifiedData.AddRecord(std::make_shared<PlainText>("x", ""));
+    recorder.Begin(0);
+    recorder.SetIntention(UD_INTENTION_SYS);
+    recorder.AddData(unifiedData);
+    recorder.SetResult(std::string("udmf://sys/ohos.test.demo1/key1"));
+    recorder.End(E_OK);
+    recorder.Begin(1);
+    recorder.SetQuery("udmf://sys/ohos.test.demo1/key1", -1);
+    recorder.End(E_OK);
+    recorder.Begin(1);
+    recorder.SetQuery("udmf://sys/ohos.test.demo1/unknown", 0);
+    recorder.End(E_DB_ERROR);
+    recorder.Stop();
+    recorder.Begin(1);
+    recorder.End(E_OK);
+
+    std::vector<RecordedRequest> requests;
+    ASSERT_EQ(RequestRecorder::Load(RECORDING_PATH, requests), E_OK);
+    ASSERT_EQ(requests.size(), 3u);
+    EXPECT_EQ(requests[0].intention, UD_INTENTION_SYS);
+    ASSERT_EQ(requests[0].datas.size(), 1u);
+    ASSERT_EQ(requests[0].datas[0].size(), 2u);
+    EXPECT_EQ(requests[0].datas[0][0].first, PLAIN_TEXT);
+    EXPECT_EQ(requests[0].datas[0][0].second, unifiedData.GetRecords()[0]->GetSize());
+    EXPECT_EQ(requests[1].keyRef, 0);
+    EXPECT_EQ(requests[1].keyPos, 0);
+    EXPECT_EQ(requests[1].version, -1);
+    EXPECT_LE(requests[0].offset, requests[1].offset);
+    EXPECT_EQ(requests[2].keyRef, -1);
+    EXPECT_EQ(requests[2].status, E_DB_ERROR);
+
+    ASSERT_EQ(RequestRecorder::Save(REPLAYED_PATH, requests), E_OK);
+    std::vector<RecordedRequest> saved;
+    ASSERT_EQ(RequestRecorder::Load(REPLAYED_PATH, saved), E_OK);
+    ASSERT_EQ(saved.size(), requests.size());
+    for (size_t i = 0; i < saved.size(); ++i) {
+        EXPECT_EQ(RequestRecorder::Format(saved[i]), RequestRecorder::Format(requests[i]));
+    }
+    LOG_INFO(UDMF_TEST, "Record001 end.");
+}
+
+/**
+* @tc.name: Parse001
+* @tc.desc: Parse the lines of a recording, rejecting malformed ones
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfRecorderTest, Parse001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Parse001 begin.");
+    RecordedRequest request;
+    ASSERT_TRUE(RequestRecorder::Parse("8 100 20 0 2 0 -1 0 ;1:7,4:1", request));
+    EXPECT_EQ(request.code, 8u);
+    ASSERT_EQ(request.datas.size(), 2u);
+    EXPECT_TRUE(request.datas[0].empty());
+    ASSERT_EQ(request.datas[1].size(), 2u);
+    EXPECT_EQ(request.datas[1][1].first, HTML);
+    EXPECT_EQ(RequestRecorder::Format(request), "8 100 20 0 2 0 -1 0 ;1:7,4:1");
+    ASSERT_TRUE(RequestRecorder::Parse("1 100 20 0 3 0 0 0 -", request));
+    EXPECT_TRUE(request.datas.empty());
+
+    EXPECT_FALSE(RequestRecorder::Parse("1 100 20", request));
+    EXPECT_FALSE(RequestRecorder::Parse("1 100 20 0 3 0 0 0 1:x", request));
+    EXPECT_FALSE(RequestRecorder::Parse("1 100 20 0 3 0 0 0 1", request));
+    EXPECT_FALSE(RequestRecorder::Parse("1 100 twenty 0 3 0 0 0 -", request));
+    LOG_INFO(UDMF_TEST, "Parse001 end.");
+}
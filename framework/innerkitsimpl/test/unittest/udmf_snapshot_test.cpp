@@ -0,0 +1,111 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <cstdio>
+#include <gtest/gtest.h>
+#include <string>
+#include <unistd.h>
+
+#include "logger.h"
+#include "snapshot.h"
+
+using namespace testing::ext;
+using namespace OHOS::UDMF;
+using namespace OHOS;
+
+class UdmfSnapshotTest : public testing::Test {
+public:
+    static void SetUpTestCase() {}
+    static void TearDownTestCase() {}
+    void SetUp() override {}
+    void TearDown() override
+    {
+        unlink(SNAPSHOT_PATH);
+    }
+
+    static std::vector<DistributedDB::Entry> CreateEntries(int32_t count);
+
+    static constexpr const char *SNAPSHOT_PATH = "/data/local/tmp/udmf_snapshot_test.snap";
+};
+
+std::vector<DistributedDB::Entry> UdmfSnapshotTest::CreateEntries(int32_t count)
+{
+    std::vector<DistributedDB::Entry> entries;
+    for (int32_t i = count - 1; i >= 0; --i) {
+        std::string key = "udmf://sys/ohos.test.demo1/" + std::to_string(i);
+        std::string value(i, 'v');
+        entries.push_back({ { key.begin(), key.end() }, { value.begin(), value.end() } });
+    }
+    return entries;
+}
+
+/**
+* @tc.name: WriteAndRead001
+* @tc.desc: Write entries to a snapshot and read them by index and by key
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfSnapshotTest, WriteAndRead001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "WriteAndRead001 begin.");
+    constexpr int32_t count = 100;
+    ASSERT_EQ(Snapshot::Write(SNAPSHOT_PATH, CreateEntries(count)), E_OK);
+
+    SnapshotReader reader;
+    ASSERT_EQ(reader.Open(SNAPSHOT_PATH), E_OK);
+    ASSERT_EQ(reader.Count(), static_cast<uint32_t>(count));
+    std::string previous;
+    for (uint32_t i = 0; i < reader.Count(); ++i) {
+        SnapshotReader::Slice key;
+        SnapshotReader::Slice value;
+        ASSERT_TRUE(reader.GetEntry(i, key, value));
+        std::string keyStr(reinterpret_cast<const char *>(key.data), key.size);
+        EXPECT_LT(previous, keyStr);
+        previous = keyStr;
+    }
+    for (int32_t i = 0; i < count; ++i) {
+        SnapshotReader::Slice value;
+        ASSERT_TRUE(reader.Find("udmf://sys/ohos.test.demo1/" + std::to_string(i), value));
+        EXPECT_EQ(value.size, static_cast<size_t>(i));
+    }
+    SnapshotReader::Slice value;
+    EXPECT_FALSE(reader.Find("udmf://sys/ohos.test.demo1/", value));
+    EXPECT_FALSE(reader.Find("udmf://sys/ohos.test.demo1/100", value));
+    LOG_INFO(UDMF_TEST, "WriteAndRead001 end.");
+}
+
+/**
+* @tc.name: Open001
+* @tc.desc: Open a missing, a truncated and a corrupted snapshot
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfSnapshotTest, Open001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "Open001 begin.");
+    SnapshotReader reader;
+    EXPECT_NE(reader.Open(SNAPSHOT_PATH), E_OK);
+
+    ASSERT_EQ(Snapshot::Write(SNAPSHOT_PATH, CreateEntries(10)), E_OK);
+    ASSERT_EQ(truncate(SNAPSHOT_PATH, Snapshot::HEADER_SIZE + Snapshot::ITEM_SIZE), 0);
+    EXPECT_NE(reader.Open(SNAPSHOT_PATH), E_OK);
+
+    ASSERT_EQ(Snapshot::Write(SNAPSHOT_PATH, CreateEntries(10)), E_OK);
+    FILE *file = fopen(SNAPSHOT_PATH, "r+b");
+    ASSERT_NE(file, nullptr);
+    fputc('X', file);
+    fclose(file);
+    EXPECT_NE(reader.Open(SNAPSHOT_PATH), E_OK);
+    EXPECT_EQ(reader.Count(), 0u);
+    LOG_INFO(UDMF_TEST, "Open001 end.");
+}
\ No newline at end of file
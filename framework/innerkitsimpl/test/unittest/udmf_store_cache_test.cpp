@@ -0,0 +1,76 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <string>
+#include <sys/stat.h>
+#include <thread>
+#include <vector>
+
+#include "logger.h"
+#include "store_cache.h"
+
+using namespace testing::ext;
+using namespace OHOS::UDMF;
+using namespace OHOS;
+
+class UdmfStoreCacheTest : public testing::Test {
+public:
+    static void SetUpTestCase()
+    {
+        mkdir(STORE_DIR, S_IRWXU);
+        StoreCache().SetBaseDir(STORE_DIR);
+    }
+    static void TearDownTestCase() {}
+    void SetUp() override {}
+    void TearDown() override {}
+
+    static constexpr const char *STORE_DIR = "/data/local/tmp/udmf_store_cache_test";
+};
+
+/**
+* @tc.name: GetStore001
+* @tc.desc: Get the store of an intention from several caches at once, the store is opened once and shared
+* @tc.type: FUNC
+*/
+HWTEST_F(UdmfStoreCacheTest, GetStore001, TestSize.Level1)
+{
+    LOG_INFO(UDMF_TEST, "GetStore001 begin.");
+    std::string intention = UD_INTENTION_MAP.at(UD_INTENTION_SHARE);
+    EXPECT_EQ(StoreCache().GetOpenTime(intention), -1);
+
+    constexpr size_t threadCount = 8;
+    StoreCache caches[2];
+    std::vector<std::shared_ptr<Store>> stores(threadCount);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threadCount; ++i) {
+        threads.emplace_back([&caches, &stores, &intention, i]() {
+            stores[i] = caches[i % 2].GetStore(intention);
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    ASSERT_NE(stores[0], nullptr);
+    for (const auto &store : stores) {
+        EXPECT_EQ(store, stores[0]);
+    }
+    EXPECT_GE(caches[0].GetOpenTime(intention), 0);
+    EXPECT_EQ(caches[1].GetStore(intention), stores[0]);
+
+    EXPECT_EQ(caches[0].GetStore("unknown"), nullptr);
+    EXPECT_EQ(caches[0].GetOpenTime("unknown"), -1);
+    LOG_INFO(UDMF_TEST, "GetStore001 end.");
+}
@@ -161,22 +161,73 @@ napi_status NapiDataUtils::SetValue(napi_env env, const std::vector<std::string>
 }
 
 /* napi_value <-> std::vector<uint8_t> */
+static size_t GetElementSize(napi_typedarray_type type)
+{
+    switch (type) {
+        case napi_int16_array:
+        case napi_uint16_array:
+            return sizeof(uint16_t);
+        case napi_int32_array:
+        case napi_uint32_array:
+        case napi_float32_array:
+            return sizeof(uint32_t);
+        case napi_float64_array:
+        case napi_bigint64_array:
+        case napi_biguint64_array:
+            return sizeof(uint64_t);
+        default:
+            return sizeof(uint8_t);
+    }
+}
+
+napi_status NapiDataUtils::GetBytes(napi_env env, napi_value in, uint8_t *&bytes, size_t &length)
+{
+    bytes = nullptr;
+    length = 0;
+    bool isTypedArray = false;
+    bool isDataView = false;
+    bool isArrayBuffer = false;
+    napi_value buffer = nullptr;
+    size_t offset = 0;
+    napi_status status = napi_ok;
+    if (napi_is_typedarray(env, in, &isTypedArray) == napi_ok && isTypedArray) {
+        napi_typedarray_type type = napi_uint8_array;
+        size_t count = 0;
+        void *data = nullptr;
+        status = napi_get_typedarray_info(env, in, &type, &count, &data, &buffer, &offset);
+        length = count * GetElementSize(type);
+    } else if (napi_is_dataview(env, in, &isDataView) == napi_ok && isDataView) {
+        void *data = nullptr;
+        status = napi_get_dataview_info(env, in, &length, &data, &buffer, &offset);
+    } else if (napi_is_arraybuffer(env, in, &isArrayBuffer) == napi_ok && isArrayBuffer) {
+        buffer = in;
+    } else {
+        LOG_ERROR(UDMF_KITS_NAPI, "not an ArrayBuffer, a typed array or a DataView!");
+        return napi_invalid_arg;
+    }
+    LOG_ERROR_RETURN(status == napi_ok, "get view info failed!", napi_invalid_arg);
+    // the view is located in its buffer by its byte offset, a subarray does not start at the start of the buffer
+    void *data = nullptr;
+    size_t capacity = 0;
+    status = napi_get_arraybuffer_info(env, buffer, &data, &capacity);
+    LOG_ERROR_RETURN(status == napi_ok && data != nullptr, "get array buffer info failed!", napi_invalid_arg);
+    length = isArrayBuffer ? capacity : length;
+    LOG_ERROR_RETURN(offset <= capacity && length <= capacity - offset, "view out of its buffer!", napi_invalid_arg);
+    bytes = static_cast<uint8_t *>(data) + offset;
+    LOG_DEBUG(UDMF_KITS_NAPI, "byte view offset=%{public}zu length=%{public}zu", offset, length);
+    return napi_ok;
+}
+
 napi_status NapiDataUtils::GetValue(napi_env env, napi_value in, std::vector<uint8_t> &out)
 {
     out.clear();
     LOG_DEBUG(UDMF_KITS_NAPI, "napi_value -> std::vector<uint8_t> ");
-    napi_typedarray_type type = napi_biguint64_array;
+    uint8_t *bytes = nullptr;
     size_t length = 0;
-    napi_value buffer = nullptr;
-    size_t offset = 0;
-    void *data = nullptr;
-    napi_status status = napi_get_typedarray_info(env, in, &type, &length, &data, &buffer, &offset);
-    LOG_DEBUG(UDMF_KITS_NAPI, "array type=%{public}d length=%{public}d offset=%{public}d  status=%{public}d",
-        (int)type, (int)length, (int)offset, status);
-    LOG_ERROR_RETURN(status == napi_ok, "napi_get_typedarray_info failed!", napi_invalid_arg);
-    LOG_ERROR_RETURN(type == napi_uint8_array, "is not Uint8Array!", napi_invalid_arg);
-    LOG_ERROR_RETURN((length > 0) && (data != nullptr), "invalid data!", napi_invalid_arg);
-    out.assign(reinterpret_cast<uint8_t *>(data), reinterpret_cast<uint8_t *>(data) + length);
+    napi_status status = GetBytes(env, in, bytes, length);
+    LOG_ERROR_RETURN(status == napi_ok, "invalid byte view!", status);
+    LOG_ERROR_RETURN(length > 0, "invalid data!", napi_invalid_arg);
+    out.assign(bytes, bytes + length);
     return status;
 }
 
@@ -288,7 +339,7 @@ napi_status NapiDataUtils::GetValue(napi_env env, napi_value in, UDVariant &out)
         case napi_object: {
             std::vector<uint8_t> vct;
             status = GetValue(env, in, vct);
-            out = vct;
+            out = std::move(vct);
             break;
         }
         default:
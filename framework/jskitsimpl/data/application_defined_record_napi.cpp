@@ -134,7 +134,7 @@ napi_value ApplicationDefinedRecordNapi::SetRawData(napi_env env, napi_callback_
     auto record = reinterpret_cast<ApplicationDefinedRecordNapi *>(ctxt->native);
     ASSERT_ERR(
         ctxt->env, (record != nullptr && record->value_ != nullptr), Status::E_INVALID_PARAMETERS, "invalid object!");
-    record->value_->SetRawData(rawData);
+    record->value_->SetRawData(std::move(rawData));
     return nullptr;
 }
 } // namespace UDMF
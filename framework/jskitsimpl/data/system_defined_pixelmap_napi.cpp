@@ -105,7 +105,7 @@ napi_value SystemDefinedPixelMapNapi::SetRawData(napi_env env, napi_callback_inf
     auto sdPixelMap = reinterpret_cast<SystemDefinedPixelMapNapi *>(ctxt->native);
     ASSERT_ERR(ctxt->env, (sdPixelMap != nullptr && sdPixelMap->value_ != nullptr), Status::E_INVALID_PARAMETERS,
         "invalid object!");
-    sdPixelMap->value_->SetRawData(pixelMap);
+    sdPixelMap->value_->SetRawData(std::move(pixelMap));
     return nullptr;
 }
 } // namespace UDMF
@@ -73,8 +73,10 @@ napi_value UnifiedDataNapi::New(napi_env env, napi_callback_info info)
     uData->value_ = std::make_shared<UnifiedData>();
     if (uRecord) {
         uData->value_->AddRecord(uRecord->value_);
+        uData->recordsShared_ = true;
     }
     ASSERT_CALL(env, napi_wrap(env, ctxt->self, uData, Destructor, nullptr, nullptr), uData);
+    BindTransfer(env, ctxt->self, uData);
     return ctxt->self;
 }
 
@@ -89,10 +91,55 @@ void UnifiedDataNapi::Destructor(napi_env env, void *data, void *hint)
 void UnifiedDataNapi::NewInstance(napi_env env, std::shared_ptr<UnifiedData> in, napi_value &out)
 {
     ASSERT_CALL_VOID(env, napi_new_instance(env, Constructor(env), 0, nullptr, &out));
-    auto *unifiedData = new (std::nothrow) UnifiedDataNapi();
-    ASSERT_ERR_VOID(env, unifiedData != nullptr, Status::E_FORBIDDEN, "no memory for unified data!");
+    // the object is wrapped and bound for transfer by New, so it is the data of that native object which is set
+    UnifiedDataNapi *unifiedData = nullptr;
+    ASSERT_CALL_VOID(env, napi_unwrap(env, out, reinterpret_cast<void **>(&unifiedData)));
+    ASSERT_ERR_VOID(env, unifiedData != nullptr, Status::E_ERROR, "unwrap unified data failed!");
     unifiedData->value_ = in;
-    ASSERT_CALL_DELETE(env, napi_wrap(env, out, unifiedData, Destructor, nullptr, nullptr), unifiedData);
+}
+
+void UnifiedDataNapi::BindTransfer(napi_env env, napi_value object, UnifiedDataNapi *data)
+{
+    napi_status status = napi_coerce_to_native_binding_object(env, object, Detach, Attach, data, nullptr);
+    if (status != napi_ok) {
+        // the object is still usable, it is just copied like a plain object when posted
+        LOG_WARN(UDMF_KITS_NAPI, "Bind transfer failed, status: %{public}d.", status);
+    }
+}
+
+void *UnifiedDataNapi::Detach(napi_env env, void *value, void *hint)
+{
+    // called on the thread of the sender while the message is serialized. The data is moved out rather than
+    // shared, so the two threads never change it at once, and the object left behind reads as invalid. A data
+    // whose records are held by record objects of the sender is refused, those objects would still change them
+    auto *uData = reinterpret_cast<UnifiedDataNapi *>(value);
+    if (uData == nullptr || uData->value_ == nullptr) {
+        LOG_ERROR(UDMF_KITS_NAPI, "Detach a unified data already transferred.");
+        return nullptr;
+    }
+    if (uData->recordsShared_) {
+        LOG_ERROR(UDMF_KITS_NAPI, "Detach a unified data whose records are held by the sender.");
+        return nullptr;
+    }
+    auto *transferred = new (std::nothrow) std::shared_ptr<UnifiedData>(std::move(uData->value_));
+    if (transferred == nullptr) {
+        LOG_ERROR(UDMF_KITS_NAPI, "No memory to transfer unified data.");
+    }
+    return transferred;
+}
+
+napi_value UnifiedDataNapi::Attach(napi_env env, void *value, void *hint)
+{
+    // called on the thread of the receiver, which wraps the records and raw data as they are
+    auto *transferred = reinterpret_cast<std::shared_ptr<UnifiedData> *>(value);
+    if (transferred == nullptr) {
+        return nullptr;
+    }
+    std::shared_ptr<UnifiedData> data = std::move(*transferred);
+    delete transferred;
+    napi_value out = nullptr;
+    NewInstance(env, data, out);
+    return out;
 }
 
 UnifiedDataNapi *UnifiedDataNapi::GetUnifiedData(napi_env env, napi_callback_info info)
@@ -133,6 +180,7 @@ napi_value UnifiedDataNapi::GetRecords(napi_env env, napi_callback_info info)
     ASSERT_ERR(
         ctxt->env, (uData != nullptr && uData->value_ != nullptr), Status::E_INVALID_PARAMETERS, "invalid object!");
     std::vector<std::shared_ptr<UnifiedRecord>> records = uData->value_->GetRecords();
+    uData->recordsShared_ = true;
     napi_status status = napi_create_array_with_length(env, records.size(), &ctxt->output);
     ASSERT_ERR(ctxt->env, status == napi_ok, Status::E_ERROR, "init array failed!");
     int index = 0;
@@ -18,16 +18,32 @@
 #include "lifecycle/lifecycle_manager.h"
 #include "logger.h"
 #include "preprocess_utils.h"
+#include "subscriber_manager.h"
 #include "checker_manager.h"
 #include "file.h"
+#include "file_size_resolver.h"
+#include "folder_utils.h"
+#include "pixel_codec.h"
+#include "system_defined_pixelmap.h"
+#include "udmf_memory.h"
+#include "udmf_tracer.h"
 #include "uri_permission_manager.h"
 
 namespace OHOS {
 namespace UDMF {
 const std::string MSDP_PROCESS_NAME = "msdp_sa";
-DataManager::DataManager()
+const std::string UNIFIED_KEY_SCHEMA = "udmf://";
+const std::string CONTENT_VALIDATOR_PREFIX = "sha256:";
+DataManager::DataManager() : executorPool_(std::make_shared<ExecutorPool>(2, 1)),
+    payloadPool_(std::make_shared<ExecutorPool>(PAYLOAD_WRITERS, 1))
 {
     authorizationMap_[UD_INTENTION_MAP.at(UD_INTENTION_DRAG)] = MSDP_PROCESS_NAME;
+    historyMap_[UD_INTENTION_MAP.at(UD_INTENTION_SYS)] = MAX_HISTORY_VERSIONS;
+    historyMap_[UD_INTENTION_MAP.at(UD_INTENTION_SHARE)] = MAX_HISTORY_VERSIONS;
+    preGrantIntentions_.insert(UD_INTENTION_MAP.at(UD_INTENTION_DRAG));
+    // drag is kept in memory only, so there is nothing on the disk to read in ahead of its first request
+    warmIntentions_ = { UD_INTENTION_SHARE };
+    executorPool_->Schedule([this]() { storeCache_.Flush(); }, StoreCache::FLUSH_INTERVAL);
     CheckerManager::GetInstance().LoadCheckers();
 }
 
@@ -43,6 +59,7 @@ DataManager &DataManager::GetInstance()
 
 int32_t DataManager::SaveData(CustomOption &option, UnifiedData &unifiedData, std::string &key)
 {
+    UDMF_TRACE_SPAN("manager.SaveData");
     if (unifiedData.GetRecords().empty()) {
         LOG_ERROR(UDMF_FRAMEWORK, "Invalid parameters, have no record");
         return E_INVALID_PARAMETERS;
@@ -62,6 +79,7 @@ int32_t DataManager::SaveData(CustomOption &option, UnifiedData &unifiedData, st
     for (const auto &record : unifiedData.GetRecords()) {
         record->SetUid(PreProcessUtils::GetInstance().IdGenerator());
     }
+    ResolveFileSizes(unifiedData.GetRecords(), unifiedData.GetRuntime()->createPackage, option.tokenId);
 
     std::string intention = unifiedData.GetRuntime()->key.intention;
     auto store = storeCache_.GetStore(intention);
@@ -70,21 +88,300 @@ int32_t DataManager::SaveData(CustomOption &option, UnifiedData &unifiedData, st
         return E_DB_ERROR;
     }
 
+    auto history = historyMap_.find(intention);
+    if (history != historyMap_.end()) {
+        if (store->PutVersion(unifiedData, history->second) != E_OK) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Put version failed, intention: %{public}s.", intention.c_str());
+            return E_DB_ERROR;
+        }
+        key = unifiedData.GetRuntime()->key.GetUnifiedKey();
+        SubscriberManager::GetInstance().Notify(option.intention, key, unifiedData);
+        return E_OK;
+    }
+
+    // the data of the intention is replaced as a whole, by one save at a time, so no record is written into the
+    // store between the wait for the pending ones and the clearing
+    auto replaceMutex = GetReplaceMutex(intention);
+    std::lock_guard<std::mutex> lock(*replaceMutex);
+    int32_t res = WaitPayloads(intention);
+    if (res != E_OK) {
+        return res;
+    }
+    // the data replaced was never read, the grants made for it are taken back
+    RevokeGrants(intention);
     if (store->Clear() != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Clear store failed, intention: %{public}s.", intention.c_str());
         return E_DB_ERROR;
     }
 
-    if (store->Put(unifiedData) != E_OK) {
+    if (unifiedData.GetSize() > PROGRESSIVE_SAVE_SIZE) {
+        res = SaveProgressively(store, unifiedData);
+        if (res != E_OK) {
+            return res;
+        }
+    } else if (store->Put(unifiedData) != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Put unified data failed, intention: %{public}s.", intention.c_str());
         return E_DB_ERROR;
     }
     key = unifiedData.GetRuntime()->key.GetUnifiedKey();
+    SubscriberManager::GetInstance().Notify(option.intention, key, unifiedData);
+    return E_OK;
+}
+
+int32_t DataManager::SaveBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+    std::vector<std::string> &keys)
+{
+    UDMF_TRACE_SPAN("manager.SaveBatchData");
+    if (unifiedDatas.empty() || unifiedDatas.size() > MAX_BATCH_DATA_COUNT) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid parameters, data count: %{public}zu", unifiedDatas.size());
+        return E_INVALID_PARAMETERS;
+    }
+    if (!UnifiedDataUtils::IsValidIntention(option.intention)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid parameters intention: %{public}d.", option.intention);
+        return E_INVALID_PARAMETERS;
+    }
+
+    // all the data are imputed before any of them is written, so an invalid one fails the batch as a whole
+    PreProcessUtils utils = PreProcessUtils::GetInstance();
+    for (auto &unifiedData : unifiedDatas) {
+        if (unifiedData.GetRecords().empty()) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Invalid parameters, have no record");
+            return E_INVALID_PARAMETERS;
+        }
+        if (!utils.RuntimeDataImputation(unifiedData, option)) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Imputation failed, %{public}s", utils.errorStr.c_str());
+            return E_UNKNOWN;
+        }
+        for (const auto &record : unifiedData.GetRecords()) {
+            record->SetUid(utils.IdGenerator());
+        }
+    }
+    // the files of all the data are looked up together, within one time budget
+    std::vector<std::shared_ptr<UnifiedRecord>> records;
+    for (const auto &unifiedData : unifiedDatas) {
+        auto dataRecords = unifiedData.GetRecords();
+        records.insert(records.end(), dataRecords.begin(), dataRecords.end());
+    }
+    ResolveFileSizes(records, unifiedDatas.front().GetRuntime()->createPackage, option.tokenId);
+
+    std::string intention = UD_INTENTION_MAP.at(option.intention);
+    auto store = storeCache_.GetStore(intention);
+    if (store == nullptr) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get store failed, intention: %{public}s.", intention.c_str());
+        return E_DB_ERROR;
+    }
+
+    auto history = historyMap_.find(intention);
+    if (history != historyMap_.end()) {
+        // each data turns into a version of the bundle, the oldest versions are evicted along the way
+        for (const auto &unifiedData : unifiedDatas) {
+            if (store->PutVersion(unifiedData, history->second) != E_OK) {
+                LOG_ERROR(UDMF_FRAMEWORK, "Put version failed, intention: %{public}s.", intention.c_str());
+                return E_DB_ERROR;
+            }
+        }
+    } else {
+        auto replaceMutex = GetReplaceMutex(intention);
+        std::lock_guard<std::mutex> lock(*replaceMutex);
+        int32_t res = WaitPayloads(intention);
+        if (res != E_OK) {
+            return res;
+        }
+        RevokeGrants(intention);
+        if (store->Clear() != E_OK) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Clear store failed, intention: %{public}s.", intention.c_str());
+            return E_DB_ERROR;
+        }
+        if (store->PutBatch(unifiedDatas) != E_OK) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Put batch data failed, intention: %{public}s.", intention.c_str());
+            return E_DB_ERROR;
+        }
+    }
+    keys.clear();
+    for (const auto &unifiedData : unifiedDatas) {
+        keys.push_back(unifiedData.GetRuntime()->key.GetUnifiedKey());
+        SubscriberManager::GetInstance().Notify(option.intention, keys.back(), unifiedData);
+    }
     return E_OK;
 }
 
+int32_t DataManager::SaveProgressively(std::shared_ptr<Store> store, const UnifiedData &unifiedData)
+{
+    std::string key = unifiedData.GetRuntime()->key.GetUnifiedKey();
+    std::string intention = unifiedData.GetRuntime()->key.intention;
+    if (store->PutRuntime(unifiedData) != E_OK) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Put runtime failed, intention: %{public}s.", intention.c_str());
+        return E_DB_ERROR;
+    }
+    // the key and the summary are visible from now on, readers of the records wait for the task below
+    auto promise = std::make_shared<std::promise<int32_t>>();
+    auto payload = promise->get_future().share();
+    pendingPayloads_.InsertOrAssign(key, payload);
+    auto data = std::make_shared<UnifiedData>(unifiedData);
+    // the copy of the records is held by the task until it is written
+    auto charge = std::make_shared<MemoryCharge>(MEMORY_DECODED_RECORD, data->GetSize());
+    uint64_t requestId = Tracer::GetRequestId();
+    auto task = [this, store, data, charge, promise, key, intention, requestId]() {
+        TraceRequest request(requestId);
+        UDMF_TRACE_SPAN("manager.SaveRecords");
+        int32_t res = store->PutRecords(*data);
+        if (res != E_OK) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Put records failed, intention: %{public}s.", intention.c_str());
+            store->Delete(key);
+        }
+        promise->set_value(res);
+        pendingPayloads_.Erase(key);
+    };
+    if (payloadPool_->Execute(task) == ExecutorPool::INVALID_TASK_ID) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Execute put records task failed, write them synchronously.");
+        task();
+        return payload.get() == E_OK ? E_OK : E_DB_ERROR;
+    }
+    return E_OK;
+}
+
+void DataManager::ResolveFileSizes(const std::vector<std::shared_ptr<UnifiedRecord>> &records,
+    const std::string &bundleName, int32_t tokenId)
+{
+    int32_t userId = 0;
+    PreProcessUtils utils = PreProcessUtils::GetInstance();
+    // a native caller has no sandbox, the sizes in its records are only dropped
+    bool isHap = utils.GetHapUserIdByToken(tokenId, userId);
+    FileSizeResolver::GetInstance().Resolve(records, isHap ? bundleName : "", userId);
+}
+
+int32_t DataManager::WaitPayload(const std::string &key)
+{
+    auto [found, payload] = pendingPayloads_.Find(key);
+    if (!found) {
+        return E_OK;
+    }
+    if (payload.wait_for(PAYLOAD_WAIT_TIME) != std::future_status::ready) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Wait records timeout, key: %{public}s.", key.c_str());
+        return E_TIMEOUT;
+    }
+    return payload.get() == E_OK ? E_OK : E_DB_ERROR;
+}
+
+int32_t DataManager::WaitPayloads(const std::string &intention)
+{
+    std::string prefix = UNIFIED_KEY_SCHEMA + intention + "/";
+    std::vector<std::shared_future<int32_t>> payloads;
+    pendingPayloads_.ForEach([&prefix, &payloads](const std::string &key, std::shared_future<int32_t> &payload) {
+        if (key.compare(0, prefix.size(), prefix) == 0) {
+            payloads.push_back(payload);
+        }
+        return false;
+    });
+    // the records of all of them share one deadline, a save is never held up longer than a read would be
+    auto deadline = std::chrono::steady_clock::now() + PAYLOAD_WAIT_TIME;
+    for (const auto &payload : payloads) {
+        if (payload.wait_until(deadline) != std::future_status::ready) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Wait records timeout, intention: %{public}s.", intention.c_str());
+            return E_TIMEOUT;
+        }
+    }
+    return E_OK;
+}
+
+std::shared_ptr<std::mutex> DataManager::GetReplaceMutex(const std::string &intention)
+{
+    std::shared_ptr<std::mutex> mutex;
+    replaceMutexes_.Compute(intention, [&mutex](const std::string &, std::shared_ptr<std::mutex> &value) {
+        if (value == nullptr) {
+            value = std::make_shared<std::mutex>();
+        }
+        mutex = value;
+        return true;
+    });
+    return mutex;
+}
+
+int32_t DataManager::AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    return UpdateRecord(query, record, false);
+}
+
+int32_t DataManager::ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    return UpdateRecord(query, record, true);
+}
+
+int32_t DataManager::UpdateRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record, bool replace)
+{
+    UDMF_TRACE_SPAN("manager.UpdateRecord");
+    UnifiedKey key(query.key);
+    if (!key.IsValid() || record == nullptr) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid parameters, key: %{public}s.", query.key.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+    auto store = storeCache_.GetStore(key.intention);
+    if (store == nullptr) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get store failed, intention: %{public}s.", key.intention.c_str());
+        return E_DB_ERROR;
+    }
+    int32_t res = WaitPayload(query.key);
+    if (res != E_OK) {
+        return res;
+    }
+    Runtime runtime;
+    if (!store->GetRuntime(query.key, runtime)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get runtime failed, key: %{public}s.", query.key.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+    // the first privilege is the one of the producer, the only one changing its data
+    if (runtime.privileges.empty() || runtime.privileges.front().tokenId != query.tokenId) {
+        LOG_ERROR(UDMF_FRAMEWORK, "No permission to update, key: %{public}s.", query.key.c_str());
+        return E_NO_PERMISSION;
+    }
+    ResolveFileSizes({ record }, runtime.createPackage, query.tokenId);
+    PreProcessUtils utils = PreProcessUtils::GetInstance();
+    Summary summary;
+    if (replace) {
+        res = store->ReplaceRecord(query.key, record, utils.GetTimeStamp(), summary);
+    } else {
+        record->SetUid(utils.IdGenerator());
+        res = store->AppendRecord(query.key, record, utils.GetTimeStamp(), summary);
+    }
+    if (res != E_OK) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Update record failed, intention: %{public}s.", key.intention.c_str());
+        return res;
+    }
+    auto intention = std::find_if(UD_INTENTION_MAP.begin(), UD_INTENTION_MAP.end(),
+        [&key](const auto &item) { return item.second == key.intention; });
+    if (intention != UD_INTENTION_MAP.end()) {
+        SubscriberManager::GetInstance().Notify(static_cast<Intention>(intention->first), query.key, summary);
+    }
+    return E_OK;
+}
+
+int32_t DataManager::GetDataKey(std::shared_ptr<Store> store, const QueryOption &query, std::string &dataKey)
+{
+    if (query.version == 0) {
+        dataKey = query.key;
+        return E_OK;
+    }
+    if (store->GetVersionKey(query.key, query.version, dataKey) != E_OK) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get key of version %{public}d failed.", query.version);
+        return E_DB_ERROR;
+    }
+    return E_OK;
+}
+
+std::string DataManager::GetValidator(std::shared_ptr<Store> store, const QueryOption &query,
+    const std::string &dataKey, const Runtime &runtime)
+{
+    if (query.validatorType == CONTENT_VALIDATOR) {
+        std::string digest;
+        return store->GetDigest(dataKey, digest) ? CONTENT_VALIDATOR_PREFIX + digest : "";
+    }
+    // a key is never reused, and data changed in place gets a new version or modification time
+    return dataKey + "#" + std::to_string(runtime.dataVersion) + "#" + std::to_string(runtime.lastModifiedTime);
+}
+
 int32_t DataManager::RetrieveData(QueryOption &query, UnifiedData &unifiedData)
 {
+    UDMF_TRACE_SPAN("manager.RetrieveData");
     UnifiedKey key(query.key);
     if (!key.IsValid()) {
         LOG_ERROR(UDMF_FRAMEWORK, "Unified key: %{public}s is invalid.", query.key.c_str());
@@ -95,7 +392,31 @@ int32_t DataManager::RetrieveData(QueryOption &query, UnifiedData &unifiedData)
         LOG_ERROR(UDMF_FRAMEWORK, "Get store failed, intention: %{public}s.", key.intention.c_str());
         return E_DB_ERROR;
     }
-    int32_t res = store->Get(query.key, unifiedData);
+    std::string dataKey;
+    int32_t res = GetDataKey(store, query, dataKey);
+    if (res != E_OK || dataKey.empty()) {
+        query.validator.clear();
+        return res;
+    }
+    key = UnifiedKey(dataKey);
+    if (!key.IsValid()) {
+        return E_INVALID_PARAMETERS;
+    }
+    res = WaitPayload(dataKey);
+    if (res != E_OK) {
+        return res;
+    }
+    CheckerManager::CheckInfo info;
+    info.tokenId = query.tokenId;
+    info.pid = query.pid;
+    // the runtime info is enough to tell whether the caller holds the data already, the records are not read then
+    Runtime current;
+    if (!query.validator.empty() && store->GetRuntime(dataKey, current) &&
+        query.validator == GetValidator(store, query, dataKey, current)) {
+        return CheckPrivilege(current.privileges, info) ? E_NOT_MODIFIED : E_INVALID_OPERATION;
+    }
+    query.validator.clear();
+    res = store->Get(dataKey, unifiedData);
     if (res != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Get data from store failed, intention: %{public}s.", key.intention.c_str());
         return res;
@@ -104,39 +425,62 @@ int32_t DataManager::RetrieveData(QueryOption &query, UnifiedData &unifiedData)
         return E_OK;
     }
     std::shared_ptr<Runtime> runtime = unifiedData.GetRuntime();
-    CheckerManager::CheckInfo info;
-    info.tokenId = query.tokenId;
-    info.pid = query.pid;
-    if (!CheckerManager::GetInstance().IsValid(runtime->privileges, info)) {
+    if (!CheckPrivilege(runtime->privileges, info)) {
         return E_INVALID_OPERATION;
     }
+    query.validator = GetValidator(store, query, dataKey, *runtime);
+    DecodePixelMaps(unifiedData, query.encodings);
     std::string bundleName;
-    if (!PreProcessUtils::GetInstance().GetHapBundleNameByToken(query.tokenId, bundleName)) {
+    if (!GetBundleName(query.tokenId, bundleName)) {
         return E_ERROR;
     }
     if (runtime->createPackage != bundleName) {
-        auto records = unifiedData.GetRecords();
-        for (auto record : records) {
-            auto type = record->GetType();
-            std::string uri = "";
-            if (type == UDType::FILE || type == UDType::IMAGE || type == UDType::VIDEO || type == UDType::FOLDER) {
-                auto file = static_cast<File *>(record.get());
-                uri = file->GetUri();
-            }
-            if (!uri.empty() && (UriPermissionManager::GetInstance().GrantUriPermission(uri, bundleName) != E_OK)) {
-                return E_ERROR;
-            }
+        res = GrantUris(dataKey, unifiedData, bundleName);
+        if (res != E_OK) {
+            return res;
         }
     }
-    if (LifeCycleManager::GetInstance().DeleteOnGet(key) != E_OK) {
+    if (DeleteOnGet(key) != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Remove data failed, intention: %{public}s.", key.intention.c_str());
         return E_DB_ERROR;
     }
     return E_OK;
 }
 
+void DataManager::DecodePixelMaps(UnifiedData &unifiedData, uint32_t encodings)
+{
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr || record->GetType() != SYSTEM_DEFINED_PIXEL_MAP) {
+            continue;
+        }
+        auto pixelMap = static_cast<SystemDefinedPixelMap *>(record.get());
+        if (!PixelCodec::IsDecodable(encodings, pixelMap->GetEncoding())) {
+            pixelMap->Encode(PIXEL_ENCODING_RAW);
+        }
+    }
+}
+
+bool DataManager::CheckPrivilege(std::vector<Privilege> &privileges, const CheckerManager::CheckInfo &info)
+{
+    UDMF_TRACE_SPAN("manager.CheckPrivilege");
+    return CheckerManager::GetInstance().IsValid(privileges, info);
+}
+
+bool DataManager::GetBundleName(int32_t tokenId, std::string &bundleName)
+{
+    UDMF_TRACE_SPAN("manager.TokenLookup");
+    return PreProcessUtils::GetInstance().GetHapBundleNameByToken(tokenId, bundleName);
+}
+
+Status DataManager::DeleteOnGet(const UnifiedKey &key)
+{
+    UDMF_TRACE_SPAN("manager.DeleteOnGet");
+    return LifeCycleManager::GetInstance().DeleteOnGet(key);
+}
+
 int32_t DataManager::GetSummary(QueryOption &query, Summary &summary)
 {
+    UDMF_TRACE_SPAN("manager.GetSummary");
     UnifiedKey key(query.key);
     if (!key.IsValid()) {
         LOG_ERROR(UDMF_FRAMEWORK, "Unified key: %{public}s is invalid.", query.key.c_str());
@@ -149,15 +493,216 @@ int32_t DataManager::GetSummary(QueryOption &query, Summary &summary)
         return E_DB_ERROR;
     }
 
-    if (store->GetSummary(query.key, summary) != E_OK) {
+    std::string dataKey;
+    int32_t res = GetDataKey(store, query, dataKey);
+    if (res != E_OK || dataKey.empty()) {
+        query.validator.clear();
+        return res;
+    }
+    Runtime runtime;
+    if (!store->GetRuntime(dataKey, runtime)) {
+        query.validator.clear();
+    } else {
+        std::string validator = GetValidator(store, query, dataKey, runtime);
+        if (!validator.empty() && query.validator == validator) {
+            return E_NOT_MODIFIED;
+        }
+        query.validator = validator;
+    }
+    if (ReadSummary(store, dataKey, query.validator, summary) != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Store get summary failed, intention: %{public}s.", key.intention.c_str());
         return E_DB_ERROR;
     }
     return E_OK;
 }
 
+Status DataManager::ReadSummary(std::shared_ptr<Store> store, const std::string &dataKey,
+    const std::string &validator, Summary &summary)
+{
+    // a read is only shared by the requests of the same validator: each of them took its validator before the read
+    // started, so the summary is never older than the validator returned along with it
+    std::string readKey = dataKey + "#" + validator;
+    std::shared_ptr<std::promise<std::pair<Status, Summary>>> promise;
+    std::shared_future<std::pair<Status, Summary>> read;
+    summaryReads_.Compute(readKey, [&promise, &read](const std::string &, auto &current) {
+        if (!current.valid()) {
+            promise = std::make_shared<std::promise<std::pair<Status, Summary>>>();
+            current = promise->get_future().share();
+        }
+        read = current;
+        return true;
+    });
+    if (promise == nullptr) {
+        UDMF_TRACE_SPAN("manager.JoinSummary");
+        const auto &[status, result] = read.get();
+        summary = result;
+        return status;
+    }
+    Status status = store->GetSummary(dataKey, summary);
+    // removed before the result is set, a request coming after that reads the store again and sees any change
+    summaryReads_.Erase(readKey);
+    promise->set_value({ status, summary });
+    return status;
+}
+
+int32_t DataManager::GetPreview(QueryOption &query, Preview &preview)
+{
+    UDMF_TRACE_SPAN("manager.GetPreview");
+    UnifiedKey key(query.key);
+    if (!key.IsValid()) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Unified key: %{public}s is invalid.", query.key.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+
+    auto store = storeCache_.GetStore(key.intention);
+    if (store == nullptr) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get store failed, intention: %{public}s.", key.intention.c_str());
+        return E_DB_ERROR;
+    }
+
+    std::string dataKey;
+    int32_t res = GetDataKey(store, query, dataKey);
+    if (res != E_OK || dataKey.empty()) {
+        query.validator.clear();
+        return res;
+    }
+    // the preview shows the content of the data, so it is given to the callers who may read the data only
+    Runtime runtime;
+    if (!store->GetRuntime(dataKey, runtime)) {
+        query.validator.clear();
+        return E_OK;
+    }
+    CheckerManager::CheckInfo info;
+    info.tokenId = query.tokenId;
+    info.pid = query.pid;
+    if (!CheckPrivilege(runtime.privileges, info)) {
+        return E_INVALID_OPERATION;
+    }
+    std::string validator = GetValidator(store, query, dataKey, runtime);
+    if (!validator.empty() && query.validator == validator) {
+        return E_NOT_MODIFIED;
+    }
+    query.validator = validator;
+    if (store->GetPreview(dataKey, preview) != E_OK) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Store get preview failed, intention: %{public}s.", key.intention.c_str());
+        return E_DB_ERROR;
+    }
+    return E_OK;
+}
+
+int32_t DataManager::EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor,
+    uint32_t count, FolderBatch &batch)
+{
+    UDMF_TRACE_SPAN("manager.EnumerateFolder");
+    UnifiedKey key(query.key);
+    if (!key.IsValid()) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Unified key: %{public}s is invalid.", query.key.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+    auto store = storeCache_.GetStore(key.intention);
+    if (store == nullptr) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get store failed, intention: %{public}s.", key.intention.c_str());
+        return E_DB_ERROR;
+    }
+    std::string dataKey;
+    int32_t res = GetDataKey(store, query, dataKey);
+    if (res != E_OK || dataKey.empty()) {
+        return res;
+    }
+    res = WaitPayload(dataKey);
+    if (res != E_OK) {
+        return res;
+    }
+    UnifiedData unifiedData;
+    res = store->Get(dataKey, unifiedData);
+    if (res != E_OK || unifiedData.IsEmpty()) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get data from store failed, intention: %{public}s.", key.intention.c_str());
+        return res != E_OK ? res : E_INVALID_PARAMETERS;
+    }
+    std::shared_ptr<Runtime> runtime = unifiedData.GetRuntime();
+    CheckerManager::CheckInfo info;
+    info.tokenId = query.tokenId;
+    info.pid = query.pid;
+    if (!CheckPrivilege(runtime->privileges, info)) {
+        return E_INVALID_OPERATION;
+    }
+    // only the folders of the data and what is in them are listed, from the sandbox of the creator of the data
+    auto records = unifiedData.GetRecords();
+    bool inData = std::any_of(records.begin(), records.end(), [&uri](const auto &record) {
+        if (record == nullptr || record->GetType() != UDType::FOLDER) {
+            return false;
+        }
+        std::string folder = static_cast<File *>(record.get())->GetUri();
+        return !folder.empty() && (uri == folder || uri.compare(0, folder.size() + 1, folder + "/") == 0);
+    });
+    int32_t userId = 0;
+    if (!inData || runtime->privileges.empty() ||
+        !PreProcessUtils::GetInstance().GetHapUserIdByToken(runtime->privileges.front().tokenId, userId)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Not a folder of the data, key: %{public}s.", query.key.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+    std::string path = FileSizeResolver::GetPhysicalPath(uri, runtime->createPackage, userId);
+    if (path.empty()) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Folder out of the sandbox of %{public}s.", runtime->createPackage.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+    std::string bundleName;
+    if (!GetBundleName(query.tokenId, bundleName)) {
+        return E_ERROR;
+    }
+    res = FolderUtils::List(path, cursor, count, batch);
+    if (res != E_OK) {
+        return res;
+    }
+    std::vector<std::string> uris;
+    for (auto &entry : batch.entries) {
+        entry.uri = FolderUtils::GetChildUri(uri, entry.name);
+        uris.push_back(entry.uri);
+    }
+    // each batch is granted as it is listed, so a huge folder is never granted all at once
+    if (runtime->createPackage != bundleName && GrantUris(uris, bundleName) != E_OK) {
+        batch = FolderBatch();
+        return E_ERROR;
+    }
+    return E_OK;
+}
+
+int32_t DataManager::QueryKeys(QueryCondition &condition, std::vector<std::string> &keys)
+{
+    UDMF_TRACE_SPAN("manager.QueryKeys");
+    if (!UnifiedDataUtils::IsValidIntention(condition.intention) || condition.beginTime > condition.endTime) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid query condition, intention: %{public}d.", condition.intention);
+        return E_INVALID_PARAMETERS;
+    }
+    if (condition.pageSize <= 0) {
+        condition.pageSize = DEFAULT_PAGE_SIZE;
+    }
+    condition.pageSize = std::min(condition.pageSize, MAX_PAGE_SIZE);
+
+    std::string intention = UD_INTENTION_MAP.at(condition.intention);
+    auto store = storeCache_.GetStore(intention);
+    if (store == nullptr) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Get store failed, intention: %{public}s.", intention.c_str());
+        return E_DB_ERROR;
+    }
+    CheckerManager::CheckInfo info;
+    info.tokenId = condition.tokenId;
+    info.pid = condition.pid;
+    // only the keys of data the caller is allowed to read are returned
+    auto filter = [store, &info](const std::string &key) {
+        Runtime runtime;
+        return store->GetRuntime(key, runtime) && CheckerManager::GetInstance().IsValid(runtime.privileges, info);
+    };
+    if (store->QueryKeys(condition, filter, keys) != E_OK) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Store query keys failed, intention: %{public}s.", intention.c_str());
+        return E_DB_ERROR;
+    }
+    return E_OK;
+}
+
 int32_t DataManager::AddPrivilege(QueryOption &query, const Privilege &privilege)
 {
+    UDMF_TRACE_SPAN("manager.AddPrivilege");
     UnifiedKey key(query.key);
     if (!key.IsValid()) {
         LOG_ERROR(UDMF_FRAMEWORK, "Unified key: %{public}s is invalid.", query.key.c_str());
@@ -182,8 +727,17 @@ int32_t DataManager::AddPrivilege(QueryOption &query, const Privilege &privilege
         return E_DB_ERROR;
     }
 
+    std::string dataKey;
+    int32_t res = GetDataKey(store, query, dataKey);
+    if (res != E_OK || dataKey.empty()) {
+        return res == E_OK ? E_INVALID_PARAMETERS : res;
+    }
+    res = WaitPayload(dataKey);
+    if (res != E_OK) {
+        return res;
+    }
     UnifiedData data;
-    int32_t res = store->Get(query.key, data);
+    res = store->Get(dataKey, data);
     if (res != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Get data from store failed, intention: %{public}s.", key.intention.c_str());
         return res;
@@ -196,13 +750,171 @@ int32_t DataManager::AddPrivilege(QueryOption &query, const Privilege &privilege
     }
 
     data.GetRuntime()->privileges.emplace_back(privilege);
-    if (store->Update(data) != E_OK) {
+    if (store->PutRuntime(data) != E_OK) {
         LOG_ERROR(UDMF_FRAMEWORK, "Update unified data failed, intention: %{public}s.", key.intention.c_str());
         return E_DB_ERROR;
     }
+    if (preGrantIntentions_.count(key.intention) != 0) {
+        PreGrantUris(dataKey, data, privilege.tokenId);
+    }
+    return E_OK;
+}
+
+void DataManager::PreGrantUris(const std::string &dataKey, UnifiedData &unifiedData, int32_t tokenId)
+{
+    UDMF_TRACE_SPAN("manager.PreGrantUris");
+    std::string bundleName;
+    if (!GetBundleName(tokenId, bundleName) || bundleName == unifiedData.GetRuntime()->createPackage) {
+        return;
+    }
+    UriGrant grant;
+    grant.uris = GetUris(unifiedData);
+    if (grant.uris.empty()) {
+        return;
+    }
+    grant.id = ++grantId_;
+    grant.bundleName = bundleName;
+    grant.revoked = std::make_shared<std::atomic<bool>>(false);
+    auto promise = std::make_shared<std::promise<int32_t>>();
+    grant.result = promise->get_future().share();
+    std::vector<UriGrant> replaced;
+    uriGrants_.Compute(dataKey, [&grant, &replaced](const std::string &, UriGrant &current) {
+        // the data has a new target, the grants to the previous one are taken back
+        if (current.id != 0) {
+            replaced.push_back(current);
+        }
+        current = grant;
+        return true;
+    });
+    RevokeAsync(std::move(replaced));
+
+    uint64_t requestId = Tracer::GetRequestId();
+    auto task = [grant, promise, requestId]() {
+        TraceRequest request(requestId);
+        UDMF_TRACE_SPAN("manager.GrantUriAhead");
+        promise->set_value(GrantUris(grant.uris, grant.bundleName));
+        // revoked while in flight: the revoker found the grant unfinished and left the revocation to this task
+        if (grant.revoked->load()) {
+            RevokeUris(grant.uris, grant.bundleName);
+        }
+    };
+    if (executorPool_->Execute(task) == ExecutorPool::INVALID_TASK_ID) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Execute grant task failed, the uris are granted when the data is read.");
+        promise->set_value(E_ERROR);
+        uriGrants_.Erase(dataKey);
+        return;
+    }
+    uint64_t id = grant.id;
+    executorPool_->Schedule(PRE_GRANT_TIMEOUT, [this, dataKey, id]() { RevokeGrant(dataKey, id); });
+}
+
+int32_t DataManager::GrantUris(const std::string &dataKey, UnifiedData &unifiedData, const std::string &bundleName)
+{
+    UDMF_TRACE_SPAN("manager.GrantUri");
+    UriGrant grant;
+    uriGrants_.ComputeIfPresent(dataKey, [&grant](const std::string &, UriGrant &current) {
+        grant = current;
+        return false;
+    });
+    if (grant.id != 0 && grant.bundleName == bundleName) {
+        // only the grants still in flight are waited for; a failed one is made again below
+        if (grant.result.wait_for(PAYLOAD_WAIT_TIME) == std::future_status::ready && grant.result.get() == E_OK) {
+            return E_OK;
+        }
+        LOG_WARN(UDMF_FRAMEWORK, "Grant ahead failed, grant again, key: %{public}s.", dataKey.c_str());
+    } else if (grant.id != 0) {
+        RevokeAsync({ grant });
+    }
+    return GrantUris(GetUris(unifiedData), bundleName);
+}
+
+void DataManager::RevokeGrant(const std::string &dataKey, uint64_t id)
+{
+    std::vector<UriGrant> grants;
+    uriGrants_.ComputeIfPresent(dataKey, [id, &grants](const std::string &, UriGrant &current) {
+        if (current.id != id) {
+            return true;
+        }
+        grants.push_back(current);
+        return false;
+    });
+    for (const auto &grant : grants) {
+        LOG_INFO(UDMF_FRAMEWORK, "Grant ahead not used in time, key: %{public}s.", dataKey.c_str());
+        RevokeUris(grant);
+    }
+}
+
+void DataManager::RevokeGrants(const std::string &intention)
+{
+    std::string prefix = UNIFIED_KEY_SCHEMA + intention + "/";
+    std::vector<UriGrant> grants;
+    uriGrants_.EraseIf([&prefix, &grants](const std::string &key, UriGrant &grant) {
+        if (key.compare(0, prefix.size(), prefix) != 0) {
+            return false;
+        }
+        grants.push_back(grant);
+        return true;
+    });
+    RevokeAsync(std::move(grants));
+}
+
+void DataManager::RevokeAsync(std::vector<UriGrant> grants)
+{
+    if (grants.empty()) {
+        return;
+    }
+    // revoking takes a call to the ability manager per uri, which is kept off the caller's thread
+    auto task = [grants]() {
+        for (const auto &grant : grants) {
+            RevokeUris(grant);
+        }
+    };
+    if (executorPool_->Execute(task) == ExecutorPool::INVALID_TASK_ID) {
+        task();
+    }
+}
+
+std::vector<std::string> DataManager::GetUris(UnifiedData &unifiedData)
+{
+    std::vector<std::string> uris;
+    for (const auto &record : unifiedData.GetRecords()) {
+        auto type = record->GetType();
+        if (type == UDType::FILE || type == UDType::IMAGE || type == UDType::VIDEO || type == UDType::FOLDER) {
+            auto file = static_cast<File *>(record.get());
+            if (!file->GetUri().empty()) {
+                uris.push_back(file->GetUri());
+            }
+        }
+    }
+    return uris;
+}
+
+int32_t DataManager::GrantUris(const std::vector<std::string> &uris, const std::string &bundleName)
+{
+    for (const auto &uri : uris) {
+        if (UriPermissionManager::GetInstance().GrantUriPermission(uri, bundleName) != E_OK) {
+            return E_ERROR;
+        }
+    }
     return E_OK;
 }
 
+void DataManager::RevokeUris(const UriGrant &grant)
+{
+    grant.revoked->store(true);
+    if (grant.result.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
+        RevokeUris(grant.uris, grant.bundleName);
+    }
+}
+
+void DataManager::RevokeUris(const std::vector<std::string> &uris, const std::string &bundleName)
+{
+    UDMF_TRACE_SPAN("manager.RevokeUri");
+    for (const auto &uri : uris) {
+        UriPermissionManager::GetInstance().RevokeUriPermission(uri, bundleName);
+    }
+}
+
 int32_t DataManager::Sync(const QueryOption &query, const std::vector<std::string> &devices)
 {
     UnifiedKey key(query.key);
@@ -223,5 +935,70 @@ int32_t DataManager::Sync(const QueryOption &query, const std::vector<std::strin
     }
     return E_OK;
 }
+
+void DataManager::SetStoreDir(const std::string &dir)
+{
+    storeCache_.SetBaseDir(dir);
+}
+
+void DataManager::SetWarmIntentions(const std::set<Intention> &intentions)
+{
+    warmIntentions_ = intentions;
+}
+
+void DataManager::PreWarm()
+{
+    for (auto intention : warmIntentions_) {
+        auto task = [this, intention]() {
+            std::string name = UD_INTENTION_MAP.at(intention);
+            auto store = storeCache_.GetStore(name);
+            if (store == nullptr) {
+                LOG_ERROR(UDMF_FRAMEWORK, "Warm store failed, intention: %{public}s.", name.c_str());
+                return;
+            }
+            // a first query reads the indexes in, so the first request does not read them from the disk
+            QueryCondition condition;
+            condition.intention = intention;
+            condition.pageSize = 1;
+            std::vector<std::string> keys;
+            store->QueryKeys(condition, [](const std::string &key) { return true; }, keys);
+        };
+        if (executorPool_->Execute(task) == ExecutorPool::INVALID_TASK_ID) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Execute warm task failed, intention: %{public}d.", intention);
+        }
+    }
+}
+
+int32_t DataManager::DumpStats(std::string &stats)
+{
+    // the creation times of the data are in milliseconds since the epoch
+    int64_t now = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    for (int32_t intention = UD_INTENTION_DRAG; intention < UD_INTENTION_BUTT; ++intention) {
+        std::string name = UD_INTENTION_MAP.at(intention);
+        // a store not opened yet is not opened for the dump
+        auto store = storeCache_.FindStore(name);
+        if (store == nullptr) {
+            stats += "  " + name + ": not open\n";
+            continue;
+        }
+        StoreStats storeStats;
+        if (store->GetStats(storeStats) != E_OK) {
+            LOG_ERROR(UDMF_FRAMEWORK, "Get store stats failed, intention: %{public}s.", name.c_str());
+            stats += "  " + name + ": unavailable\n";
+            continue;
+        }
+        int64_t oldestAge = storeStats.dataCount > 0 ? now - static_cast<int64_t>(storeStats.oldestTime) : 0;
+        stats += "  " + name + ": data=" + std::to_string(storeStats.dataCount) + " entries=" +
+            std::to_string(storeStats.entryCount) + " bytes=" + std::to_string(storeStats.entryBytes) +
+            " oldestAge=" + std::to_string(oldestAge) + "ms open=" + std::to_string(storeCache_.GetOpenTime(name)) +
+            "us flushes=" + std::to_string(storeStats.flushCount) + " flushedBytes=" +
+            std::to_string(storeStats.flushedBytes) + "\n";
+        for (const auto &[type, size] : storeStats.typeBytes) {
+            stats += "    " + type + ": " + std::to_string(size) + "\n";
+        }
+    }
+    return E_OK;
+}
 } // namespace UDMF
 } // namespace OHOS
\ No newline at end of file
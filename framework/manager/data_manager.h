@@ -16,12 +16,21 @@
 #ifndef UDMF_DATA_MANAGER_H
 #define UDMF_DATA_MANAGER_H
 
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <future>
 #include <map>
 #include <memory>
 #include <mutex>
+#include <set>
+#include <utility>
 #include <vector>
 
+#include "checker_manager.h"
+#include "concurrent_map.h"
 #include "error_code.h"
+#include "executor_pool.h"
 #include "store_cache.h"
 #include "unified_data.h"
 #include "unified_types.h"
@@ -35,15 +44,101 @@ public:
     static DataManager &GetInstance();
 
     int32_t SaveData(CustomOption &option, UnifiedData &unifiedData, std::string &key);
+    int32_t SaveBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+        std::vector<std::string> &keys);
+    int32_t AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record);
+    int32_t ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record);
     int32_t RetrieveData(QueryOption &query, UnifiedData &unifiedData);
     int32_t GetSummary(QueryOption &query, Summary &summary);
+    // reads the preview of the data for a caller allowed to read the data, without reading or consuming the data
+    int32_t GetPreview(QueryOption &query, Preview &preview);
+    // lists a batch of the children of a folder of the data and grants their uris to the caller, without consuming
+    // the data
+    int32_t EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor, uint32_t count,
+        FolderBatch &batch);
+    int32_t QueryKeys(QueryCondition &condition, std::vector<std::string> &keys);
     int32_t AddPrivilege(QueryOption &query, const Privilege &privilege);
     int32_t Sync(const QueryOption &query, const std::vector<std::string> &devices);
+    // a line per intention with the count, entries, bytes and age of its data, the time its store took to open and
+    // the snapshots flushed in the background, then the bytes of each type
+    int32_t DumpStats(std::string &stats);
+    // for tools driving the manager in their own process; set before the first request
+    void SetStoreDir(const std::string &dir);
+    // intentions whose stores PreWarm opens, share only by default; set before PreWarm
+    void SetWarmIntentions(const std::set<Intention> &intentions);
+    // opens the stores of the warm intentions and reads their indexes in the background
+    void PreWarm();
 
 private:
+    static constexpr int64_t PROGRESSIVE_SAVE_SIZE = 64 * 1024;
+    static constexpr std::chrono::milliseconds PAYLOAD_WAIT_TIME = std::chrono::milliseconds(3000);
+    static constexpr size_t PAYLOAD_WRITERS = 2;
+    static constexpr uint32_t MAX_HISTORY_VERSIONS = 8;
+    static constexpr int32_t DEFAULT_PAGE_SIZE = 64;
+    static constexpr int32_t MAX_PAGE_SIZE = 512;
+    static constexpr size_t MAX_BATCH_DATA_COUNT = 64;
+    // a uri grant made ahead of a read which does not come in time is taken back
+    static constexpr std::chrono::seconds PRE_GRANT_TIMEOUT = std::chrono::seconds(60);
+    // uri permissions granted to the target of a privilege before it reads the data
+    struct UriGrant {
+        uint64_t id = 0;
+        std::string bundleName;
+        std::vector<std::string> uris;
+        std::shared_future<int32_t> result;
+        // set by the revoker; a grant still in flight then revokes its uris itself once they are granted
+        std::shared_ptr<std::atomic<bool>> revoked;
+    };
     DataManager();
+    int32_t SaveProgressively(std::shared_ptr<Store> store, const UnifiedData &unifiedData);
+    int32_t WaitPayload(const std::string &key);
+    // counts the files of the file records in the summary
+    void ResolveFileSizes(const std::vector<std::shared_ptr<UnifiedRecord>> &records, const std::string &bundleName,
+        int32_t tokenId);
+    int32_t UpdateRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record, bool replace);
+    bool CheckPrivilege(std::vector<Privilege> &privileges, const CheckerManager::CheckInfo &info);
+    // pixel maps in an encoding the caller does not decode are handed out raw
+    static void DecodePixelMaps(UnifiedData &unifiedData, uint32_t encodings);
+    bool GetBundleName(int32_t tokenId, std::string &bundleName);
+    Status DeleteOnGet(const UnifiedKey &key);
+    int32_t WaitPayloads(const std::string &intention);
+    std::shared_ptr<std::mutex> GetReplaceMutex(const std::string &intention);
+    int32_t GetDataKey(std::shared_ptr<Store> store, const QueryOption &query, std::string &dataKey);
+    std::string GetValidator(std::shared_ptr<Store> store, const QueryOption &query, const std::string &dataKey,
+        const Runtime &runtime);
+    // reads the summary of the data from the store, or joins a read in flight started for the same validator
+    Status ReadSummary(std::shared_ptr<Store> store, const std::string &dataKey, const std::string &validator,
+        Summary &summary);
+    void PreGrantUris(const std::string &dataKey, UnifiedData &unifiedData, int32_t tokenId);
+    int32_t GrantUris(const std::string &dataKey, UnifiedData &unifiedData, const std::string &bundleName);
+    void RevokeGrant(const std::string &dataKey, uint64_t id);
+    void RevokeGrants(const std::string &intention);
+    void RevokeAsync(std::vector<UriGrant> grants);
+    static std::vector<std::string> GetUris(UnifiedData &unifiedData);
+    static int32_t GrantUris(const std::vector<std::string> &uris, const std::string &bundleName);
+    static void RevokeUris(const UriGrant &grant);
+    static void RevokeUris(const std::vector<std::string> &uris, const std::string &bundleName);
     StoreCache storeCache_;
     std::map<std::string, std::string> authorizationMap_;
+    // intentions keeping a bounded history of versions per bundle instead of replacing the data
+    std::map<std::string, uint32_t> historyMap_;
+    std::shared_ptr<ExecutorPool> executorPool_;
+    // writes the records of progressive saves only, so that grants, revocations, pre-warm and the store flush queued
+    // on the pool above cannot hold a reader waiting for the records past PAYLOAD_WAIT_TIME
+    std::shared_ptr<ExecutorPool> payloadPool_;
+    // records which are still being written, keyed by unified key
+    ConcurrentMap<std::string, std::shared_future<int32_t>> pendingPayloads_;
+    // held by a save replacing the data of an intention, keyed by intention
+    ConcurrentMap<std::string, std::shared_ptr<std::mutex>> replaceMutexes_;
+    // summaries being read from the stores, keyed by unified key and validator, for the concurrent reads of a data
+    // to share
+    ConcurrentMap<std::string, std::shared_future<std::pair<Status, Summary>>> summaryReads_;
+    // intentions whose uris are granted as soon as a privilege is added, instead of when the data is read
+    std::set<std::string> preGrantIntentions_;
+    // grants made ahead of the read of the data, keyed by unified key
+    ConcurrentMap<std::string, UriGrant> uriGrants_;
+    std::atomic<uint64_t> grantId_{ 0 };
+    // intentions whose stores are opened when the service starts instead of by their first request
+    std::set<Intention> warmIntentions_;
 };
 } // namespace UDMF
 } // namespace OHOS
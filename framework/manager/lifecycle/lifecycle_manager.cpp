@@ -23,6 +23,8 @@ std::shared_ptr<ExecutorPool> LifeCycleManager::executorPool_ = std::make_shared
 
 std::unordered_map<std::string, std::shared_ptr<LifeCyclePolicy>> LifeCycleManager::intentionPolicyMap_ = {
     { UD_INTENTION_MAP.at(UD_INTENTION_DRAG), std::make_shared<CleanAfterGetdata>() },
+    { UD_INTENTION_MAP.at(UD_INTENTION_SYS), std::make_shared<CleanOnTimeout>() },
+    { UD_INTENTION_MAP.at(UD_INTENTION_SHARE), std::make_shared<CleanOnTimeout>() },
 };
 
 LifeCycleManager &LifeCycleManager::GetInstance()
@@ -22,6 +22,10 @@
 
 namespace OHOS {
 namespace UDMF {
+UriPermissionManager::UriPermissionManager() : uriPermissionManager_(AAFwk::UriPermissionManagerClient::GetInstance())
+{
+}
+
 UriPermissionManager &UriPermissionManager::GetInstance()
 {
     static UriPermissionManager instance;
@@ -30,9 +34,6 @@ UriPermissionManager &UriPermissionManager::GetInstance()
 
 Status UriPermissionManager::GrantUriPermission(const std::string &path, const std::string &bundleName)
 {
-    if (uriPermissionManager_ == nullptr) {
-        uriPermissionManager_ = AAFwk::UriPermissionManagerClient::GetInstance();
-    }
     Uri uri(path);
     int autoRemove = 1;
     auto status = uriPermissionManager_->GrantUriPermission(uri, AAFwk::Want::FLAG_AUTH_READ_URI_PERMISSION,
@@ -43,5 +44,16 @@ Status UriPermissionManager::GrantUriPermission(const std::string &path, const s
     }
     return E_OK;
 }
+
+Status UriPermissionManager::RevokeUriPermission(const std::string &path, const std::string &bundleName)
+{
+    Uri uri(path);
+    auto status = uriPermissionManager_->RevokeUriPermissionManually(uri, bundleName);
+    if (status != ERR_OK) {
+        LOG_ERROR(UDMF_FRAMEWORK, "RevokeUriPermission failed, %{public}d", status);
+        return E_ERROR;
+    }
+    return E_OK;
+}
 } // namespace UDMF
 } // namespace OHOS
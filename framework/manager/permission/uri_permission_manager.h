@@ -29,8 +29,12 @@ class UriPermissionManager {
 public:
     static UriPermissionManager &GetInstance();
     Status GrantUriPermission(const std::string &path, const std::string &bundleName);
+    Status RevokeUriPermission(const std::string &path, const std::string &bundleName);
 
 private:
+    UriPermissionManager();
+
+    // set once at construction, as grants are made from several threads
     std::shared_ptr<AAFwk::UriPermissionManagerClient> uriPermissionManager_;
 };
 } // namespace UDMF
@@ -0,0 +1,246 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "file_size_resolver.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cinttypes>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "file.h"
+#include "folder_utils.h"
+#include "logger.h"
+#include "udmf_tracer.h"
+
+namespace OHOS {
+namespace UDMF {
+static constexpr const char *FILE_SCHEME = "file://";
+static constexpr const char *SANDBOX_ROOT = "/data/storage/";
+static constexpr const char *APP_ROOT = "/data/app/";
+// the directories of a sandbox which are mapped per bundle
+static const std::vector<std::string> SANDBOX_DIRS = { "base", "database" };
+// the encryption level of the directories, el1 to el5
+static const std::string EL_PREFIX = "el";
+static constexpr size_t MAX_THREADS = 4;
+static constexpr size_t MIN_THREADS = 0;
+static constexpr size_t CLOCK_INTERVAL = 64;
+static constexpr int HEX_BASE = 16;
+
+static bool IsFile(UDType type)
+{
+    return type == UDType::FILE || type == UDType::IMAGE || type == UDType::VIDEO || type == UDType::FOLDER;
+}
+
+static bool Decode(const std::string &text, std::string &decoded)
+{
+    decoded.clear();
+    for (size_t i = 0; i < text.size(); ++i) {
+        if (text[i] != '%') {
+            decoded.push_back(text[i]);
+            continue;
+        }
+        if (i + 2 >= text.size() || isxdigit(text[i + 1]) == 0 || isxdigit(text[i + 2]) == 0) {
+            return false;
+        }
+        decoded.push_back(static_cast<char>(std::stoi(text.substr(i + 1, 2), nullptr, HEX_BASE)));
+        i += 2;
+    }
+    return true;
+}
+
+FileSizeResolver &FileSizeResolver::GetInstance()
+{
+    static FileSizeResolver instance;
+    return instance;
+}
+
+FileSizeResolver::FileSizeResolver() : executors_(std::make_shared<ExecutorPool>(MAX_THREADS, MIN_THREADS))
+{
+}
+
+std::string FileSizeResolver::GetPhysicalPath(const std::string &uri, const std::string &bundleName, int32_t userId)
+{
+    // file://<bundle>/data/storage/<el>/<dir>/<rest> is /data/app/<el>/<user>/<dir>/<bundle>/<rest>
+    std::string prefix = std::string(FILE_SCHEME) + bundleName + SANDBOX_ROOT;
+    std::string path;
+    if (bundleName.empty() || uri.compare(0, prefix.size(), prefix) != 0 ||
+        uri.find_first_of("?#") != std::string::npos || !Decode(uri.substr(prefix.size()), path)) {
+        return "";
+    }
+    size_t elEnd = path.find('/');
+    size_t dirEnd = elEnd == std::string::npos ? std::string::npos : path.find('/', elEnd + 1);
+    if (dirEnd == std::string::npos) {
+        return "";
+    }
+    std::string el = path.substr(0, elEnd);
+    std::string dir = path.substr(elEnd + 1, dirEnd - elEnd - 1);
+    std::string rest = path.substr(dirEnd);
+    if (el.size() <= EL_PREFIX.size() || el.compare(0, EL_PREFIX.size(), EL_PREFIX) != 0 ||
+        !std::all_of(el.begin() + EL_PREFIX.size(), el.end(), [](char c) { return isdigit(c) != 0; }) ||
+        std::find(SANDBOX_DIRS.begin(), SANDBOX_DIRS.end(), dir) == SANDBOX_DIRS.end() ||
+        rest.find('\0') != std::string::npos || (rest + "/").find("/../") != std::string::npos) {
+        return "";
+    }
+    return std::string(APP_ROOT) + el + "/" + std::to_string(userId) + "/" + dir + "/" + bundleName + rest;
+}
+
+int64_t FileSizeResolver::GetSummarySize(const std::shared_ptr<UnifiedRecord> &record)
+{
+    int64_t size = record->GetSize();
+    if (!IsFile(record->GetType())) {
+        return size;
+    }
+    UDDetails details = static_cast<File *>(record.get())->GetDetails();
+    auto it = details.find(File::FILE_SIZE);
+    if (it != details.end() && std::holds_alternative<int64_t>(it->second)) {
+        size += std::max<int64_t>(std::get<int64_t>(it->second), 0);
+    }
+    return size;
+}
+
+void FileSizeResolver::Resolve(const std::vector<std::shared_ptr<UnifiedRecord>> &records,
+    const std::string &bundleName, int32_t userId)
+{
+    UDMF_TRACE_SPAN("manager.ResolveFileSizes");
+    auto now = std::chrono::steady_clock::now();
+    auto deadline = now + TIME_BUDGET;
+    std::vector<std::pair<File *, std::shared_ptr<Walk>>> walks;
+    for (const auto &record : records) {
+        if (record == nullptr || !IsFile(record->GetType())) {
+            continue;
+        }
+        auto file = static_cast<File *>(record.get());
+        // only sizes the service resolved itself are counted
+        UDDetails details = file->GetDetails();
+        if (details.erase(File::FILE_SIZE) > 0) {
+            file->SetDetails(details);
+        }
+        std::string path = GetPhysicalPath(file->GetUri(), bundleName, userId);
+        if (path.empty()) {
+            continue;
+        }
+        auto cached = sizes_.Find(path);
+        if (cached.first && now - cached.second.time < CACHE_TTL) {
+            details[File::FILE_SIZE] = cached.second.size;
+            file->SetDetails(details);
+            continue;
+        }
+        auto walk = StartWalk(path);
+        if (walk != nullptr) {
+            walks.emplace_back(file, walk);
+        }
+    }
+    for (const auto &[file, walk] : walks) {
+        walk->done.wait_until(deadline);
+        UDDetails details = file->GetDetails();
+        details[File::FILE_SIZE] = walk->size.load();
+        file->SetDetails(details);
+    }
+}
+
+std::shared_ptr<FileSizeResolver::Walk> FileSizeResolver::StartWalk(const std::string &path)
+{
+    std::shared_ptr<Walk> walk;
+    bool started = false;
+    // a walk still going on for an earlier data is joined instead of walking the folder twice
+    walks_.Compute(path, [&walk, &started](const std::string &, std::shared_ptr<Walk> &current) {
+        if (current == nullptr) {
+            current = std::make_shared<Walk>();
+            started = true;
+        }
+        walk = current;
+        return true;
+    });
+    if (!started) {
+        return walk;
+    }
+    auto task = [this, path, walk]() {
+        if (!WalkPath(path, *walk)) {
+            LOG_WARN(UDMF_SERVICE, "Walk out of time, counted: %{public}" PRId64 ".", walk->size.load());
+        }
+        if (sizes_.Size() >= MAX_CACHE_COUNT) {
+            sizes_.Clear();
+        }
+        sizes_.InsertOrAssign(path, CachedSize{ walk->size.load(), std::chrono::steady_clock::now() });
+        walks_.Erase(path);
+        walk->promise.set_value();
+    };
+    if (executors_->Execute(task) == ExecutorPool::INVALID_TASK_ID) {
+        LOG_ERROR(UDMF_SERVICE, "Execute walk task failed.");
+        walks_.Erase(path);
+        return nullptr;
+    }
+    return walk;
+}
+
+bool FileSizeResolver::WalkPath(const std::string &path, Walk &walk)
+{
+    int fd = FolderUtils::OpenInSandbox(path, O_RDONLY);
+    struct stat info {};
+    if (fd < 0) {
+        return true;
+    }
+    if (fstat(fd, &info) != 0 || !S_ISDIR(info.st_mode)) {
+        walk.size += S_ISREG(info.st_mode) ? static_cast<int64_t>(info.st_size) : 0;
+        close(fd);
+        return true;
+    }
+    std::shared_ptr<DIR> root(fdopendir(fd), [](DIR *opened) { closedir(opened); });
+    if (root == nullptr) {
+        close(fd);
+        return true;
+    }
+    auto deadline = std::chrono::steady_clock::now() + WALK_TIME_LIMIT;
+    size_t visited = 0;
+    // a folder is opened at its parent without following links, the parent kept open until its folders are walked
+    std::vector<std::pair<std::shared_ptr<DIR>, std::string>> folders = { { root, "." } };
+    while (!folders.empty()) {
+        auto [parent, name] = std::move(folders.back());
+        folders.pop_back();
+        int folderFd = openat(dirfd(parent.get()), name.c_str(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+        DIR *folder = folderFd < 0 ? nullptr : fdopendir(folderFd);
+        if (folder == nullptr) {
+            if (folderFd >= 0) {
+                close(folderFd);
+            }
+            continue;
+        }
+        std::shared_ptr<DIR> dir(folder, [](DIR *opened) { closedir(opened); });
+        for (struct dirent *entry = readdir(folder); entry != nullptr; entry = readdir(folder)) {
+            std::string child = entry->d_name;
+            if (child == "." || child == "..") {
+                continue;
+            }
+            if (fstatat(dirfd(folder), entry->d_name, &info, AT_SYMLINK_NOFOLLOW) != 0) {
+                continue;
+            }
+            if (S_ISDIR(info.st_mode)) {
+                folders.emplace_back(dir, std::move(child));
+            } else if (S_ISREG(info.st_mode)) {
+                walk.size += static_cast<int64_t>(info.st_size);
+            }
+            if (++visited % CLOCK_INTERVAL == 0 && std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+} // namespace UDMF
+} // namespace OHOS
@@ -0,0 +1,81 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_FILE_SIZE_RESOLVER_H
+#define UDMF_FILE_SIZE_RESOLVER_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "concurrent_map.h"
+#include "executor_pool.h"
+#include "unified_record.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * Resolves the sizes on disk of the files and folders of file records, so the summary of data counts them. The
+ * files are looked up in parallel and waited for at most a time budget; a folder not walked by then is counted by
+ * what was walked, and its walk goes on in the background for the next data referring to it.
+ */
+class FileSizeResolver {
+public:
+    static constexpr std::chrono::milliseconds TIME_BUDGET = std::chrono::milliseconds(50);
+    // a walk going on longer stops, and the folder is counted by what was walked
+    static constexpr std::chrono::seconds WALK_TIME_LIMIT = std::chrono::seconds(10);
+    // a size resolved is used for this long without looking at the file again, it is cached per file
+    static constexpr std::chrono::seconds CACHE_TTL = std::chrono::seconds(30);
+    static constexpr size_t MAX_CACHE_COUNT = 1024;
+
+    static FileSizeResolver &GetInstance();
+
+    // sets File::FILE_SIZE in the details of the file records, only for the files in the sandbox of the bundle
+    void Resolve(const std::vector<std::shared_ptr<UnifiedRecord>> &records, const std::string &bundleName,
+        int32_t userId);
+    // the path of a file uri of the sandbox of the bundle, empty if the uri is not one
+    static std::string GetPhysicalPath(const std::string &uri, const std::string &bundleName, int32_t userId);
+    // the size of a record in a summary: its own size and the size of the file it refers to
+    static int64_t GetSummarySize(const std::shared_ptr<UnifiedRecord> &record);
+
+private:
+    struct Walk {
+        Walk() : done(promise.get_future().share()) {}
+        std::atomic<int64_t> size{ 0 };
+        std::promise<void> promise;
+        std::shared_future<void> done;
+    };
+    struct CachedSize {
+        int64_t size = 0;
+        std::chrono::steady_clock::time_point time;
+    };
+
+    FileSizeResolver();
+    std::shared_ptr<Walk> StartWalk(const std::string &path);
+    // false if the walk ran out of time
+    static bool WalkPath(const std::string &path, Walk &walk);
+
+    std::shared_ptr<ExecutorPool> executors_;
+    // keyed by the path of the file, as the uri of a bundle is a different file for each user
+    ConcurrentMap<std::string, CachedSize> sizes_;
+    ConcurrentMap<std::string, std::shared_ptr<Walk>> walks_;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_FILE_SIZE_RESOLVER_H
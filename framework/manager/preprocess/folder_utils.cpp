@@ -0,0 +1,152 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "folder_utils.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <charconv>
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+#include "logger.h"
+#include "udmf_tracer.h"
+
+namespace OHOS {
+namespace UDMF {
+static constexpr const char *HEX_DIGITS = "0123456789ABCDEF";
+static constexpr int HEX_SHIFT = 4;
+static constexpr uint8_t HEX_MASK = 0x0f;
+// the components of the root of a sandbox, /data/app/<el>/<user>/<dir>/<bundle>, made by the system and not the app
+static constexpr size_t SANDBOX_DEPTH = 6;
+
+static bool ParseCursor(const std::string &cursor, long &position)
+{
+    position = 0;
+    if (cursor.empty()) {
+        return true;
+    }
+    auto result = std::from_chars(cursor.data(), cursor.data() + cursor.size(), position);
+    return result.ec == std::errc() && result.ptr == cursor.data() + cursor.size();
+}
+
+Status FolderUtils::List(const std::string &path, const std::string &cursor, uint32_t count, FolderBatch &batch)
+{
+    UDMF_TRACE_SPAN("manager.ListFolder");
+    long position = 0;
+    if (!ParseCursor(cursor, position)) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Invalid cursor: %{public}s.", cursor.c_str());
+        return E_INVALID_PARAMETERS;
+    }
+    count = (count == 0 || count > MAX_BATCH_COUNT) ? MAX_BATCH_COUNT : count;
+    int fd = OpenInSandbox(path, O_RDONLY | O_DIRECTORY);
+    if (fd < 0) {
+        LOG_ERROR(UDMF_FRAMEWORK, "Open folder failed, errno: %{public}d.", errno);
+        return E_INVALID_PARAMETERS;
+    }
+    DIR *dir = fdopendir(fd);
+    if (dir == nullptr) {
+        close(fd);
+        return E_ERROR;
+    }
+    if (!cursor.empty()) {
+        seekdir(dir, position);
+    }
+    batch.entries.clear();
+    batch.cursor.clear();
+    position = telldir(dir);
+    for (struct dirent *entry = readdir(dir); entry != nullptr; position = telldir(dir), entry = readdir(dir)) {
+        std::string name = entry->d_name;
+        if (name == "." || name == "..") {
+            continue;
+        }
+        if (batch.entries.size() == count) {
+            // the entry is read again first by the next batch
+            batch.cursor = std::to_string(position);
+            break;
+        }
+        struct stat info {};
+        if (fstatat(dirfd(dir), entry->d_name, &info, AT_SYMLINK_NOFOLLOW) != 0 ||
+            !(S_ISREG(info.st_mode) || S_ISDIR(info.st_mode))) {
+            continue;
+        }
+        FolderEntry folderEntry;
+        folderEntry.name = std::move(name);
+        folderEntry.type = S_ISDIR(info.st_mode) ? UDType::FOLDER : UDType::FILE;
+        folderEntry.size = S_ISDIR(info.st_mode) ? 0 : static_cast<int64_t>(info.st_size);
+        batch.entries.push_back(std::move(folderEntry));
+    }
+    closedir(dir);
+    return E_OK;
+}
+
+int FolderUtils::OpenInSandbox(const std::string &path, int flags)
+{
+    size_t rootEnd = 0;
+    for (size_t i = 0; i < SANDBOX_DEPTH && rootEnd != std::string::npos; ++i) {
+        rootEnd = path.find('/', rootEnd + 1);
+    }
+    if (path.empty() || path.front() != '/' || rootEnd == std::string::npos) {
+        return -1;
+    }
+    int fd = open(path.substr(0, rootEnd).c_str(), O_PATH | O_DIRECTORY | O_CLOEXEC);
+    std::vector<std::string> names;
+    for (size_t begin = rootEnd + 1; begin <= path.size();) {
+        size_t end = std::min(path.find('/', begin), path.size());
+        if (end > begin && path.compare(begin, end - begin, ".") != 0) {
+            names.push_back(path.substr(begin, end - begin));
+        }
+        begin = end + 1;
+    }
+    if (names.empty()) {
+        names.push_back(".");
+    }
+    for (size_t i = 0; fd >= 0 && i < names.size(); ++i) {
+        if (names[i] == "..") {
+            close(fd);
+            return -1;
+        }
+        bool last = i + 1 == names.size();
+        int next = openat(fd, names[i].c_str(),
+            (last ? flags : O_PATH | O_DIRECTORY) | O_NOFOLLOW | O_CLOEXEC);
+        close(fd);
+        fd = next;
+    }
+    return fd;
+}
+
+std::string FolderUtils::GetChildUri(const std::string &uri, const std::string &name)
+{
+    std::string childUri = uri;
+    if (childUri.empty() || childUri.back() != '/') {
+        childUri.push_back('/');
+    }
+    for (unsigned char c : name) {
+        if (isalnum(c) != 0 || c == '-' || c == '.' || c == '_' || c == '~') {
+            childUri.push_back(static_cast<char>(c));
+            continue;
+        }
+        childUri.push_back('%');
+        childUri.push_back(HEX_DIGITS[c >> HEX_SHIFT]);
+        childUri.push_back(HEX_DIGITS[c & HEX_MASK]);
+    }
+    return childUri;
+}
+} // namespace UDMF
+} // namespace OHOS
@@ -0,0 +1,43 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_FOLDER_UTILS_H
+#define UDMF_FOLDER_UTILS_H
+
+#include <cstdint>
+#include <string>
+
+#include "error_code.h"
+#include "unified_types.h"
+
+namespace OHOS {
+namespace UDMF {
+class FolderUtils {
+public:
+    // the most entries in a batch, so a batch of the longest names still fits in a parcel
+    static constexpr uint32_t MAX_BATCH_COUNT = 256;
+
+    // lists at most count children of the folder at path from the cursor, the position of the file system in the
+    // folder, so no state is kept between batches; symbolic links are not listed
+    static Status List(const std::string &path, const std::string &cursor, uint32_t count, FolderBatch &batch);
+    // opens the path of a sandbox one component at a time without following symbolic links, so a link the app made
+    // in its sandbox never leads out of it; -1 on failure
+    static int OpenInSandbox(const std::string &path, int flags);
+    // the uri of a child of the folder at uri, with the name percent-encoded
+    static std::string GetChildUri(const std::string &uri, const std::string &name);
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_FOLDER_UTILS_H
@@ -86,6 +86,18 @@ bool PreProcessUtils::GetHapBundleNameByToken(int tokenId, std::string &bundleNa
     return true;
 }
 
+bool PreProcessUtils::GetHapUserIdByToken(int tokenId, int32_t &userId)
+{
+    Security::AccessToken::HapTokenInfo hapInfo;
+    if (Security::AccessToken::AccessTokenKit::GetHapTokenInfo(tokenId, hapInfo)
+        != Security::AccessToken::AccessTokenKitRet::RET_SUCCESS) {
+        errorStr = "get user info error";
+        return false;
+    }
+    userId = hapInfo.userID;
+    return true;
+}
+
 bool PreProcessUtils::GetNativeProcessNameByToken(int tokenId, std::string &processName)
 {
     Security::AccessToken::NativeTokenInfo nativeInfo;
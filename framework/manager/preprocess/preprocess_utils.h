@@ -36,6 +36,7 @@ public:
     std::string IdGenerator();
     time_t GetTimeStamp();
     bool GetHapBundleNameByToken(int tokenId, std::string &bundleName);
+    bool GetHapUserIdByToken(int tokenId, int32_t &userId);
     bool GetNativeProcessNameByToken(int tokenId, std::string &processName);
     std::string errorStr;
 };
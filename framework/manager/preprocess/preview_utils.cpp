@@ -0,0 +1,110 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "preview_utils.h"
+
+#include <algorithm>
+
+#include "logger.h"
+#include "system_defined_pixelmap.h"
+
+namespace OHOS {
+namespace UDMF {
+static bool GetInt(const UDDetails &details, const char *name, int32_t &value)
+{
+    auto it = details.find(name);
+    if (it == details.end() || !std::holds_alternative<int32_t>(it->second)) {
+        return false;
+    }
+    value = std::get<int32_t>(it->second);
+    return true;
+}
+
+static bool IsValidSize(size_t size, int32_t width, int32_t height)
+{
+    return width > 0 && height > 0 &&
+        static_cast<uint64_t>(width) * static_cast<uint64_t>(height) * PreviewUtils::PIXEL_BYTES == size;
+}
+
+bool PreviewUtils::MakePreview(const UnifiedData &unifiedData, Preview &preview)
+{
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr || record->GetType() != SYSTEM_DEFINED_PIXEL_MAP) {
+            continue;
+        }
+        auto pixelMap = static_cast<SystemDefinedPixelMap *>(record.get());
+        UDDetails details = pixelMap->GetDetails();
+        int32_t width = 0;
+        int32_t height = 0;
+        auto it = details.find(SystemDefinedPixelMap::PREVIEW);
+        if (it != details.end() && std::holds_alternative<std::vector<uint8_t>>(it->second) &&
+            GetInt(details, SystemDefinedPixelMap::PREVIEW_WIDTH, width) &&
+            GetInt(details, SystemDefinedPixelMap::PREVIEW_HEIGHT, height) &&
+            Downscale(std::get<std::vector<uint8_t>>(it->second), width, height, preview)) {
+            return true;
+        }
+        if (GetInt(details, SystemDefinedPixelMap::WIDTH, width) &&
+            GetInt(details, SystemDefinedPixelMap::HEIGHT, height) &&
+            Downscale(pixelMap->GetRawData(), width, height, preview)) {
+            return true;
+        }
+        // only the first pixel map is previewed, a later one is not taken for it
+        LOG_DEBUG(UDMF_FRAMEWORK, "Pixel map has no preview size.");
+        return false;
+    }
+    return false;
+}
+
+bool PreviewUtils::Downscale(const std::vector<uint8_t> &pixels, int32_t width, int32_t height, Preview &preview)
+{
+    if (!IsValidSize(pixels.size(), width, height)) {
+        return false;
+    }
+    int32_t side = std::max(width, height);
+    if (side <= MAX_SIDE) {
+        preview = { width, height, pixels };
+        return true;
+    }
+    int32_t targetWidth = std::max(1, static_cast<int32_t>(static_cast<int64_t>(width) * MAX_SIDE / side));
+    int32_t targetHeight = std::max(1, static_cast<int32_t>(static_cast<int64_t>(height) * MAX_SIDE / side));
+    preview.width = targetWidth;
+    preview.height = targetHeight;
+    preview.pixels.assign(static_cast<size_t>(targetWidth) * targetHeight * PIXEL_BYTES, 0);
+    for (int32_t y = 0; y < targetHeight; ++y) {
+        int64_t top = static_cast<int64_t>(y) * height / targetHeight;
+        int64_t bottom = std::max(top + 1, static_cast<int64_t>(y + 1) * height / targetHeight);
+        for (int32_t x = 0; x < targetWidth; ++x) {
+            int64_t left = static_cast<int64_t>(x) * width / targetWidth;
+            int64_t right = std::max(left + 1, static_cast<int64_t>(x + 1) * width / targetWidth);
+            uint64_t sums[PIXEL_BYTES] = {};
+            for (int64_t row = top; row < bottom; ++row) {
+                const uint8_t *pixel = pixels.data() + (row * width + left) * PIXEL_BYTES;
+                for (int64_t column = left; column < right; ++column, pixel += PIXEL_BYTES) {
+                    for (int32_t channel = 0; channel < PIXEL_BYTES; ++channel) {
+                        sums[channel] += pixel[channel];
+                    }
+                }
+            }
+            uint64_t count = static_cast<uint64_t>((bottom - top) * (right - left));
+            uint8_t *target = preview.pixels.data() + (static_cast<size_t>(y) * targetWidth + x) * PIXEL_BYTES;
+            for (int32_t channel = 0; channel < PIXEL_BYTES; ++channel) {
+                target[channel] = static_cast<uint8_t>((sums[channel] + count / 2) / count);
+            }
+        }
+    }
+    return true;
+}
+} // namespace UDMF
+} // namespace OHOS
@@ -0,0 +1,40 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_PREVIEW_UTILS_H
+#define UDMF_PREVIEW_UTILS_H
+
+#include <cstdint>
+#include <vector>
+
+#include "unified_data.h"
+#include "unified_types.h"
+
+namespace OHOS {
+namespace UDMF {
+class PreviewUtils {
+public:
+    // the longer side of a preview, so a preview takes at most 64 KB
+    static constexpr int32_t MAX_SIDE = 128;
+    static constexpr int32_t PIXEL_BYTES = 4;
+
+    // makes the preview of the first pixel map of the data, from the preview of its producer if it gives a valid one
+    static bool MakePreview(const UnifiedData &unifiedData, Preview &preview);
+    // averages the pixels of the source in boxes, the result fits in MAX_SIDE and keeps the aspect of the source
+    static bool Downscale(const std::vector<uint8_t> &pixels, int32_t width, int32_t height, Preview &preview);
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_PREVIEW_UTILS_H
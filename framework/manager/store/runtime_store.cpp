@@ -16,10 +16,22 @@
 #include "runtime_store.h"
 
 #include <algorithm>
+#include <cstdlib>
+#include <iomanip>
+#include <set>
+#include <sstream>
+#include <sys/stat.h>
+#include <unistd.h>
 #include <vector>
 
+#include "file_size_resolver.h"
 #include "logger.h"
+#include "openssl/sha.h"
+#include "preview_utils.h"
+#include "snapshot.h"
 #include "tlv_util.h"
+#include "udmf_memory.h"
+#include "udmf_tracer.h"
 
 namespace OHOS {
 namespace UDMF {
@@ -28,8 +40,73 @@ const std::string RuntimeStore::APP_ID = "distributeddata";
 const std::string RuntimeStore::DATA_PREFIX = "udmf://";
 const std::string RuntimeStore::BASE_DIR = "/data/service/el1/public/database/distributeddata/kvdb";
 const std::int32_t RuntimeStore::SLASH_COUNT_IN_KEY = 4;
+const std::string RuntimeStore::SUMMARY_SUFFIX = "/#summary";
+const std::string RuntimeStore::MANIFEST_SUFFIX = "/#manifest";
+const std::string RuntimeStore::VERSIONS_SUFFIX = "/#versions";
+const std::string RuntimeStore::BLOB_INFIX = "/#blob/";
+const std::string RuntimeStore::DIGEST_SUFFIX = "/#digest";
+const std::string RuntimeStore::PREVIEW_SUFFIX = "/#preview";
+const std::string RuntimeStore::INDEX_PREFIX = "udmf://#index/";
+const std::string RuntimeStore::TIME_INDEX = "time/";
+const std::string RuntimeStore::BUNDLE_INDEX = "bundle/";
+const std::string RuntimeStore::TYPE_INDEX = "type/";
+const size_t RuntimeStore::TIME_WIDTH = 20;
+const size_t RuntimeStore::MAX_BATCH_SIZE = 128;
+const int64_t RuntimeStore::PACKED_DATA_SIZE = 16 * 1024;
+const int32_t RuntimeStore::PACKED_MARKER = 0x50444D55;
+const std::string RuntimeStore::SNAPSHOT_SUFFIX = ".snapshot";
 
-RuntimeStore::RuntimeStore(std::string storeId) : delegateManager_(APP_ID, "default"), storeId_(storeId)
+template<typename T1, typename T2>
+static bool WritePairs(const std::vector<std::pair<T1, T2>> &pairs, std::vector<uint8_t> &bytes)
+{
+    auto tlv = TLVObject(bytes);
+    int32_t size = pairs.size();
+    tlv.Count(size);
+    for (const auto &[first, second] : pairs) {
+        tlv.Count(first);
+        tlv.Count(second);
+    }
+    tlv.UpdateSize();
+    if (!TLVUtil::Writing(size, tlv)) {
+        return false;
+    }
+    for (const auto &[first, second] : pairs) {
+        if (!TLVUtil::Writing(first, tlv) || !TLVUtil::Writing(second, tlv)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+template<typename T1, typename T2>
+static bool ReadPairs(std::vector<uint8_t> &bytes, std::vector<std::pair<T1, T2>> &pairs)
+{
+    auto tlv = TLVObject(bytes);
+    int32_t size;
+    if (!TLVUtil::Reading(size, tlv)) {
+        return false;
+    }
+    for (int32_t i = 0; i < size; ++i) {
+        T1 first;
+        T2 second;
+        if (!TLVUtil::Reading(first, tlv) || !TLVUtil::Reading(second, tlv)) {
+            return false;
+        }
+        pairs.emplace_back(first, second);
+    }
+    return true;
+}
+
+RuntimeStore::RuntimeStore(std::string storeId) : RuntimeStore(storeId, BASE_DIR)
+{
+}
+
+RuntimeStore::RuntimeStore(std::string storeId, std::string baseDir) : RuntimeStore(storeId, baseDir, DURABILITY_FULL)
+{
+}
+
+RuntimeStore::RuntimeStore(std::string storeId, std::string baseDir, Durability durability)
+    : delegateManager_(APP_ID, "default"), storeId_(storeId), baseDir_(baseDir), durability_(durability)
 {
     LOG_INFO(UDMF_SERVICE, "Construct runtimeStore: %{public}s.", storeId_.c_str());
 }
@@ -42,53 +119,87 @@ RuntimeStore::~RuntimeStore()
 
 Status RuntimeStore::Put(const UnifiedData &unifiedData)
 {
+    UDMF_TRACE_SPAN("store.Put");
     std::vector<Entry> entries;
-    std::string unifiedKey = unifiedData.GetRuntime()->key.GetUnifiedKey();
-    // add unified record
-    for (const auto &record : unifiedData.GetRecords()) {
-        if (record == nullptr) {
-            continue;
-        }
+    auto status = MarshalData(unifiedData, entries);
+    if (status != E_OK) {
+        return status;
+    }
+    return PutEntries(entries);
+}
 
-        std::vector<uint8_t> recordBytes;
-        auto recordTlv = TLVObject(recordBytes);
-        if (!TLVUtil::Writing(record, recordTlv)) {
-            LOG_ERROR(UDMF_SERVICE, "Marshall unified record failed.");
-            return E_INVALID_PARAMETERS;
+Status RuntimeStore::PutBatch(const std::vector<UnifiedData> &unifiedDatas)
+{
+    UDMF_TRACE_SPAN("store.PutBatch");
+    std::vector<Entry> entries;
+    for (const auto &unifiedData : unifiedDatas) {
+        auto status = MarshalData(unifiedData, entries);
+        if (status != E_OK) {
+            return status;
         }
-
-        std::string recordKeyStr = unifiedKey + "/" + record->GetUid();
-        Key recordKey = { recordKeyStr.begin(), recordKeyStr.end() };
-        Entry entry = { recordKey, recordBytes };
-        entries.push_back(entry);
     }
-    // add runtime info
-    std::vector<uint8_t> runtimeBytes;
-    auto runtimeTlv = TLVObject(runtimeBytes);
-    if (!TLVUtil::Writing(*unifiedData.GetRuntime(), runtimeTlv)) {
-        LOG_ERROR(UDMF_SERVICE, "Marshall runtime info failed.");
-        return E_UNKNOWN;
+    return Transact(entries, {});
+}
+
+Status RuntimeStore::PutRuntime(const UnifiedData &unifiedData)
+{
+    UDMF_TRACE_SPAN("store.PutRuntime");
+    std::vector<Entry> entries;
+    // the runtime info of packed data is rewritten together with the records packed beside it
+    std::string key = unifiedData.GetRuntime()->key.GetUnifiedKey();
+    auto status = GetPacked(key, nullptr, nullptr, nullptr) ? MarshalPacked(unifiedData, entries) :
+        MarshalRuntime(unifiedData, entries);
+    if (status != E_OK) {
+        return status;
     }
-    Key runtimeKey = { unifiedKey.begin(), unifiedKey.end() };
-    Entry entry = { runtimeKey, runtimeBytes };
-    entries.push_back(entry);
-    auto status = kvStore_->PutBatch(entries);
-    if (status != DBStatus::OK) {
-        LOG_ERROR(UDMF_SERVICE, "KvStore putBatch failed, status: %{public}d.", static_cast<int>(status));
-        return E_DB_ERROR;
+    return PutEntries(entries);
+}
+
+Status RuntimeStore::PutRecords(const UnifiedData &unifiedData)
+{
+    UDMF_TRACE_SPAN("store.PutRecords");
+    std::vector<Entry> entries;
+    auto status = MarshalRecords(unifiedData, entries);
+    if (status != E_OK) {
+        return status;
     }
-    return E_OK;
+    return PutEntries(entries);
 }
 
 Status RuntimeStore::Get(const std::string &key, UnifiedData &unifiedData)
 {
+    UDMF_TRACE_SPAN("store.Get");
+    // packed data is answered by a point lookup, only the large layout needs the prefix scan
+    if (GetPacked(key, &unifiedData, nullptr, nullptr)) {
+        return E_OK;
+    }
     std::vector<Entry> entries = GetEntries(key);
     if (entries.empty()) {
         LOG_ERROR(UDMF_FRAMEWORK, "KvStore getEntries failed, key: %{public}s.", key.c_str());
         return E_OK;
     }
+    MemoryCharge charge(MEMORY_KV_ENTRY, GetEntriesSize(entries));
     for (const auto &entry : entries) {
         std::string keyStr(entry.key.begin(), entry.key.end());
+        if (keyStr == key + SUMMARY_SUFFIX || keyStr == key + DIGEST_SUFFIX || keyStr == key + PREVIEW_SUFFIX) {
+            continue;
+        }
+        if (keyStr == key + MANIFEST_SUFFIX) {
+            Manifest manifest;
+            if (!ReadPairs(const_cast<std::vector<uint8_t> &>(entry.value), manifest)) {
+                LOG_ERROR(UDMF_SERVICE, "Unmarshall manifest failed.");
+                return E_UNKNOWN;
+            }
+            UnifiedKey unifiedKey(key);
+            if (!unifiedKey.IsValid()) {
+                return E_INVALID_PARAMETERS;
+            }
+            auto status = GetManifestRecords(manifest, GetBundlePrefix(unifiedKey), unifiedData);
+            if (status != E_OK) {
+                return status;
+            }
+            continue;
+        }
         if (keyStr == key) {
             Runtime runtime;
             auto runtimeTlv = TLVObject(const_cast<std::vector<uint8_t> &>(entry.value));
@@ -112,21 +223,55 @@ Status RuntimeStore::Get(const std::string &key, UnifiedData &unifiedData)
 
 Status RuntimeStore::GetSummary(const std::string &key, Summary &summary)
 {
+    UDMF_TRACE_SPAN("store.GetSummary");
+    std::string summaryKeyStr = key + SUMMARY_SUFFIX;
+    Key summaryKey = { summaryKeyStr.begin(), summaryKeyStr.end() };
+    Value value;
+    auto status = kvStore_->Get(summaryKey, value);
+    if (status == DBStatus::OK) {
+        auto summaryTlv = TLVObject(value);
+        if (TLVUtil::Reading(summary, summaryTlv)) {
+            return E_OK;
+        }
+        LOG_ERROR(UDMF_SERVICE, "Unmarshall summary failed, count it from records.");
+        summary = Summary();
+    } else if (status != DBStatus::NOT_FOUND) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore get summary failed, status: %{public}d.", static_cast<int>(status));
+    } else if (GetPacked(key, nullptr, &summary, nullptr)) {
+        return E_OK;
+    }
+
     UnifiedData unifiedData;
     if (Get(key, unifiedData) != E_OK) {
         LOG_ERROR(UDMF_SERVICE, "Get unified data failed.");
         return E_DB_ERROR;
     }
+    CountSummary(unifiedData, summary);
+    return E_OK;
+}
 
-    for (const auto &record : unifiedData.GetRecords()) {
-        int64_t recordSize = record->GetSize();
-        auto it = summary.summary.find(UD_TYPE_MAP.at(record->GetType()));
-        if (it == summary.summary.end()) {
-            summary.summary[UD_TYPE_MAP.at(record->GetType())] = recordSize;
-        } else {
-            summary.summary[UD_TYPE_MAP.at(record->GetType())] += recordSize;
+Status RuntimeStore::GetPreview(const std::string &key, Preview &preview)
+{
+    UDMF_TRACE_SPAN("store.GetPreview");
+    std::string previewKeyStr = key + PREVIEW_SUFFIX;
+    Value value;
+    auto status = kvStore_->Get({ previewKeyStr.begin(), previewKeyStr.end() }, value);
+    if (status == DBStatus::OK) {
+        auto previewTlv = TLVObject(value);
+        if (!TLVUtil::Reading(preview, previewTlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Unmarshall preview failed.");
+            return E_UNKNOWN;
         }
-        summary.totalSize += recordSize;
+        return E_OK;
+    }
+    if (status != DBStatus::NOT_FOUND) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore get preview failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    // packed data is small enough to make its preview on reading, a large data without the entry has no preview
+    UnifiedData unifiedData;
+    if (GetPacked(key, &unifiedData, nullptr, nullptr)) {
+        PreviewUtils::MakePreview(unifiedData, preview);
     }
     return E_OK;
 }
@@ -148,20 +293,34 @@ Status RuntimeStore::Update(const UnifiedData &unifiedData)
 
 Status RuntimeStore::Delete(const std::string &key)
 {
+    UDMF_TRACE_SPAN("store.Delete");
     std::vector<Entry> entries = GetEntries(key);
     if (entries.empty()) {
         LOG_INFO(UDMF_FRAMEWORK, "KvStore getEntries failed, key: %{public}s.", key.c_str());
         return E_OK;
     }
     std::vector<Key> keys;
+    Manifest manifest;
+    bool isVersion = false;
     for (const auto &entry : entries) {
         keys.push_back(entry.key);
+        std::string keyStr(entry.key.begin(), entry.key.end());
+        if (keyStr == key) {
+            AppendIndexKeys(key, keys);
+        }
+        if (keyStr == key + MANIFEST_SUFFIX) {
+            isVersion = ReadPairs(const_cast<std::vector<uint8_t> &>(entry.value), manifest);
+        }
+    }
+    if (isVersion) {
+        return DeleteVersion(key, manifest, keys);
     }
     auto status = kvStore_->DeleteBatch(keys);
     if (status != DBStatus::OK) {
         LOG_ERROR(UDMF_SERVICE, "DeleteBatch kvStore failed, status: %{public}d.", static_cast<int>(status));
         return E_DB_ERROR;
     }
+    MarkDirty();
     return E_OK;
 }
 
@@ -178,100 +337,1174 @@ Status RuntimeStore::DeleteBatch(std::vector<std::string> timeoutKeys)
     return status;
 }
 
-Status RuntimeStore::Sync(const std::vector<std::string> &devices)
+Status RuntimeStore::AppendRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record,
+    time_t modifiedTime, Summary &summary)
 {
-    auto onComplete = [this](const std::map<std::string, DBStatus> &) {
-        LOG_ERROR(UDMF_SERVICE, "Runtime kvStore sync complete.");
-    };
-    auto status = kvStore_->Sync(devices, SyncMode::SYNC_MODE_PUSH_ONLY, onComplete);
+    return UpdateRecord(key, record, false, modifiedTime, summary);
+}
+
+Status RuntimeStore::ReplaceRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record,
+    time_t modifiedTime, Summary &summary)
+{
+    return UpdateRecord(key, record, true, modifiedTime, summary);
+}
+
+Status RuntimeStore::UpdateRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record, bool replace,
+    time_t modifiedTime, Summary &summary)
+{
+    UDMF_TRACE_SPAN("store.UpdateRecord");
+    if (record == nullptr) {
+        return E_INVALID_PARAMETERS;
+    }
+    std::lock_guard<std::mutex> lock(recordMutex_);
+    Value value;
+    auto status = kvStore_->Get({ key.begin(), key.end() }, value);
     if (status != DBStatus::OK) {
-        LOG_ERROR(UDMF_SERVICE, "Sync kvStore failed, status: %{public}d.", static_cast<int>(status));
-        return E_DB_ERROR;
+        LOG_ERROR(UDMF_SERVICE, "KvStore get failed, status: %{public}d.", static_cast<int>(status));
+        return status == DBStatus::NOT_FOUND ? E_INVALID_PARAMETERS : E_DB_ERROR;
+    }
+    UnifiedData unifiedData;
+    if (ReadPacked(value, &unifiedData, nullptr, nullptr)) {
+        return UpdatePackedRecord(unifiedData, record, replace, modifiedTime, summary);
+    }
+    Runtime runtime;
+    auto runtimeTlv = TLVObject(value);
+    if (!TLVUtil::Reading(runtime, runtimeTlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshall runtime info failed.");
+        return E_UNKNOWN;
+    }
+    // the records of a version are shared with the other versions of its bundle
+    Manifest manifest;
+    if (GetManifest(key, manifest)) {
+        LOG_ERROR(UDMF_SERVICE, "Versioned data can not be updated, key: %{public}s.", key.c_str());
+        return E_INVALID_OPERATION;
+    }
+    return UpdateStoredRecord(key, runtime, record, replace, modifiedTime, summary);
+}
+
+Status RuntimeStore::UpdatePackedRecord(UnifiedData &unifiedData, const std::shared_ptr<UnifiedRecord> &record,
+    bool replace, time_t modifiedTime, Summary &summary)
+{
+    auto runtime = unifiedData.GetRuntime();
+    std::string key = runtime->key.GetUnifiedKey();
+    Summary oldSummary;
+    CountSummary(unifiedData, oldSummary);
+    std::vector<Key> keys;
+    for (const auto &indexKeyStr : GetIndexKeys(key, *runtime, oldSummary)) {
+        keys.push_back({ indexKeyStr.begin(), indexKeyStr.end() });
+    }
+
+    auto records = unifiedData.GetRecords();
+    if (replace) {
+        auto it = std::find_if(records.begin(), records.end(), [&record](const auto &item) {
+            return item != nullptr && item->GetUid() == record->GetUid();
+        });
+        if (it == records.end()) {
+            LOG_ERROR(UDMF_SERVICE, "Record not found, uid: %{public}s.", record->GetUid().c_str());
+            return E_INVALID_PARAMETERS;
+        }
+        *it = record;
+    } else {
+        records.push_back(record);
+    }
+    unifiedData.SetRecords(records);
+    // the modification time keeps increasing, so the version validator changes with every update
+    runtime->lastModifiedTime = std::max(modifiedTime, runtime->lastModifiedTime + 1);
+
+    // the whole data is one entry, which turns into the per record layout once the data outgrow the packed size
+    std::vector<Entry> entries;
+    auto status = MarshalData(unifiedData, entries);
+    if (status != E_OK) {
+        return status;
+    }
+    summary = Summary();
+    CountSummary(unifiedData, summary);
+    RemoveWrittenKeys(entries, keys);
+    return Transact(entries, keys);
+}
+
+Status RuntimeStore::UpdateStoredRecord(const std::string &key, Runtime &runtime,
+    const std::shared_ptr<UnifiedRecord> &record, bool replace, time_t modifiedTime, Summary &summary)
+{
+    std::string summaryKeyStr = key + SUMMARY_SUFFIX;
+    std::string digest;
+    if (GetSummary(key, summary) != E_OK || !GetDigest(key, digest)) {
+        LOG_ERROR(UDMF_SERVICE, "Get summary or digest failed, key: %{public}s.", key.c_str());
+        return E_UNKNOWN;
+    }
+    std::vector<Key> keys;
+    for (const auto &indexKeyStr : GetIndexKeys(key, runtime, summary)) {
+        keys.push_back({ indexKeyStr.begin(), indexKeyStr.end() });
+    }
+
+    std::string recordKeyStr = key + "/" + record->GetUid();
+    Key recordKey = { recordKeyStr.begin(), recordKeyStr.end() };
+    bool pixelMapChanged = record->GetType() == SYSTEM_DEFINED_PIXEL_MAP;
+    if (replace) {
+        Value oldValue;
+        if (kvStore_->Get(recordKey, oldValue) != DBStatus::OK) {
+            LOG_ERROR(UDMF_SERVICE, "Record not found, uid: %{public}s.", record->GetUid().c_str());
+            return E_INVALID_PARAMETERS;
+        }
+        std::shared_ptr<UnifiedRecord> oldRecord;
+        auto oldTlv = TLVObject(oldValue);
+        if (!TLVUtil::Reading(oldRecord, oldTlv) || oldRecord == nullptr) {
+            LOG_ERROR(UDMF_SERVICE, "Unmarshall unified record failed.");
+            return E_UNKNOWN;
+        }
+        pixelMapChanged = pixelMapChanged || oldRecord->GetType() == SYSTEM_DEFINED_PIXEL_MAP;
+        std::string oldType = UD_TYPE_MAP.at(oldRecord->GetType());
+        int64_t oldSize = FileSizeResolver::GetSummarySize(oldRecord);
+        summary.totalSize -= oldSize;
+        if ((summary.summary[oldType] -= oldSize) <= 0) {
+            summary.summary.erase(oldType);
+        }
+    }
+    std::vector<uint8_t> recordBytes;
+    auto recordTlv = TLVObject(recordBytes);
+    if (!TLVUtil::Writing(record, recordTlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall unified record failed.");
+        return E_INVALID_PARAMETERS;
+    }
+    bool otherPixelMaps = summary.summary.find(UD_TYPE_MAP.at(SYSTEM_DEFINED_PIXEL_MAP)) != summary.summary.end();
+    int64_t recordSize = FileSizeResolver::GetSummarySize(record);
+    summary.summary[UD_TYPE_MAP.at(record->GetType())] += recordSize;
+    summary.totalSize += recordSize;
+    runtime.lastModifiedTime = std::max(modifiedTime, runtime.lastModifiedTime + 1);
+
+    std::vector<uint8_t> runtimeBytes;
+    auto runtimeTlv = TLVObject(runtimeBytes);
+    std::vector<uint8_t> summaryBytes;
+    auto summaryTlv = TLVObject(summaryBytes);
+    if (!TLVUtil::Writing(runtime, runtimeTlv) || !TLVUtil::Writing(summary, summaryTlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall runtime info failed.");
+        return E_UNKNOWN;
+    }
+    // the digest is chained with the written record, so it changes without reading the other records
+    std::vector<uint8_t> digestBytes(digest.begin(), digest.end());
+    digestBytes.insert(digestBytes.end(), recordBytes.begin(), recordBytes.end());
+    digest = Digest(digestBytes);
+    std::string digestKeyStr = key + DIGEST_SUFFIX;
+    std::vector<Entry> entries = {
+        { recordKey, recordBytes },
+        { { key.begin(), key.end() }, runtimeBytes },
+        { { summaryKeyStr.begin(), summaryKeyStr.end() }, summaryBytes },
+        { { digestKeyStr.begin(), digestKeyStr.end() }, { digest.begin(), digest.end() } },
+    };
+    for (const auto &indexKeyStr : GetIndexKeys(key, runtime, summary)) {
+        entries.push_back({ { indexKeyStr.begin(), indexKeyStr.end() }, { key.begin(), key.end() } });
+    }
+    // the preview is made of the first pixel map, which the written record may be or may have been
+    if (pixelMapChanged) {
+        auto status = UpdatePreview(key, record, otherPixelMaps, entries, keys);
+        if (status != E_OK) {
+            return status;
+        }
+    }
+    RemoveWrittenKeys(entries, keys);
+    return Transact(entries, keys);
+}
+
+Status RuntimeStore::UpdatePreview(const std::string &key, const std::shared_ptr<UnifiedRecord> &record,
+    bool otherPixelMaps, std::vector<Entry> &entries, std::vector<Key> &keys)
+{
+    UnifiedData unifiedData;
+    if (otherPixelMaps) {
+        // the records are read in the order of their uids, the written one is put in its place among them
+        auto status = Get(key, unifiedData);
+        if (status != E_OK) {
+            return status;
+        }
+        auto records = unifiedData.GetRecords();
+        records.erase(std::remove_if(records.begin(), records.end(), [&record](const auto &item) {
+            return item == nullptr || item->GetUid() == record->GetUid();
+        }), records.end());
+        auto it = std::find_if(records.begin(), records.end(),
+            [&record](const auto &item) { return item->GetUid() > record->GetUid(); });
+        records.insert(it, record);
+        unifiedData.SetRecords(records);
+    } else {
+        // no other pixel map is left, the preview is the one of the written record if any
+        unifiedData.AddRecord(record);
+    }
+    size_t count = entries.size();
+    auto status = MarshalPreview(key, unifiedData, entries);
+    if (status != E_OK) {
+        return status;
+    }
+    if (entries.size() == count) {
+        std::string previewKeyStr = key + PREVIEW_SUFFIX;
+        keys.push_back({ previewKeyStr.begin(), previewKeyStr.end() });
     }
     return E_OK;
 }
 
-Status RuntimeStore::Clear()
+int64_t RuntimeStore::GetEntriesSize(const std::vector<Entry> &entries)
 {
-    return Delete(DATA_PREFIX) != E_DB_ERROR ? E_OK : E_DB_ERROR;
+    int64_t size = 0;
+    for (const auto &entry : entries) {
+        size += static_cast<int64_t>(entry.key.size() + entry.value.size());
+    }
+    return size;
 }
 
-void RuntimeStore::Close()
+void RuntimeStore::RemoveWrittenKeys(const std::vector<Entry> &entries, std::vector<Key> &keys)
 {
-    delegateManager_.CloseKvStore(kvStore_.get());
+    keys.erase(std::remove_if(keys.begin(), keys.end(), [&entries](const Key &key) {
+        return std::any_of(entries.begin(), entries.end(), [&key](const Entry &entry) { return entry.key == key; });
+    }), keys.end());
 }
 
-bool RuntimeStore::Init()
+Status RuntimeStore::PutVersion(const UnifiedData &unifiedData, uint32_t maxVersions)
 {
-    KvStoreConfig kvStoreConfig{ BASE_DIR };
-    delegateManager_.SetKvStoreConfig(kvStoreConfig);
+    UDMF_TRACE_SPAN("store.PutVersion");
+    std::lock_guard<std::mutex> lock(versionMutex_);
+    auto runtime = unifiedData.GetRuntime();
+    std::string key = runtime->key.GetUnifiedKey();
+    std::string bundlePrefix = GetBundlePrefix(runtime->key);
+    Versions versions;
+    if (!GetVersions(bundlePrefix, versions)) {
+        return E_DB_ERROR;
+    }
+    std::map<std::string, int32_t> references;
+    CountReferences(versions, references);
 
-    DBStatus dbStatusTmp = DBStatus::NOT_SUPPORT;
-    KvStoreNbDelegate::Option option;
-    option.createIfNecessary = true;
-    option.isMemoryDb = false;
-    option.createDirByStoreIdOnly = true;
-    option.isEncryptedDb = false;
-    option.isNeedRmCorruptedDb = true;
-    option.syncDualTupleMode = true;
-    int32_t securityLevel = 2;
-    option.secOption = { securityLevel, DistributedDB::ECE };
-    DistributedDB::KvStoreNbDelegate *delegate = nullptr;
-    delegateManager_.GetKvStore(storeId_, option,
-        [&delegate, &dbStatusTmp](DBStatus dbStatus, KvStoreNbDelegate *nbDelegate) {
-            delegate = nbDelegate;
-            dbStatusTmp = dbStatus;
-        });
-    if (dbStatusTmp != DBStatus::OK) {
-        LOG_ERROR(UDMF_SERVICE, "GetKvStore return error status: %{public}d.", static_cast<int>(dbStatusTmp));
-        return false;
+    std::vector<Entry> entries;
+    std::vector<Key> keys;
+    // records are stored once by digest and shared by all versions referring to them
+    Manifest manifest;
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr) {
+            continue;
+        }
+        // the blob is written without the uid, which is kept in the manifest, so equal records share a digest
+        std::vector<uint8_t> recordBytes;
+        auto recordTlv = TLVObject(recordBytes);
+        if (!TLVUtil::Writing(record, "", recordTlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Marshall unified record failed.");
+            return E_INVALID_PARAMETERS;
+        }
+        std::string digest = Digest(recordBytes);
+        manifest.emplace_back(record->GetUid(), digest);
+        if (references[digest]++ == 0) {
+            std::string blobKeyStr = bundlePrefix + BLOB_INFIX + digest;
+            entries.push_back({ { blobKeyStr.begin(), blobKeyStr.end() }, recordBytes });
+        }
+    }
+    std::vector<uint8_t> manifestBytes;
+    if (!WritePairs(manifest, manifestBytes)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall manifest failed.");
+        return E_UNKNOWN;
     }
+    std::string manifestKeyStr = key + MANIFEST_SUFFIX;
+    entries.push_back({ { manifestKeyStr.begin(), manifestKeyStr.end() }, manifestBytes });
+    // the manifest holds the uid and the digest of every record, so its digest stands for the records
+    std::string digest = Digest(manifestBytes);
+    std::string digestKeyStr = key + DIGEST_SUFFIX;
+    entries.push_back({ { digestKeyStr.begin(), digestKeyStr.end() }, { digest.begin(), digest.end() } });
 
-    auto release = [this](KvStoreNbDelegate *delegate) {
-        LOG_INFO(UDMF_SERVICE, "Release runtime kvStore.");
-        if (delegate == nullptr) {
-            return;
+    // the previous latest version turns into history
+    Runtime previous;
+    if (!versions.empty() && GetRuntime(versions.back().second, previous)) {
+        previous.dataStatus = DataStatus::HISTORY;
+        std::vector<uint8_t> runtimeBytes;
+        auto runtimeTlv = TLVObject(runtimeBytes);
+        if (TLVUtil::Writing(previous, runtimeTlv)) {
+            std::string previousKey = versions.back().second;
+            entries.push_back({ { previousKey.begin(), previousKey.end() }, runtimeBytes });
         }
+    }
+    runtime->dataVersion = versions.empty() ? 1 : versions.back().first + 1;
+    runtime->dataStatus = DataStatus::WORKING;
+    auto status = MarshalRuntime(unifiedData, entries);
+    if (status != E_OK) {
+        return status;
+    }
 
-        auto result = delegateManager_.CloseKvStore(delegate);
-        if (result != DBStatus::OK) {
-            LOG_ERROR(UDMF_SERVICE, "Close runtime kvStore return error status: %{public}d", static_cast<int>(result));
+    versions.emplace_back(runtime->dataVersion, key);
+    std::set<std::string> evictedDigests;
+    while (versions.size() > maxVersions) {
+        std::string evictedKey = versions.front().second;
+        Manifest evicted;
+        if (GetManifest(evictedKey, evicted)) {
+            for (const auto &item : evicted) {
+                references[item.second]--;
+                evictedDigests.insert(item.second);
+            }
         }
-    };
-    kvStore_ = std::shared_ptr<KvStoreNbDelegate>(delegate, release);
-    return true;
+        AppendIndexKeys(evictedKey, keys);
+        for (const auto &keyStr : { evictedKey, evictedKey + SUMMARY_SUFFIX, evictedKey + MANIFEST_SUFFIX,
+            evictedKey + DIGEST_SUFFIX, evictedKey + PREVIEW_SUFFIX }) {
+            keys.push_back({ keyStr.begin(), keyStr.end() });
+        }
+        versions.erase(versions.begin());
+    }
+    for (const auto &digest : evictedDigests) {
+        if (references[digest] <= 0) {
+            std::string blobKeyStr = bundlePrefix + BLOB_INFIX + digest;
+            keys.push_back({ blobKeyStr.begin(), blobKeyStr.end() });
+        }
+    }
+    std::vector<uint8_t> versionsBytes;
+    if (!WritePairs(versions, versionsBytes)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall versions failed.");
+        return E_UNKNOWN;
+    }
+    std::string versionsKeyStr = bundlePrefix + VERSIONS_SUFFIX;
+    entries.push_back({ { versionsKeyStr.begin(), versionsKeyStr.end() }, versionsBytes });
+    return Transact(entries, keys);
 }
 
-std::vector<UnifiedData> RuntimeStore::GetDatas(const std::string &dataPrefix)
+Status RuntimeStore::GetVersionKey(const std::string &key, int32_t version, std::string &versionKey)
 {
-    std::vector<UnifiedData> unifiedDatas;
-    auto entries = GetEntries(dataPrefix);
-    if (entries.empty()) {
-        LOG_INFO(UDMF_FRAMEWORK, "entries is empty.");
-        return unifiedDatas;
+    UnifiedKey unifiedKey(key);
+    if (!unifiedKey.IsValid()) {
+        return E_INVALID_PARAMETERS;
     }
-    for (const auto &entry : entries) {
-        UnifiedData data;
-        std::string keyStr(entry.key.begin(), entry.key.end());
-        if (std::count(keyStr.begin(), keyStr.end(), '/') == SLASH_COUNT_IN_KEY) {
-            Get(keyStr, data);
-            unifiedDatas.push_back(data);
+    Versions versions;
+    if (!GetVersions(GetBundlePrefix(unifiedKey), versions)) {
+        return E_DB_ERROR;
+    }
+    versionKey.clear();
+    if (versions.empty()) {
+        return E_OK;
+    }
+    if (version < 0) {
+        auto it = std::find_if(versions.begin(), versions.end(),
+            [&key](const auto &item) { return item.second == key; });
+        if (it == versions.end()) {
+            return E_OK;
         }
+        version += it->first;
     }
-    return unifiedDatas;
+    // versions deleted from the middle of the ring leave gaps, so the version is searched for
+    auto it = std::find_if(versions.begin(), versions.end(),
+        [version](const auto &item) { return item.first == version; });
+    if (it != versions.end()) {
+        versionKey = it->second;
+    }
+    return E_OK;
 }
 
-std::vector<Entry> RuntimeStore::GetEntries(const std::string &dataPrefix)
+Status RuntimeStore::QueryKeys(QueryCondition &condition, const std::function<bool(const std::string &)> &filter,
+    std::vector<std::string> &keys)
 {
-    Query dbQuery = Query::Select();
-    std::vector<uint8_t> prefix = { dataPrefix.begin(), dataPrefix.end() };
-    dbQuery.PrefixKey(prefix);
-    std::vector<Entry> entries;
-    auto status = kvStore_->GetEntries(dbQuery, entries);
-    if (status == DBStatus::NOT_FOUND || status != DBStatus::OK) {
-        LOG_ERROR(UDMF_SERVICE, "KvStore getEntries failed, status: %{public}d.", static_cast<int>(status));
+    std::string prefix = GetIndexPrefix(condition);
+    if (!condition.cursor.empty() && condition.cursor.compare(0, prefix.size(), prefix) != 0) {
+        LOG_ERROR(UDMF_SERVICE, "Cursor does not match the condition.");
+        return E_INVALID_PARAMETERS;
     }
-    return entries;
+    std::string begin = condition.cursor.empty() ? prefix + FormatTime(condition.beginTime) : condition.cursor;
+    // '0' sorts after the '/' following the time, so the index keys at the end time are all before it
+    std::string end = prefix + FormatTime(condition.endTime) + "0";
+    // the cursor is the last index key of the previous page, so the page starts after it
+    bool afterCursor = !condition.cursor.empty();
+    condition.cursor.clear();
+
+    KvStoreResultSet *resultSet = nullptr;
+    auto status = kvStore_->GetEntries(Key(prefix.begin(), prefix.end()), resultSet);
+    if (status == DBStatus::NOT_FOUND) {
+        return E_OK;
+    }
+    if (status != DBStatus::OK || resultSet == nullptr) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore get result set failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    auto isBefore = [&begin, afterCursor](const std::string &keyStr) {
+        return afterCursor ? keyStr <= begin : keyStr < begin;
+    };
+    Status result = E_OK;
+    Entry entry;
+    // the result set is ordered by key, so the first index of the page is found by bisection
+    int32_t count = resultSet->GetCount();
+    int32_t low = 0;
+    int32_t high = count;
+    while (low < high) {
+        int32_t mid = low + (high - low) / 2;
+        if (!resultSet->MoveToPosition(mid) || resultSet->GetEntry(entry) != DBStatus::OK) {
+            result = E_DB_ERROR;
+            break;
+        }
+        if (isBefore(std::string(entry.key.begin(), entry.key.end()))) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    for (int32_t pos = low; result == E_OK && pos < count; ++pos) {
+        if (!resultSet->MoveToPosition(pos) || resultSet->GetEntry(entry) != DBStatus::OK) {
+            result = E_DB_ERROR;
+            break;
+        }
+        std::string keyStr(entry.key.begin(), entry.key.end());
+        if (keyStr >= end) {
+            break;
+        }
+        std::string dataKey(entry.value.begin(), entry.value.end());
+        // the type index does not tell the bundle, it is checked by the key of the data
+        if (condition.type != UD_BUTT && !condition.bundleName.empty()) {
+            UnifiedKey unifiedKey(dataKey);
+            if (!unifiedKey.IsValid() || unifiedKey.bundleName != condition.bundleName) {
+                continue;
+            }
+        }
+        if (filter != nullptr && !filter(dataKey)) {
+            continue;
+        }
+        keys.push_back(dataKey);
+        if (keys.size() >= static_cast<size_t>(condition.pageSize)) {
+            condition.cursor = pos + 1 < count ? keyStr : "";
+            break;
+        }
+    }
+    kvStore_->CloseResultSet(resultSet);
+    if (result != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore read result set failed.");
+        keys.clear();
+    }
+    return result;
+}
+
+Status RuntimeStore::Sync(const std::vector<std::string> &devices)
+{
+    auto onComplete = [this](const std::map<std::string, DBStatus> &) {
+        LOG_ERROR(UDMF_SERVICE, "Runtime kvStore sync complete.");
+    };
+    auto status = kvStore_->Sync(devices, SyncMode::SYNC_MODE_PUSH_ONLY, onComplete);
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "Sync kvStore failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    return E_OK;
+}
+
+Status RuntimeStore::Clear()
+{
+    return Delete(DATA_PREFIX) != E_DB_ERROR ? E_OK : E_DB_ERROR;
+}
+
+Status RuntimeStore::Export(const std::string &path)
+{
+    auto entries = GetEntries(DATA_PREFIX);
+    MemoryCharge charge(MEMORY_KV_ENTRY, GetEntriesSize(entries));
+    auto status = Snapshot::Write(path, std::move(entries));
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "Export snapshot failed, store: %{public}s.", storeId_.c_str());
+    }
+    return status;
+}
+
+Status RuntimeStore::Import(const std::string &path)
+{
+    SnapshotReader reader;
+    auto result = reader.Open(path);
+    if (result != E_OK) {
+        return result;
+    }
+    auto status = kvStore_->StartTransaction();
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore start transaction failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    // entries are copied from the mapping batch by batch, so the whole snapshot is never decoded or held at once
+    std::vector<Entry> entries;
+    for (uint32_t index = 0; index < reader.Count() && status == DBStatus::OK; ++index) {
+        SnapshotReader::Slice key;
+        SnapshotReader::Slice value;
+        if (!reader.GetEntry(index, key, value)) {
+            status = DBStatus::INVALID_ARGS;
+            break;
+        }
+        entries.push_back({ { key.data, key.data + key.size }, { value.data, value.data + value.size } });
+        if (entries.size() >= MAX_BATCH_SIZE || index + 1 == reader.Count()) {
+            status = kvStore_->PutBatch(entries);
+            entries.clear();
+        }
+    }
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "Import snapshot failed, status: %{public}d.", static_cast<int>(status));
+        kvStore_->Rollback();
+        return E_DB_ERROR;
+    }
+    status = kvStore_->Commit();
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore commit failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    MarkDirty();
+    return E_OK;
+}
+
+Status RuntimeStore::GetStats(StoreStats &stats)
+{
+    stats.flushCount = flushCount_.load();
+    stats.flushedBytes = flushedBytes_.load();
+    KvStoreResultSet *resultSet = nullptr;
+    auto status = kvStore_->GetEntries(Key(DATA_PREFIX.begin(), DATA_PREFIX.end()), resultSet);
+    if (status == DBStatus::NOT_FOUND) {
+        return E_OK;
+    }
+    if (status != DBStatus::OK || resultSet == nullptr) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore get result set failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    // every data has one time index, and the time index keys are in the order of creation
+    std::string timePrefix = INDEX_PREFIX + TIME_INDEX;
+    std::vector<std::string> keys;
+    Entry entry;
+    while (resultSet->MoveToNext()) {
+        if (resultSet->GetEntry(entry) != DBStatus::OK) {
+            continue;
+        }
+        stats.entryCount++;
+        stats.entryBytes += static_cast<int64_t>(entry.key.size() + entry.value.size());
+        std::string keyStr(entry.key.begin(), entry.key.end());
+        if (keyStr.compare(0, timePrefix.size(), timePrefix) != 0) {
+            continue;
+        }
+        if (keys.empty()) {
+            stats.oldestTime = static_cast<time_t>(std::strtoll(keyStr.substr(timePrefix.size(), TIME_WIDTH).c_str(),
+                nullptr, 10));
+        }
+        keys.emplace_back(entry.value.begin(), entry.value.end());
+    }
+    kvStore_->CloseResultSet(resultSet);
+    stats.dataCount = static_cast<int64_t>(keys.size());
+    for (const auto &key : keys) {
+        Summary summary;
+        if (GetSummary(key, summary) != E_OK) {
+            continue;
+        }
+        for (const auto &[type, size] : summary.summary) {
+            stats.typeBytes[type] += size;
+        }
+    }
+    return E_OK;
+}
+
+Status RuntimeStore::Flush()
+{
+    if (durability_ != DURABILITY_RELAXED || kvStore_ == nullptr) {
+        return E_OK;
+    }
+    int64_t dirtyTime = dirtyTime_.load();
+    if (dirtyTime == 0) {
+        return E_OK;
+    }
+    // a snapshot holds the whole store, so it is written once the writes pause instead of every interval
+    std::chrono::microseconds idleTime(Tracer::Now() - writeTime_.load());
+    std::chrono::microseconds dirtyAge(Tracer::Now() - dirtyTime);
+    if (idleTime < FLUSH_IDLE_TIME && dirtyAge < MAX_FLUSH_DELAY) {
+        return E_OK;
+    }
+    return WriteSnapshot();
+}
+
+Status RuntimeStore::WriteSnapshot()
+{
+    if (durability_ != DURABILITY_RELAXED || kvStore_ == nullptr) {
+        return E_OK;
+    }
+    std::lock_guard<std::mutex> lock(flushMutex_);
+    // the writes made during the export mark the store again, so they are flushed by the next flush
+    int64_t dirtyTime = dirtyTime_.exchange(0);
+    if (dirtyTime == 0) {
+        return E_OK;
+    }
+    UDMF_TRACE_SPAN("store.Flush");
+    std::string path = baseDir_ + "/" + storeId_ + SNAPSHOT_SUFFIX;
+    auto status = Export(path);
+    if (status != E_OK) {
+        int64_t clean = 0;
+        dirtyTime_.compare_exchange_strong(clean, dirtyTime);
+        return status;
+    }
+    struct stat fileStat = {};
+    if (stat(path.c_str(), &fileStat) == 0) {
+        flushedBytes_ += static_cast<int64_t>(fileStat.st_size);
+    }
+    flushCount_++;
+    return E_OK;
+}
+
+void RuntimeStore::MarkDirty()
+{
+    int64_t now = Tracer::Now();
+    writeTime_.store(now);
+    int64_t clean = 0;
+    dirtyTime_.compare_exchange_strong(clean, now);
+}
+
+void RuntimeStore::Close()
+{
+    // the relaxed store is written out while it is still open, then the deleter of the delegate closes it, only once
+    WriteSnapshot();
+    kvStore_.reset();
+}
+
+bool RuntimeStore::Init()
+{
+    KvStoreConfig kvStoreConfig{ baseDir_ };
+    delegateManager_.SetKvStoreConfig(kvStoreConfig);
+
+    DBStatus dbStatusTmp = DBStatus::NOT_SUPPORT;
+    KvStoreNbDelegate::Option option;
+    option.createIfNecessary = true;
+    // a relaxed store lives in memory and is kept on the disk by the snapshots of its flushes
+    option.isMemoryDb = durability_ != DURABILITY_FULL;
+    option.createDirByStoreIdOnly = true;
+    option.isEncryptedDb = false;
+    option.isNeedRmCorruptedDb = true;
+    option.syncDualTupleMode = true;
+    int32_t securityLevel = 2;
+    option.secOption = { securityLevel, DistributedDB::ECE };
+    DistributedDB::KvStoreNbDelegate *delegate = nullptr;
+    delegateManager_.GetKvStore(storeId_, option,
+        [&delegate, &dbStatusTmp](DBStatus dbStatus, KvStoreNbDelegate *nbDelegate) {
+            delegate = nbDelegate;
+            dbStatusTmp = dbStatus;
+        });
+    if (dbStatusTmp != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "GetKvStore return error status: %{public}d.", static_cast<int>(dbStatusTmp));
+        return false;
+    }
+
+    auto release = [this](KvStoreNbDelegate *delegate) {
+        LOG_INFO(UDMF_SERVICE, "Release runtime kvStore.");
+        if (delegate == nullptr) {
+            return;
+        }
+
+        auto result = delegateManager_.CloseKvStore(delegate);
+        if (result != DBStatus::OK) {
+            LOG_ERROR(UDMF_SERVICE, "Close runtime kvStore return error status: %{public}d", static_cast<int>(result));
+        }
+    };
+    kvStore_ = std::shared_ptr<KvStoreNbDelegate>(delegate, release);
+    std::string snapshotPath = baseDir_ + "/" + storeId_ + SNAPSHOT_SUFFIX;
+    if (durability_ == DURABILITY_RELAXED && access(snapshotPath.c_str(), F_OK) == 0 &&
+        Import(snapshotPath) != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "Load snapshot failed, store: %{public}s.", storeId_.c_str());
+    }
+    dirtyTime_.store(0);
+    return true;
+}
+
+std::vector<UnifiedData> RuntimeStore::GetDatas(const std::string &dataPrefix)
+{
+    std::vector<UnifiedData> unifiedDatas;
+    auto entries = GetEntries(dataPrefix);
+    if (entries.empty()) {
+        LOG_INFO(UDMF_FRAMEWORK, "entries is empty.");
+        return unifiedDatas;
+    }
+    MemoryCharge charge(MEMORY_KV_ENTRY, GetEntriesSize(entries));
+    for (const auto &entry : entries) {
+        UnifiedData data;
+        std::string keyStr(entry.key.begin(), entry.key.end());
+        // keys with '#' hold summaries, manifests and histories, which are not unified data
+        if (keyStr.find('#') != std::string::npos) {
+            continue;
+        }
+        if (std::count(keyStr.begin(), keyStr.end(), '/') == SLASH_COUNT_IN_KEY) {
+            Get(keyStr, data);
+            unifiedDatas.push_back(data);
+        }
+    }
+    return unifiedDatas;
+}
+
+std::vector<Entry> RuntimeStore::GetEntries(const std::string &dataPrefix)
+{
+    Query dbQuery = Query::Select();
+    std::vector<uint8_t> prefix = { dataPrefix.begin(), dataPrefix.end() };
+    dbQuery.PrefixKey(prefix);
+    std::vector<Entry> entries;
+    auto status = kvStore_->GetEntries(dbQuery, entries);
+    if (status == DBStatus::NOT_FOUND || status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore getEntries failed, status: %{public}d.", static_cast<int>(status));
+    }
+    return entries;
+}
+
+void RuntimeStore::CountSummary(const UnifiedData &unifiedData, Summary &summary)
+{
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr) {
+            continue;
+        }
+        int64_t recordSize = FileSizeResolver::GetSummarySize(record);
+        summary.summary[UD_TYPE_MAP.at(record->GetType())] += recordSize;
+        summary.totalSize += recordSize;
+    }
+}
+
+Status RuntimeStore::MarshalRecords(const UnifiedData &unifiedData, std::vector<Entry> &entries)
+{
+    std::string unifiedKey = unifiedData.GetRuntime()->key.GetUnifiedKey();
+    SHA256_CTX context;
+    SHA256_Init(&context);
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr) {
+            continue;
+        }
+
+        std::vector<uint8_t> recordBytes;
+        auto recordTlv = TLVObject(recordBytes);
+        if (!TLVUtil::Writing(record, recordTlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Marshall unified record failed.");
+            return E_INVALID_PARAMETERS;
+        }
+        SHA256_Update(&context, recordBytes.data(), recordBytes.size());
+
+        std::string recordKeyStr = unifiedKey + "/" + record->GetUid();
+        Key recordKey = { recordKeyStr.begin(), recordKeyStr.end() };
+        Entry entry = { recordKey, recordBytes };
+        entries.push_back(entry);
+    }
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA256_Final(hash, &context);
+    std::string digest = ToHex(hash, sizeof(hash));
+    std::string digestKeyStr = unifiedKey + DIGEST_SUFFIX;
+    entries.push_back({ { digestKeyStr.begin(), digestKeyStr.end() }, { digest.begin(), digest.end() } });
+    return E_OK;
+}
+
+Status RuntimeStore::MarshalRuntime(const UnifiedData &unifiedData, std::vector<Entry> &entries)
+{
+    std::string unifiedKey = unifiedData.GetRuntime()->key.GetUnifiedKey();
+    std::vector<uint8_t> runtimeBytes;
+    auto runtimeTlv = TLVObject(runtimeBytes);
+    if (!TLVUtil::Writing(*unifiedData.GetRuntime(), runtimeTlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall runtime info failed.");
+        return E_UNKNOWN;
+    }
+    Key runtimeKey = { unifiedKey.begin(), unifiedKey.end() };
+    entries.push_back({ runtimeKey, runtimeBytes });
+
+    // the summary is kept beside the runtime, so it can be served before the records are written
+    Summary summary;
+    CountSummary(unifiedData, summary);
+    std::vector<uint8_t> summaryBytes;
+    auto summaryTlv = TLVObject(summaryBytes);
+    if (!TLVUtil::Writing(summary, summaryTlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall summary failed.");
+        return E_UNKNOWN;
+    }
+    std::string summaryKeyStr = unifiedKey + SUMMARY_SUFFIX;
+    Key summaryKey = { summaryKeyStr.begin(), summaryKeyStr.end() };
+    entries.push_back({ summaryKey, summaryBytes });
+
+    // so is the preview, which a hovering target reads instead of the records
+    auto status = MarshalPreview(unifiedKey, unifiedData, entries);
+    if (status != E_OK) {
+        return status;
+    }
+
+    for (const auto &indexKeyStr : GetIndexKeys(unifiedKey, *unifiedData.GetRuntime(), summary)) {
+        entries.push_back({ { indexKeyStr.begin(), indexKeyStr.end() }, { unifiedKey.begin(), unifiedKey.end() } });
+    }
+    return E_OK;
+}
+
+Status RuntimeStore::MarshalPreview(const std::string &key, const UnifiedData &unifiedData,
+    std::vector<Entry> &entries)
+{
+    Preview preview;
+    if (!PreviewUtils::MakePreview(unifiedData, preview)) {
+        return E_OK;
+    }
+    std::vector<uint8_t> previewBytes;
+    auto previewTlv = TLVObject(previewBytes);
+    if (!TLVUtil::Writing(preview, previewTlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall preview failed.");
+        return E_UNKNOWN;
+    }
+    std::string previewKeyStr = key + PREVIEW_SUFFIX;
+    entries.push_back({ { previewKeyStr.begin(), previewKeyStr.end() }, previewBytes });
+    return E_OK;
+}
+
+Status RuntimeStore::MarshalData(const UnifiedData &unifiedData, std::vector<Entry> &entries)
+{
+    // small data is packed into the entry of its key, so it is written and read with a single key; the files the
+    // data refers to are not in it, so they do not count
+    int64_t size = 0;
+    for (const auto &record : unifiedData.GetRecords()) {
+        size += record == nullptr ? 0 : record->GetSize();
+    }
+    if (size <= PACKED_DATA_SIZE) {
+        return MarshalPacked(unifiedData, entries);
+    }
+    auto status = MarshalRecords(unifiedData, entries);
+    if (status != E_OK) {
+        return status;
+    }
+    return MarshalRuntime(unifiedData, entries);
+}
+
+Status RuntimeStore::MarshalPacked(const UnifiedData &unifiedData, std::vector<Entry> &entries)
+{
+    auto runtime = unifiedData.GetRuntime();
+    std::string unifiedKey = runtime->key.GetUnifiedKey();
+    std::vector<std::vector<uint8_t>> records;
+    SHA256_CTX context;
+    SHA256_Init(&context);
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr) {
+            continue;
+        }
+        std::vector<uint8_t> recordBytes;
+        auto recordTlv = TLVObject(recordBytes);
+        if (!TLVUtil::Writing(record, recordTlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Marshall unified record failed.");
+            return E_INVALID_PARAMETERS;
+        }
+        SHA256_Update(&context, recordBytes.data(), recordBytes.size());
+        records.push_back(std::move(recordBytes));
+    }
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA256_Final(hash, &context);
+    std::string digest = ToHex(hash, sizeof(hash));
+    Summary summary;
+    CountSummary(unifiedData, summary);
+
+    // runtime info | marker | summary | digest | count of records | records
+    std::vector<uint8_t> bytes;
+    auto tlv = TLVObject(bytes);
+    if (!TLVUtil::Writing(*runtime, tlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall runtime info failed.");
+        return E_UNKNOWN;
+    }
+    tlv.Count(PACKED_MARKER);
+    tlv.UpdateSize();
+    if (!TLVUtil::Writing(PACKED_MARKER, tlv) || !TLVUtil::Writing(summary, tlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall summary failed.");
+        return E_UNKNOWN;
+    }
+    int32_t count = records.size();
+    tlv.Count(digest);
+    tlv.Count(count);
+    for (const auto &recordBytes : records) {
+        tlv.Count(recordBytes);
+    }
+    tlv.UpdateSize();
+    bool result = TLVUtil::Writing(digest, tlv) && TLVUtil::Writing(count, tlv);
+    for (auto it = records.begin(); result && it != records.end(); ++it) {
+        result = TLVUtil::Writing(*it, tlv);
+    }
+    if (!result) {
+        LOG_ERROR(UDMF_SERVICE, "Marshall packed data failed.");
+        return E_UNKNOWN;
+    }
+    entries.push_back({ { unifiedKey.begin(), unifiedKey.end() }, bytes });
+    for (const auto &indexKeyStr : GetIndexKeys(unifiedKey, *runtime, summary)) {
+        entries.push_back({ { indexKeyStr.begin(), indexKeyStr.end() }, { unifiedKey.begin(), unifiedKey.end() } });
+    }
+    return E_OK;
+}
+
+bool RuntimeStore::ReadPacked(std::vector<uint8_t> &value, UnifiedData *unifiedData, Summary *summary,
+    std::string *digest)
+{
+    auto tlv = TLVObject(value);
+    Runtime runtime;
+    if (!TLVUtil::Reading(runtime, tlv)) {
+        return false;
+    }
+    // the runtime info of the large data layout is followed by nothing but zero padding, never by the marker
+    int32_t marker = 0;
+    if (!TLVUtil::Reading(marker, tlv) || marker != PACKED_MARKER) {
+        return false;
+    }
+    Summary packedSummary;
+    std::string packedDigest;
+    int32_t count = 0;
+    if (!TLVUtil::Reading(packedSummary, tlv) || !TLVUtil::Reading(packedDigest, tlv) ||
+        !TLVUtil::Reading(count, tlv)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshall packed data failed.");
+        return false;
+    }
+    if (summary != nullptr) {
+        *summary = std::move(packedSummary);
+    }
+    if (digest != nullptr) {
+        *digest = std::move(packedDigest);
+    }
+    if (unifiedData == nullptr) {
+        return true;
+    }
+    std::vector<std::shared_ptr<UnifiedRecord>> records;
+    for (int32_t i = 0; i < count; ++i) {
+        std::vector<uint8_t> recordBytes;
+        std::shared_ptr<UnifiedRecord> record;
+        if (!TLVUtil::Reading(recordBytes, tlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Unmarshall packed record failed.");
+            return false;
+        }
+        auto recordTlv = TLVObject(recordBytes);
+        if (!TLVUtil::Reading(record, recordTlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Unmarshall unified record failed.");
+            return false;
+        }
+        records.push_back(record);
+    }
+    for (const auto &record : records) {
+        unifiedData->AddRecord(record);
+    }
+    unifiedData->SetRuntime(runtime);
+    return true;
+}
+
+bool RuntimeStore::GetPacked(const std::string &key, UnifiedData *unifiedData, Summary *summary,
+    std::string *digest)
+{
+    Value value;
+    auto status = kvStore_->Get({ key.begin(), key.end() }, value);
+    if (status != DBStatus::OK) {
+        return false;
+    }
+    MemoryCharge charge(MEMORY_KV_ENTRY, static_cast<int64_t>(value.size()));
+    return ReadPacked(value, unifiedData, summary, digest);
+}
+
+Status RuntimeStore::PutEntries(const std::vector<Entry> &entries)
+{
+    // the marshalled buffers of the data are all held until they are written
+    MemoryCharge charge(MEMORY_TLV_BUFFER, GetEntriesSize(entries));
+    auto status = kvStore_->PutBatch(entries);
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore putBatch failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    MarkDirty();
+    return E_OK;
+}
+
+Status RuntimeStore::Transact(const std::vector<Entry> &entries, const std::vector<Key> &keys)
+{
+    MemoryCharge charge(MEMORY_TLV_BUFFER, GetEntriesSize(entries));
+    auto status = kvStore_->StartTransaction();
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore start transaction failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    // a single put batch of the store takes a bounded number of entries
+    for (size_t begin = 0; begin < entries.size() && status == DBStatus::OK; begin += MAX_BATCH_SIZE) {
+        size_t end = std::min(begin + MAX_BATCH_SIZE, entries.size());
+        status = kvStore_->PutBatch(std::vector<Entry>(entries.begin() + begin, entries.begin() + end));
+    }
+    if (status == DBStatus::OK && !keys.empty()) {
+        status = kvStore_->DeleteBatch(keys);
+    }
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore write in transaction failed, status: %{public}d.", static_cast<int>(status));
+        kvStore_->Rollback();
+        return E_DB_ERROR;
+    }
+    status = kvStore_->Commit();
+    if (status != DBStatus::OK) {
+        LOG_ERROR(UDMF_SERVICE, "KvStore commit failed, status: %{public}d.", static_cast<int>(status));
+        return E_DB_ERROR;
+    }
+    MarkDirty();
+    return E_OK;
+}
+
+Status RuntimeStore::DeleteVersion(const std::string &key, const Manifest &manifest, std::vector<Key> &keys)
+{
+    std::lock_guard<std::mutex> lock(versionMutex_);
+    UnifiedKey unifiedKey(key);
+    if (!unifiedKey.IsValid()) {
+        return E_INVALID_PARAMETERS;
+    }
+    std::string bundlePrefix = GetBundlePrefix(unifiedKey);
+    Versions versions;
+    if (!GetVersions(bundlePrefix, versions)) {
+        return E_DB_ERROR;
+    }
+    versions.erase(std::remove_if(versions.begin(), versions.end(),
+        [&key](const auto &version) { return version.second == key; }), versions.end());
+    std::map<std::string, int32_t> references;
+    CountReferences(versions, references);
+    std::set<std::string> digests;
+    for (const auto &item : manifest) {
+        if (references.find(item.second) == references.end() && digests.insert(item.second).second) {
+            std::string blobKeyStr = bundlePrefix + BLOB_INFIX + item.second;
+            keys.push_back({ blobKeyStr.begin(), blobKeyStr.end() });
+        }
+    }
+    std::vector<Entry> entries;
+    std::string versionsKeyStr = bundlePrefix + VERSIONS_SUFFIX;
+    Key versionsKey = { versionsKeyStr.begin(), versionsKeyStr.end() };
+    if (versions.empty()) {
+        keys.push_back(versionsKey);
+    } else {
+        std::vector<uint8_t> versionsBytes;
+        if (!WritePairs(versions, versionsBytes)) {
+            LOG_ERROR(UDMF_SERVICE, "Marshall versions failed.");
+            return E_UNKNOWN;
+        }
+        entries.push_back({ versionsKey, versionsBytes });
+    }
+    return Transact(entries, keys);
+}
+
+Status RuntimeStore::GetManifestRecords(const Manifest &manifest, const std::string &bundlePrefix,
+    UnifiedData &unifiedData)
+{
+    for (const auto &[uid, digest] : manifest) {
+        std::string blobKeyStr = bundlePrefix + BLOB_INFIX + digest;
+        Value value;
+        auto status = kvStore_->Get({ blobKeyStr.begin(), blobKeyStr.end() }, value);
+        if (status != DBStatus::OK) {
+            LOG_ERROR(UDMF_SERVICE, "KvStore get record blob failed, status: %{public}d.", static_cast<int>(status));
+            return E_DB_ERROR;
+        }
+        std::shared_ptr<UnifiedRecord> record;
+        auto recordTlv = TLVObject(value);
+        if (!TLVUtil::Reading(record, recordTlv)) {
+            LOG_ERROR(UDMF_SERVICE, "Unmarshall unified record failed.");
+            return E_UNKNOWN;
+        }
+        record->SetUid(uid);
+        unifiedData.AddRecord(record);
+    }
+    return E_OK;
+}
+
+bool RuntimeStore::GetRuntime(const std::string &key, Runtime &runtime)
+{
+    Value value;
+    auto status = kvStore_->Get({ key.begin(), key.end() }, value);
+    if (status != DBStatus::OK) {
+        return false;
+    }
+    auto runtimeTlv = TLVObject(value);
+    return TLVUtil::Reading(runtime, runtimeTlv);
+}
+
+bool RuntimeStore::GetDigest(const std::string &key, std::string &digest)
+{
+    std::string digestKeyStr = key + DIGEST_SUFFIX;
+    Value value;
+    auto status = kvStore_->Get({ digestKeyStr.begin(), digestKeyStr.end() }, value);
+    if (status == DBStatus::NOT_FOUND) {
+        return GetPacked(key, nullptr, nullptr, &digest);
+    }
+    if (status != DBStatus::OK) {
+        return false;
+    }
+    digest.assign(value.begin(), value.end());
+    return true;
+}
+
+bool RuntimeStore::GetVersions(const std::string &bundlePrefix, Versions &versions)
+{
+    std::string versionsKeyStr = bundlePrefix + VERSIONS_SUFFIX;
+    Value value;
+    auto status = kvStore_->Get({ versionsKeyStr.begin(), versionsKeyStr.end() }, value);
+    if (status == DBStatus::NOT_FOUND) {
+        return true;
+    }
+    if (status != DBStatus::OK || !ReadPairs(value, versions)) {
+        LOG_ERROR(UDMF_SERVICE, "Get versions failed, status: %{public}d.", static_cast<int>(status));
+        return false;
+    }
+    return true;
+}
+
+bool RuntimeStore::GetManifest(const std::string &key, Manifest &manifest)
+{
+    std::string manifestKeyStr = key + MANIFEST_SUFFIX;
+    Value value;
+    auto status = kvStore_->Get({ manifestKeyStr.begin(), manifestKeyStr.end() }, value);
+    if (status != DBStatus::OK) {
+        return false;
+    }
+    return ReadPairs(value, manifest);
+}
+
+void RuntimeStore::CountReferences(const Versions &versions, std::map<std::string, int32_t> &references)
+{
+    for (const auto &version : versions) {
+        Manifest manifest;
+        if (!GetManifest(version.second, manifest)) {
+            continue;
+        }
+        for (const auto &item : manifest) {
+            references[item.second]++;
+        }
+    }
+}
+
+void RuntimeStore::AppendIndexKeys(const std::string &key, std::vector<Key> &keys)
+{
+    Runtime runtime;
+    Summary summary;
+    if (!GetRuntime(key, runtime) || GetSummary(key, summary) != E_OK) {
+        return;
+    }
+    for (const auto &indexKeyStr : GetIndexKeys(key, runtime, summary)) {
+        keys.push_back({ indexKeyStr.begin(), indexKeyStr.end() });
+    }
+}
+
+std::vector<std::string> RuntimeStore::GetIndexKeys(const std::string &key, const Runtime &runtime,
+    const Summary &summary)
+{
+    // index keys end with the creation time and the unified key, so a prefix scan returns them in time order
+    std::string suffix = FormatTime(runtime.createTime) + "/" + key;
+    std::vector<std::string> indexKeys = {
+        INDEX_PREFIX + TIME_INDEX + suffix,
+        INDEX_PREFIX + BUNDLE_INDEX + runtime.key.bundleName + "/" + suffix,
+    };
+    for (const auto &item : summary.summary) {
+        indexKeys.push_back(INDEX_PREFIX + TYPE_INDEX + item.first + "/" + suffix);
+    }
+    return indexKeys;
+}
+
+std::string RuntimeStore::GetIndexPrefix(const QueryCondition &condition)
+{
+    if (condition.type != UD_BUTT) {
+        return INDEX_PREFIX + TYPE_INDEX + UD_TYPE_MAP.at(condition.type) + "/";
+    }
+    if (!condition.bundleName.empty()) {
+        return INDEX_PREFIX + BUNDLE_INDEX + condition.bundleName + "/";
+    }
+    return INDEX_PREFIX + TIME_INDEX;
+}
+
+std::string RuntimeStore::FormatTime(time_t time)
+{
+    std::ostringstream oss;
+    oss << std::setw(TIME_WIDTH) << std::setfill('0') << std::max<int64_t>(time, 0);
+    return oss.str();
+}
+
+std::string RuntimeStore::GetBundlePrefix(const UnifiedKey &key)
+{
+    return DATA_PREFIX + key.intention + "/" + key.bundleName;
+}
+
+std::string RuntimeStore::Digest(const std::vector<uint8_t> &bytes)
+{
+    unsigned char hash[SHA256_DIGEST_LENGTH];
+    SHA256(bytes.data(), bytes.size(), hash);
+    return ToHex(hash, sizeof(hash));
+}
+
+std::string RuntimeStore::ToHex(const unsigned char *hash, size_t size)
+{
+    static constexpr char HEX_CHARS[] = "0123456789abcdef";
+    std::string hex;
+    hex.reserve(size * 2);
+    for (size_t i = 0; i < size; ++i) {
+        hex.push_back(HEX_CHARS[hash[i] >> 4]);
+        hex.push_back(HEX_CHARS[hash[i] & 0x0F]);
+    }
+    return hex;
 }
 } // namespace UDMF
 } // namespace OHOS
\ No newline at end of file
@@ -16,6 +16,10 @@
 #ifndef UDMF_RUNTIMESTORE_H
 #define UDMF_RUNTIMESTORE_H
 
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
 #include "kv_store_delegate_manager.h"
 #include "store.h"
 
@@ -23,16 +27,42 @@ namespace OHOS {
 namespace UDMF {
 class RuntimeStore final : public Store {
 public:
+    static const std::string BASE_DIR;
+    // a relaxed store is flushed once it has had no write for FLUSH_IDLE_TIME, or has held unflushed writes for
+    // MAX_FLUSH_DELAY under steady writes
+    static constexpr std::chrono::milliseconds FLUSH_IDLE_TIME = std::chrono::milliseconds(1000);
+    static constexpr std::chrono::milliseconds MAX_FLUSH_DELAY = std::chrono::milliseconds(30000);
+
     explicit RuntimeStore(std::string storeId);
+    RuntimeStore(std::string storeId, std::string baseDir);
+    RuntimeStore(std::string storeId, std::string baseDir, Durability durability);
     ~RuntimeStore();
     Status Put(const UnifiedData &unifiedData) override;
+    Status PutBatch(const std::vector<UnifiedData> &unifiedDatas) override;
+    Status PutRuntime(const UnifiedData &unifiedData) override;
+    Status PutRecords(const UnifiedData &unifiedData) override;
+    Status AppendRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record, time_t modifiedTime,
+        Summary &summary) override;
+    Status ReplaceRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record, time_t modifiedTime,
+        Summary &summary) override;
+    Status PutVersion(const UnifiedData &unifiedData, uint32_t maxVersions) override;
+    Status GetVersionKey(const std::string &key, int32_t version, std::string &versionKey) override;
     Status Get(const std::string &key, UnifiedData &unifiedData) override;
     Status GetSummary(const std::string &key, Summary &summary) override;
+    Status GetPreview(const std::string &key, Preview &preview) override;
+    bool GetRuntime(const std::string &key, Runtime &runtime) override;
+    bool GetDigest(const std::string &key, std::string &digest) override;
+    Status QueryKeys(QueryCondition &condition, const std::function<bool(const std::string &)> &filter,
+        std::vector<std::string> &keys) override;
     Status Update(const UnifiedData &unifiedData) override;
     Status Delete(const std::string &key) override;
     Status DeleteBatch(std::vector<std::string> timeoutKeys) override;
     Status Sync(const std::vector<std::string> &devices) override;
     Status Clear() override;
+    Status Export(const std::string &path) override;
+    Status Import(const std::string &path) override;
+    Status GetStats(StoreStats &stats) override;
+    Status Flush() override;
     void Close() override;
     bool Init() override;
     std::vector<UnifiedData> GetDatas(const std::string &dataPrefix) override;
@@ -40,12 +70,79 @@ public:
 private:
     static const std::string APP_ID;
     static const std::string DATA_PREFIX;
-    static const std::string BASE_DIR;
     static const std::int32_t SLASH_COUNT_IN_KEY;
+    static const std::string SUMMARY_SUFFIX;
+    static const std::string MANIFEST_SUFFIX;
+    static const std::string VERSIONS_SUFFIX;
+    static const std::string BLOB_INFIX;
+    static const std::string DIGEST_SUFFIX;
+    static const std::string PREVIEW_SUFFIX;
+    static const std::string INDEX_PREFIX;
+    static const std::string TIME_INDEX;
+    static const std::string BUNDLE_INDEX;
+    static const std::string TYPE_INDEX;
+    static const size_t TIME_WIDTH;
+    static const size_t MAX_BATCH_SIZE;
+    static const int64_t PACKED_DATA_SIZE;
+    static const int32_t PACKED_MARKER;
+    static const std::string SNAPSHOT_SUFFIX;
+    // version and unified key of the versions in the history of a bundle, from the oldest to the latest
+    using Versions = std::vector<std::pair<int32_t, std::string>>;
+    // record uid and digest of the shared record blob, in the order of the records
+    using Manifest = std::vector<std::pair<std::string, std::string>>;
     DistributedDB::KvStoreDelegateManager delegateManager_;
     std::shared_ptr<DistributedDB::KvStoreNbDelegate> kvStore_;
     std::string storeId_;
+    std::string baseDir_;
+    Durability durability_ = DURABILITY_FULL;
+    // microseconds of the first write not flushed yet, 0 once all writes are flushed
+    std::atomic<int64_t> dirtyTime_{ 0 };
+    // microseconds of the last write
+    std::atomic<int64_t> writeTime_{ 0 };
+    std::atomic<int64_t> flushCount_{ 0 };
+    std::atomic<int64_t> flushedBytes_{ 0 };
+    std::mutex flushMutex_;
+    std::mutex versionMutex_;
+    std::mutex recordMutex_;
+    void MarkDirty();
+    // writes the snapshot of a relaxed store at once if it has unflushed writes
+    Status WriteSnapshot();
     std::vector<DistributedDB::Entry> GetEntries(const std::string &dataPrefix);
+    static void CountSummary(const UnifiedData &unifiedData, Summary &summary);
+    Status MarshalRecords(const UnifiedData &unifiedData, std::vector<DistributedDB::Entry> &entries);
+    Status MarshalRuntime(const UnifiedData &unifiedData, std::vector<DistributedDB::Entry> &entries);
+    static Status MarshalPreview(const std::string &key, const UnifiedData &unifiedData,
+        std::vector<DistributedDB::Entry> &entries);
+    Status MarshalData(const UnifiedData &unifiedData, std::vector<DistributedDB::Entry> &entries);
+    Status MarshalPacked(const UnifiedData &unifiedData, std::vector<DistributedDB::Entry> &entries);
+    bool ReadPacked(std::vector<uint8_t> &value, UnifiedData *unifiedData, Summary *summary, std::string *digest);
+    bool GetPacked(const std::string &key, UnifiedData *unifiedData, Summary *summary, std::string *digest);
+    Status UpdateRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record, bool replace,
+        time_t modifiedTime, Summary &summary);
+    Status UpdatePackedRecord(UnifiedData &unifiedData, const std::shared_ptr<UnifiedRecord> &record, bool replace,
+        time_t modifiedTime, Summary &summary);
+    Status UpdateStoredRecord(const std::string &key, Runtime &runtime, const std::shared_ptr<UnifiedRecord> &record,
+        bool replace, time_t modifiedTime, Summary &summary);
+    Status UpdatePreview(const std::string &key, const std::shared_ptr<UnifiedRecord> &record, bool otherPixelMaps,
+        std::vector<DistributedDB::Entry> &entries, std::vector<DistributedDB::Key> &keys);
+    static int64_t GetEntriesSize(const std::vector<DistributedDB::Entry> &entries);
+    static void RemoveWrittenKeys(const std::vector<DistributedDB::Entry> &entries,
+        std::vector<DistributedDB::Key> &keys);
+    Status PutEntries(const std::vector<DistributedDB::Entry> &entries);
+    Status Transact(const std::vector<DistributedDB::Entry> &entries, const std::vector<DistributedDB::Key> &keys);
+    Status DeleteVersion(const std::string &key, const Manifest &manifest, std::vector<DistributedDB::Key> &keys);
+    Status GetManifestRecords(const Manifest &manifest, const std::string &bundlePrefix, UnifiedData &unifiedData);
+    bool GetVersions(const std::string &bundlePrefix, Versions &versions);
+    bool GetManifest(const std::string &key, Manifest &manifest);
+    void CountReferences(const Versions &versions, std::map<std::string, int32_t> &references);
+    void AppendIndexKeys(const std::string &key, std::vector<DistributedDB::Key> &keys);
+    static std::vector<std::string> GetIndexKeys(const std::string &key, const Runtime &runtime,
+        const Summary &summary);
+    static std::string GetIndexPrefix(const QueryCondition &condition);
+    static std::string FormatTime(time_t time);
+    static std::string GetBundlePrefix(const UnifiedKey &key);
+    static std::string Digest(const std::vector<uint8_t> &bytes);
+    static std::string ToHex(const unsigned char *hash, size_t size);
 };
 } // namespace UDMF
 } // namespace OHOS
@@ -0,0 +1,229 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "snapshot.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "endian_converter.h"
+#include "logger.h"
+
+namespace OHOS {
+namespace UDMF {
+template<typename T>
+static void Append(std::vector<uint8_t> &buffer, T value)
+{
+    value = HostToNet(value);
+    auto bytes = reinterpret_cast<const uint8_t *>(&value);
+    buffer.insert(buffer.end(), bytes, bytes + sizeof(T));
+}
+
+static bool WriteAll(int fd, const uint8_t *data, size_t size)
+{
+    while (size > 0) {
+        ssize_t written = write(fd, data, size);
+        if (written < 0 && errno == EINTR) {
+            continue;
+        }
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+    return true;
+}
+
+Status Snapshot::Write(const std::string &path, std::vector<DistributedDB::Entry> entries)
+{
+    std::sort(entries.begin(), entries.end(),
+        [](const DistributedDB::Entry &left, const DistributedDB::Entry &right) { return left.key < right.key; });
+    uint64_t dataOffset = HEADER_SIZE + ITEM_SIZE * entries.size();
+    uint64_t fileSize = dataOffset;
+    for (const auto &entry : entries) {
+        if (entry.key.size() > UINT32_MAX || entry.value.size() > UINT32_MAX) {
+            LOG_ERROR(UDMF_SERVICE, "Entry too large for snapshot.");
+            return E_INVALID_PARAMETERS;
+        }
+        fileSize += entry.key.size() + entry.value.size();
+    }
+
+    std::vector<uint8_t> head;
+    head.reserve(dataOffset);
+    head.insert(head.end(), MAGIC, MAGIC + sizeof(MAGIC) - 1);
+    Append(head, VERSION);
+    Append(head, static_cast<uint32_t>(entries.size()));
+    Append(head, dataOffset);
+    Append(head, fileSize);
+    uint64_t offset = dataOffset;
+    for (const auto &entry : entries) {
+        Append(head, offset);
+        Append(head, offset + entry.key.size());
+        Append(head, static_cast<uint32_t>(entry.key.size()));
+        Append(head, static_cast<uint32_t>(entry.value.size()));
+        offset += entry.key.size() + entry.value.size();
+    }
+
+    std::string tempPath = path + ".tmp";
+    int fd = open(tempPath.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, S_IRUSR | S_IWUSR);
+    if (fd < 0) {
+        LOG_ERROR(UDMF_SERVICE, "Open snapshot failed, errno: %{public}d.", errno);
+        return E_ERROR;
+    }
+    bool result = WriteAll(fd, head.data(), head.size());
+    for (auto it = entries.begin(); result && it != entries.end(); ++it) {
+        result = WriteAll(fd, it->key.data(), it->key.size()) && WriteAll(fd, it->value.data(), it->value.size());
+    }
+    result = result && fsync(fd) == 0;
+    close(fd);
+    if (!result || rename(tempPath.c_str(), path.c_str()) != 0) {
+        LOG_ERROR(UDMF_SERVICE, "Write snapshot failed, errno: %{public}d.", errno);
+        unlink(tempPath.c_str());
+        return E_ERROR;
+    }
+    return E_OK;
+}
+
+SnapshotReader::~SnapshotReader()
+{
+    Close();
+}
+
+Status SnapshotReader::Open(const std::string &path)
+{
+    Close();
+    int fd = open(path.c_str(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        LOG_ERROR(UDMF_SERVICE, "Open snapshot failed, errno: %{public}d.", errno);
+        return E_ERROR;
+    }
+    struct stat fileStat {};
+    if (fstat(fd, &fileStat) != 0 || fileStat.st_size < static_cast<off_t>(Snapshot::HEADER_SIZE)) {
+        LOG_ERROR(UDMF_SERVICE, "Invalid snapshot size.");
+        close(fd);
+        return E_INVALID_PARAMETERS;
+    }
+    void *addr = mmap(nullptr, fileStat.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        LOG_ERROR(UDMF_SERVICE, "Map snapshot failed, errno: %{public}d.", errno);
+        return E_ERROR;
+    }
+    base_ = static_cast<const uint8_t *>(addr);
+    size_ = static_cast<size_t>(fileStat.st_size);
+
+    size_t offset = sizeof(Snapshot::MAGIC) - 1;
+    auto version = ReadAt<uint32_t>(offset);
+    count_ = ReadAt<uint32_t>(offset + sizeof(uint32_t));
+    auto dataOffset = ReadAt<uint64_t>(offset + sizeof(uint32_t) * 2);
+    auto fileSize = ReadAt<uint64_t>(offset + sizeof(uint32_t) * 2 + sizeof(uint64_t));
+    if (memcmp(base_, Snapshot::MAGIC, offset) != 0 || version != Snapshot::VERSION || fileSize != size_ ||
+        dataOffset != Snapshot::HEADER_SIZE + Snapshot::ITEM_SIZE * static_cast<uint64_t>(count_) ||
+        dataOffset > size_) {
+        LOG_ERROR(UDMF_SERVICE, "Invalid snapshot header, version: %{public}u.", version);
+        Close();
+        return E_INVALID_PARAMETERS;
+    }
+    return E_OK;
+}
+
+void SnapshotReader::Close()
+{
+    if (base_ != nullptr) {
+        munmap(const_cast<uint8_t *>(base_), size_);
+    }
+    base_ = nullptr;
+    size_ = 0;
+    count_ = 0;
+}
+
+uint32_t SnapshotReader::Count() const
+{
+    return count_;
+}
+
+bool SnapshotReader::GetEntry(uint32_t index, Slice &key, Slice &value) const
+{
+    if (!GetKey(index, key)) {
+        return false;
+    }
+    size_t item = Snapshot::HEADER_SIZE + Snapshot::ITEM_SIZE * index;
+    auto valueOffset = ReadAt<uint64_t>(item + sizeof(uint64_t));
+    auto valueSize = ReadAt<uint32_t>(item + sizeof(uint64_t) * 2 + sizeof(uint32_t));
+    if (valueOffset > size_ || valueSize > size_ - valueOffset) {
+        LOG_ERROR(UDMF_SERVICE, "Snapshot value out of range, index: %{public}u.", index);
+        return false;
+    }
+    value = { base_ + valueOffset, valueSize };
+    return true;
+}
+
+bool SnapshotReader::Find(const std::string &key, Slice &value) const
+{
+    // the index is sorted by key, so the entry is found by bisection
+    uint32_t low = 0;
+    uint32_t high = count_;
+    while (low < high) {
+        uint32_t mid = low + (high - low) / 2;
+        Slice midKey;
+        if (!GetKey(mid, midKey)) {
+            return false;
+        }
+        int result = memcmp(midKey.data, key.data(), std::min(midKey.size, key.size()));
+        if (result == 0 && midKey.size == key.size()) {
+            Slice ignored;
+            return GetEntry(mid, ignored, value);
+        }
+        if (result < 0 || (result == 0 && midKey.size < key.size())) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+    return false;
+}
+
+template<typename T>
+T SnapshotReader::ReadAt(size_t offset) const
+{
+    T value;
+    memcpy(&value, base_ + offset, sizeof(T));
+    return NetToHost(value);
+}
+
+bool SnapshotReader::GetKey(uint32_t index, Slice &key) const
+{
+    if (base_ == nullptr || index >= count_) {
+        return false;
+    }
+    size_t item = Snapshot::HEADER_SIZE + Snapshot::ITEM_SIZE * index;
+    auto keyOffset = ReadAt<uint64_t>(item);
+    auto keySize = ReadAt<uint32_t>(item + sizeof(uint64_t) * 2);
+    if (keyOffset > size_ || keySize > size_ - keyOffset) {
+        LOG_ERROR(UDMF_SERVICE, "Snapshot key out of range, index: %{public}u.", index);
+        return false;
+    }
+    key = { base_ + keyOffset, keySize };
+    return true;
+}
+} // namespace UDMF
+} // namespace OHOS
\ No newline at end of file
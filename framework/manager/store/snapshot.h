@@ -0,0 +1,80 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_SNAPSHOT_H
+#define UDMF_SNAPSHOT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "error_code.h"
+#include "store_types.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * Snapshot file of the raw entries of a store, laid out as
+ *     | header | index items sorted by key | keys and values |
+ * Values keep the TLV encoding of the store, so a snapshot is written and loaded without decoding the data.
+ * All integers are little endian.
+ */
+class Snapshot {
+public:
+    static constexpr char MAGIC[] = "UDMFSNAP";
+    static constexpr uint32_t VERSION = 1;
+    // magic, version, count of entries, offset of the keys and values, size of the file
+    static constexpr size_t HEADER_SIZE = 8 + sizeof(uint32_t) * 2 + sizeof(uint64_t) * 2;
+    // offset of the key, offset of the value, size of the key, size of the value
+    static constexpr size_t ITEM_SIZE = sizeof(uint64_t) * 2 + sizeof(uint32_t) * 2;
+
+    // writes to a temporary file first, which replaces the file at path once it is complete
+    static Status Write(const std::string &path, std::vector<DistributedDB::Entry> entries);
+};
+
+/*
+ * Reads a snapshot through a read-only mapping of the file; keys and values are views into the mapping.
+ */
+class SnapshotReader {
+public:
+    struct Slice {
+        const uint8_t *data = nullptr;
+        size_t size = 0;
+    };
+
+    SnapshotReader() = default;
+    ~SnapshotReader();
+    SnapshotReader(const SnapshotReader &) = delete;
+    SnapshotReader &operator=(const SnapshotReader &) = delete;
+
+    Status Open(const std::string &path);
+    void Close();
+    uint32_t Count() const;
+    // the slices stay valid until the reader is closed
+    bool GetEntry(uint32_t index, Slice &key, Slice &value) const;
+    bool Find(const std::string &key, Slice &value) const;
+
+private:
+    template<typename T>
+    T ReadAt(size_t offset) const;
+    bool GetKey(uint32_t index, Slice &key) const;
+
+    const uint8_t *base_ = nullptr;
+    size_t size_ = 0;
+    uint32_t count_ = 0;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_SNAPSHOT_H
\ No newline at end of file
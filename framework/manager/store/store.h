@@ -16,6 +16,9 @@
 #ifndef UDMF_STORE_H
 #define UDMF_STORE_H
 
+#include <ctime>
+#include <functional>
+#include <map>
 #include <string>
 #include "error_code.h"
 #include "unified_types.h"
@@ -24,16 +27,73 @@
 
 namespace OHOS {
 namespace UDMF {
+struct StoreStats {
+    int64_t dataCount = 0;
+    // all entries of the store, including the summaries, digests and indexes beside the data
+    int64_t entryCount = 0;
+    int64_t entryBytes = 0;
+    // creation time of the oldest data in milliseconds since the epoch, 0 if there is no data
+    time_t oldestTime = 0;
+    // bytes of the records of each type, by the summaries of the data
+    std::map<std::string, int64_t> typeBytes;
+    // snapshots written in the background by the flushes of a relaxed store since it was opened, and their bytes
+    int64_t flushCount = 0;
+    int64_t flushedBytes = 0;
+};
+
+// how far the writes of a store survive a restart of the service
+enum Durability : int32_t {
+    // kept in memory only, lost when the service stops
+    DURABILITY_MEMORY = 0,
+    // kept in memory and written to a snapshot file by Flush once the writes pause, the writes since the last flush
+    // are lost on a crash
+    DURABILITY_RELAXED,
+    // written to the database file before the write returns
+    DURABILITY_FULL,
+};
+
 class Store {
 public:
     virtual Status Put(const UnifiedData &unifiedData) = 0;
+    // puts all the data in one transaction, either all of them are written or none
+    virtual Status PutBatch(const std::vector<UnifiedData> &unifiedDatas) = 0;
+    // writes the runtime info and the summary only, the records are written later by PutRecords
+    virtual Status PutRuntime(const UnifiedData &unifiedData) = 0;
+    virtual Status PutRecords(const UnifiedData &unifiedData) = 0;
+    // appends a record to the stored data, writing the record and the runtime info, summary and digest of the data
+    virtual Status AppendRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record,
+        time_t modifiedTime, Summary &summary) = 0;
+    // replaces the record of the same uid in the stored data, the rest of the data is left as it is
+    virtual Status ReplaceRecord(const std::string &key, const std::shared_ptr<UnifiedRecord> &record,
+        time_t modifiedTime, Summary &summary) = 0;
+    // puts the data as the latest version of its bundle, keeping at most maxVersions versions
+    virtual Status PutVersion(const UnifiedData &unifiedData, uint32_t maxVersions) = 0;
+    // finds the key of the given version in the history of the key's bundle, empty if the version is gone
+    virtual Status GetVersionKey(const std::string &key, int32_t version, std::string &versionKey) = 0;
     virtual Status Get(const std::string &key, UnifiedData &unifiedData) = 0;
     virtual Status GetSummary(const std::string &key, Summary &summary) = 0;
+    // reads the preview written with the runtime info, an empty preview if the data has none
+    virtual Status GetPreview(const std::string &key, Preview &preview) = 0;
+    virtual bool GetRuntime(const std::string &key, Runtime &runtime) = 0;
+    // reads the digest of the stored records, which is written together with the records
+    virtual bool GetDigest(const std::string &key, std::string &digest) = 0;
+    // finds a page of keys by the indexes of the store, the keys rejected by the filter are skipped
+    virtual Status QueryKeys(QueryCondition &condition, const std::function<bool(const std::string &)> &filter,
+        std::vector<std::string> &keys) = 0;
     virtual Status Update(const UnifiedData &unifiedData) = 0;
     virtual Status Delete(const std::string &key) = 0;
     virtual Status DeleteBatch(std::vector<std::string> timeoutKeys) = 0;
     virtual Status Sync(const std::vector<std::string> &devices) = 0;
     virtual Status Clear() = 0;
+    // writes all entries of the store to a snapshot file
+    virtual Status Export(const std::string &path) = 0;
+    // puts all entries of a snapshot file into the store, replacing the entries with the same keys
+    virtual Status Import(const std::string &path) = 0;
+    // scans the whole store, for the dump of the service only
+    virtual Status GetStats(StoreStats &stats) = 0;
+    // writes the changes of a relaxed store to the disk once its writes pause, nothing for the other levels; Close
+    // writes them at once
+    virtual Status Flush() = 0;
     virtual bool Init() = 0;
     virtual void Close() = 0;
     virtual std::vector<UnifiedData> GetDatas(const std::string &dataPrefix) = 0;
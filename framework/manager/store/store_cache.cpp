@@ -15,33 +15,107 @@
 
 #include "store_cache.h"
 
+#include <cinttypes>
+
 #include "logger.h"
 #include "runtime_store.h"
+#include "udmf_tracer.h"
 #include "unified_meta.h"
 
 namespace OHOS {
 namespace UDMF {
+ConcurrentMap<std::string, std::shared_future<std::shared_ptr<Store>>> StoreCache::stores_;
+ConcurrentMap<std::string, int64_t> StoreCache::openTimes_;
+std::string StoreCache::baseDir_;
+const std::map<std::string, Durability> StoreCache::DURABILITY_MAP = {
+    { UD_INTENTION_MAP.at(UD_INTENTION_DRAG), DURABILITY_MEMORY },
+    { UD_INTENTION_MAP.at(UD_INTENTION_SYS), DURABILITY_FULL },
+    { UD_INTENTION_MAP.at(UD_INTENTION_SHARE), DURABILITY_RELAXED },
+};
+
 std::shared_ptr<Store> StoreCache::GetStore(std::string intention)
 {
-    std::shared_ptr<Store> store;
-    stores_.Compute(intention, [&store](const auto &intention, std::shared_ptr<Store> &storePtr) -> bool {
-        if (storePtr != nullptr) {
-            store = storePtr;
-            return true;
+    if (DURABILITY_MAP.find(intention) == DURABILITY_MAP.end()) {
+        return nullptr;
+    }
+    std::promise<std::shared_ptr<Store>> promise;
+    std::shared_future<std::shared_ptr<Store>> future;
+    bool opening = false;
+    stores_.Compute(intention, [&promise, &future, &opening](const auto &intention, auto &storeFuture) -> bool {
+        if (!storeFuture.valid()) {
+            storeFuture = promise.get_future().share();
+            opening = true;
         }
+        future = storeFuture;
+        return true;
+    });
+    if (!opening) {
+        return future.get();
+    }
+
+    auto store = Open(intention);
+    promise.set_value(store);
+    if (store == nullptr) {
+        // the failed open is dropped, so the next request tries again
+        stores_.ComputeIfPresent(intention, [](const auto &intention, auto &storeFuture) -> bool {
+            return storeFuture.get() != nullptr;
+        });
+    }
+    return store;
+}
 
-        if (intention == UD_INTENTION_MAP.at(UD_INTENTION_DRAG)) {
-            storePtr = std::make_shared<RuntimeStore>(intention);
-            if (!storePtr->Init()) {
-                LOG_ERROR(UDMF_SERVICE, "Init runtime store failed.");
-                return false;
-            }
-            store = storePtr;
-            return true;
+std::shared_ptr<Store> StoreCache::FindStore(const std::string &intention)
+{
+    auto [found, storeFuture] = stores_.Find(intention);
+    if (!found || !storeFuture.valid() || storeFuture.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        return nullptr;
+    }
+    return storeFuture.get();
+}
+
+std::shared_ptr<Store> StoreCache::Open(const std::string &intention)
+{
+    UDMF_TRACE_SPAN("store.Open");
+    int64_t begin = Tracer::Now();
+    Durability durability = DURABILITY_MAP.at(intention);
+    std::shared_ptr<Store> store =
+        std::make_shared<RuntimeStore>(intention, baseDir_.empty() ? RuntimeStore::BASE_DIR : baseDir_, durability);
+    if (!store->Init()) {
+        LOG_ERROR(UDMF_SERVICE, "Init runtime store failed, intention: %{public}s.", intention.c_str());
+        return nullptr;
+    }
+    int64_t openTime = Tracer::Now() - begin;
+    openTimes_.InsertOrAssign(intention, openTime);
+    LOG_INFO(UDMF_SERVICE, "Open runtime store, intention: %{public}s, durability: %{public}d, cost: %{public}" PRId64
+        "us.", intention.c_str(), durability, openTime);
+    return store;
+}
+
+void StoreCache::SetBaseDir(const std::string &baseDir)
+{
+    baseDir_ = baseDir;
+}
+
+void StoreCache::Flush()
+{
+    std::vector<std::shared_ptr<Store>> stores;
+    stores_.ForEach([&stores](const auto &intention, auto &storeFuture) -> bool {
+        bool ready = storeFuture.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+        if (ready && storeFuture.get() != nullptr) {
+            stores.push_back(storeFuture.get());
         }
         return false;
     });
-    return store;
+    // the stores are flushed out of the lock of the map, so a flush does not hold up the requests for the stores
+    for (const auto &store : stores) {
+        store->Flush();
+    }
+}
+
+int64_t StoreCache::GetOpenTime(const std::string &intention)
+{
+    auto [found, openTime] = openTimes_.Find(intention);
+    return found ? openTime : -1;
 }
 } // namespace UDMF
 } // namespace OHOS
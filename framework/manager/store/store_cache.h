@@ -16,6 +16,9 @@
 #ifndef UDMF_STORE_CACHE_H
 #define UDMF_STORE_CACHE_H
 
+#include <chrono>
+#include <future>
+#include <map>
 #include <memory>
 
 #include "concurrent_map.h"
@@ -24,12 +27,32 @@
 
 namespace OHOS {
 namespace UDMF {
+/*
+ * The stores are shared by all caches, so the store of an intention is opened once in the process. A request for a
+ * store being opened waits for that open instead of starting another one.
+ */
 class StoreCache {
 public:
     std::shared_ptr<Store> GetStore(std::string intention);
+    // the store of the intention if it is open already, nullptr instead of opening it
+    std::shared_ptr<Store> FindStore(const std::string &intention);
+    // directory of the stores opened after, the one of the service when empty; set before the first open
+    void SetBaseDir(const std::string &baseDir);
+    // microseconds spent in the last successful open of the store, -1 if it was not opened
+    int64_t GetOpenTime(const std::string &intention);
+    // lets the stores opened flush their idle writes, the ones being opened are left to the next flush
+    void Flush();
+
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL = std::chrono::milliseconds(1000);
 
 private:
-    ConcurrentMap<std::string, std::shared_ptr<Store>> stores_;
+    static std::shared_ptr<Store> Open(const std::string &intention);
+
+    // drag data is deleted once read and on start, share data may be lost with the writes not flushed yet
+    static const std::map<std::string, Durability> DURABILITY_MAP;
+    static ConcurrentMap<std::string, std::shared_future<std::shared_ptr<Store>>> stores_;
+    static ConcurrentMap<std::string, int64_t> openTimes_;
+    static std::string baseDir_;
 };
 } // namespace UDMF
 } // namespace OHOS
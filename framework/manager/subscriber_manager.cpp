@@ -0,0 +1,169 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "subscriber_manager.h"
+
+#include <algorithm>
+
+#include "file_size_resolver.h"
+#include "logger.h"
+
+namespace OHOS {
+namespace UDMF {
+SubscriberManager &SubscriberManager::GetInstance()
+{
+    static SubscriberManager instance;
+    return instance;
+}
+
+Status SubscriberManager::Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer)
+{
+    if (!UnifiedDataUtils::IsValidIntention(option.intention) || observer == nullptr) {
+        LOG_ERROR(UDMF_SERVICE, "Invalid subscription, intention: %{public}d.", option.intention);
+        return E_INVALID_PARAMETERS;
+    }
+    if (subscribers_.Size() >= MAX_SUBSCRIBERS) {
+        LOG_ERROR(UDMF_SERVICE, "Too many subscribers, token: %{public}d.", option.tokenId);
+        return E_INVALID_OPERATION;
+    }
+    Subscriber subscriber;
+    subscriber.option = option;
+    subscriber.remote = observer;
+    subscriber.observer = iface_cast<IUdmfObserver>(observer);
+    subscriber.deathRecipient = new (std::nothrow) DeathRecipient();
+    if (subscriber.observer == nullptr || subscriber.deathRecipient == nullptr) {
+        return E_ERROR;
+    }
+    if (!subscribers_.Insert(observer.GetRefPtr(), subscriber)) {
+        LOG_ERROR(UDMF_SERVICE, "Observer is subscribed already, token: %{public}d.", option.tokenId);
+        return E_INVALID_OPERATION;
+    }
+    if (observer->IsProxyObject() && !observer->AddDeathRecipient(subscriber.deathRecipient)) {
+        LOG_ERROR(UDMF_SERVICE, "Add death recipient failed, token: %{public}d.", option.tokenId);
+    }
+    return E_OK;
+}
+
+Status SubscriberManager::Unsubscribe(sptr<IRemoteObject> observer)
+{
+    if (observer == nullptr) {
+        return E_INVALID_PARAMETERS;
+    }
+    sptr<DeathRecipient> deathRecipient;
+    bool found = subscribers_.ComputeIfPresent(observer.GetRefPtr(),
+        [&deathRecipient](IRemoteObject *const &, Subscriber &subscriber) {
+            deathRecipient = subscriber.deathRecipient;
+            return false;
+        });
+    if (!found) {
+        return E_INVALID_PARAMETERS;
+    }
+    if (observer->IsProxyObject() && deathRecipient != nullptr) {
+        observer->RemoveDeathRecipient(deathRecipient);
+    }
+    return E_OK;
+}
+
+void SubscriberManager::Notify(Intention intention, const std::string &key, const UnifiedData &unifiedData)
+{
+    if (subscribers_.Empty()) {
+        return;
+    }
+    Summary summary;
+    for (const auto &record : unifiedData.GetRecords()) {
+        if (record == nullptr) {
+            continue;
+        }
+        int64_t recordSize = FileSizeResolver::GetSummarySize(record);
+        summary.summary[UD_TYPE_MAP.at(record->GetType())] += recordSize;
+        summary.totalSize += recordSize;
+    }
+    Notify(intention, key, summary);
+}
+
+void SubscriberManager::Notify(Intention intention, const std::string &key, const Summary &summary)
+{
+    if (subscribers_.Empty()) {
+        return;
+    }
+    ChangeNotice notice;
+    notice.key = key;
+    notice.summary = summary;
+    // subscribers are authorized once when they subscribe, so every subscriber of the intention is told
+    subscribers_.ForEach([this, intention, &notice](IRemoteObject *const &remote, Subscriber &subscriber) {
+        if (subscriber.option.intention != intention || !IsInterested(subscriber.option, notice.summary)) {
+            return false;
+        }
+        // notices of the same key are coalesced, and a subscriber lagging behind only keeps the latest ones
+        auto it = std::find_if(subscriber.notices.begin(), subscriber.notices.end(),
+            [&notice](const ChangeNotice &pending) { return pending.key == notice.key; });
+        if (it != subscriber.notices.end()) {
+            *it = notice;
+        } else {
+            if (subscriber.notices.size() >= MAX_PENDING_NOTICES) {
+                subscriber.notices.erase(subscriber.notices.begin());
+            }
+            subscriber.notices.push_back(notice);
+        }
+        if (subscriber.scheduled) {
+            return false;
+        }
+        auto taskId = executorPool_->Schedule(COALESCE_TIME, [this, remote]() { Flush(remote); });
+        subscriber.scheduled = taskId != ExecutorPool::INVALID_TASK_ID;
+        if (!subscriber.scheduled) {
+            LOG_ERROR(UDMF_SERVICE, "Schedule notices failed, token: %{public}d.", subscriber.option.tokenId);
+        }
+        return false;
+    });
+}
+
+bool SubscriberManager::IsInterested(const SubscribeOption &option, const Summary &summary)
+{
+    if (option.types.empty()) {
+        return true;
+    }
+    return std::any_of(option.types.begin(), option.types.end(), [&summary](UDType type) {
+        auto it = UD_TYPE_MAP.find(type);
+        return it != UD_TYPE_MAP.end() && summary.summary.find(it->second) != summary.summary.end();
+    });
+}
+
+void SubscriberManager::Flush(IRemoteObject *remote)
+{
+    std::vector<ChangeNotice> notices;
+    sptr<IUdmfObserver> observer;
+    subscribers_.ComputeIfPresent(remote, [&notices, &observer](IRemoteObject *const &, Subscriber &subscriber) {
+        notices.swap(subscriber.notices);
+        observer = subscriber.observer;
+        subscriber.scheduled = false;
+        return true;
+    });
+    // the call is one-way and made outside the lock, so a slow subscriber holds up neither the saving nor the others
+    if (observer != nullptr && !notices.empty()) {
+        observer->OnChange(notices);
+    }
+}
+
+void SubscriberManager::DeathRecipient::OnRemoteDied(const wptr<IRemoteObject> &remote)
+{
+    sptr<IRemoteObject> observer = remote.promote();
+    if (observer == nullptr) {
+        return;
+    }
+    LOG_INFO(UDMF_SERVICE, "Subscriber died, unsubscribe it.");
+    SubscriberManager::GetInstance().Unsubscribe(observer);
+}
+} // namespace UDMF
+} // namespace OHOS
@@ -0,0 +1,75 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_SUBSCRIBER_MANAGER_H
+#define UDMF_SUBSCRIBER_MANAGER_H
+
+#include <chrono>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "concurrent_map.h"
+#include "error_code.h"
+#include "executor_pool.h"
+#include "iremote_object.h"
+#include "udmf_observer.h"
+#include "unified_data.h"
+#include "unified_types.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * Keeps the subscribers of the intentions and fans out notices of saved data to them.
+ */
+class SubscriberManager {
+public:
+    static SubscriberManager &GetInstance();
+
+    Status Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer);
+    Status Unsubscribe(sptr<IRemoteObject> observer);
+    void Notify(Intention intention, const std::string &key, const UnifiedData &unifiedData);
+    void Notify(Intention intention, const std::string &key, const Summary &summary);
+
+private:
+    static constexpr std::chrono::milliseconds COALESCE_TIME = std::chrono::milliseconds(20);
+    static constexpr size_t MAX_SUBSCRIBERS = 1024;
+    static constexpr size_t MAX_PENDING_NOTICES = 256;
+
+    class DeathRecipient : public IRemoteObject::DeathRecipient {
+    public:
+        void OnRemoteDied(const wptr<IRemoteObject> &remote) override;
+    };
+
+    struct Subscriber {
+        SubscribeOption option;
+        sptr<IRemoteObject> remote;
+        sptr<IUdmfObserver> observer;
+        sptr<DeathRecipient> deathRecipient;
+        // notices not sent yet, one per key
+        std::vector<ChangeNotice> notices;
+        bool scheduled = false;
+    };
+
+    SubscriberManager() = default;
+    static bool IsInterested(const SubscribeOption &option, const Summary &summary);
+    void Flush(IRemoteObject *remote);
+
+    std::shared_ptr<ExecutorPool> executorPool_ = std::make_shared<ExecutorPool>(4, 1);
+    ConcurrentMap<IRemoteObject *, Subscriber> subscribers_;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_SUBSCRIBER_MANAGER_H
@@ -0,0 +1,52 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_OBSERVER_H
+#define UDMF_OBSERVER_H
+
+#include <vector>
+
+#include "iremote_broker.h"
+
+#include "unified_types.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * UDMF observer interface, called back by the service when subscribed data is saved
+ */
+class UdmfObserver {
+public:
+    DECLARE_INTERFACE_DESCRIPTOR(u"OHOS.UDMF.UdmfObserver");
+    UdmfObserver() = default;
+    virtual ~UdmfObserver() = default;
+
+    virtual void OnChange(const std::vector<ChangeNotice> &notices) = 0;
+
+protected:
+    enum FCode {
+        CODE_HEAD,
+        ON_CHANGE = CODE_HEAD,
+        CODE_BUTT
+    };
+};
+
+class IUdmfObserver : public UdmfObserver, public IRemoteBroker {
+public:
+    using UdmfObserver::UdmfObserver;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_OBSERVER_H
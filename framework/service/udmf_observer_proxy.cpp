@@ -0,0 +1,48 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udmf_observer_proxy.h"
+
+#include "ipc_types.h"
+
+#include "logger.h"
+#include "udmf_types_util.h"
+
+namespace OHOS {
+namespace UDMF {
+UdmfObserverProxy::UdmfObserverProxy(const sptr<IRemoteObject> &object) : IRemoteProxy<IUdmfObserver>(object)
+{
+}
+
+void UdmfObserverProxy::OnChange(const std::vector<ChangeNotice> &notices)
+{
+    MessageParcel request;
+    if (!request.WriteInterfaceToken(GetDescriptor()) || !ITypesUtil::Marshal(request, notices)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal notices failed, size: %{public}zu", notices.size());
+        return;
+    }
+    sptr<IRemoteObject> remote = Remote();
+    if (remote == nullptr) {
+        return;
+    }
+    MessageParcel reply;
+    MessageOption option(MessageOption::TF_ASYNC);
+    int err = remote->SendRequest(ON_CHANGE, request, reply, option);
+    if (err != 0) {
+        LOG_ERROR(UDMF_SERVICE, "Send notices failed, err: %{public}d", err);
+    }
+}
+} // namespace UDMF
+} // namespace OHOS
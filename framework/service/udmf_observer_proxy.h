@@ -0,0 +1,37 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_OBSERVER_PROXY_H
+#define UDMF_OBSERVER_PROXY_H
+
+#include "iremote_proxy.h"
+
+#include "udmf_observer.h"
+
+namespace OHOS {
+namespace UDMF {
+class UdmfObserverProxy : public IRemoteProxy<IUdmfObserver> {
+public:
+    explicit UdmfObserverProxy(const sptr<IRemoteObject> &object);
+
+    // one-way call, it returns without waiting for the subscriber to handle the notices
+    void OnChange(const std::vector<ChangeNotice> &notices) override;
+
+private:
+    static inline BrokerDelegator<UdmfObserverProxy> delegator_;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_OBSERVER_PROXY_H
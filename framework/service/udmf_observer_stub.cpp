@@ -0,0 +1,44 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "udmf_observer_stub.h"
+
+#include "ipc_types.h"
+
+#include "error_code.h"
+#include "logger.h"
+#include "udmf_types_util.h"
+
+namespace OHOS {
+namespace UDMF {
+int UdmfObserverStub::OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option)
+{
+    if (UdmfObserverStub::GetDescriptor() != data.ReadInterfaceToken()) {
+        LOG_ERROR(UDMF_CLIENT, "descriptor checked fail");
+        return -1;
+    }
+    if (code != ON_CHANGE) {
+        return IPCObjectStub::OnRemoteRequest(code, data, reply, option);
+    }
+    std::vector<ChangeNotice> notices;
+    if (!ITypesUtil::Unmarshal(data, notices)) {
+        LOG_ERROR(UDMF_CLIENT, "Unmarshal notices");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    OnChange(notices);
+    return E_OK;
+}
+} // namespace UDMF
+} // namespace OHOS
@@ -0,0 +1,34 @@
+/*
+ * Copyright (c) 2023 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef UDMF_OBSERVER_STUB_H
+#define UDMF_OBSERVER_STUB_H
+
+#include "iremote_stub.h"
+
+#include "udmf_observer.h"
+
+namespace OHOS {
+namespace UDMF {
+/*
+ * UDMF observer stub, living in the subscribing process
+ */
+class UdmfObserverStub : public IRemoteStub<IUdmfObserver> {
+public:
+    int OnRemoteRequest(uint32_t code, MessageParcel &data, MessageParcel &reply, MessageOption &option) override;
+};
+} // namespace UDMF
+} // namespace OHOS
+#endif // UDMF_OBSERVER_STUB_H
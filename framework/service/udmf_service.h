@@ -38,12 +38,34 @@ public:
     virtual ~UdmfService() = default;
 
     virtual int32_t SetData(CustomOption &option, UnifiedData &unifiedData, std::string &key) = 0;
+    virtual int32_t SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+        std::vector<std::string> &keys) = 0;
+    virtual int32_t AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record) = 0;
+    virtual int32_t ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record) = 0;
     virtual int32_t GetData(QueryOption &query, UnifiedData &unifiedData) = 0;
     virtual int32_t GetSummary(QueryOption &query, Summary &summary) = 0;
+    virtual int32_t GetPreview(QueryOption &query, Preview &preview) = 0;
+    virtual int32_t EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor,
+        uint32_t count, FolderBatch &batch) = 0;
+    virtual int32_t QueryKeys(QueryCondition &condition, std::vector<std::string> &keys) = 0;
+    virtual int32_t Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer) = 0;
+    virtual int32_t Unsubscribe(sptr<IRemoteObject> observer) = 0;
     virtual int32_t AddPrivilege(QueryOption &query, Privilege &privilege) = 0;
     virtual int32_t Sync(const QueryOption &query, const std::vector<std::string> &devices) = 0;
+    virtual int32_t SetTraceEnabled(bool enabled) = 0;
+    // the spans of the service as chrome trace events separated by commas
+    virtual int32_t DumpTrace(std::string &events) = 0;
+    // the memory held by the service in each category and the statistics of its stores, as text
+    virtual int32_t DumpStats(std::string &stats) = 0;
+    // when on, the shape and timing of each request of the service is written to its recording file
+    virtual int32_t SetRecordEnabled(bool enabled) = 0;
 
-protected:
+    // a request may end with the id of the client request it is made for and this marker, the request is read the
+    // same with or without them
+    static constexpr uint32_t REQUEST_ID_MARKER = 0x55444d46;
+    static constexpr size_t REQUEST_ID_TRAILER_SIZE = sizeof(uint64_t) + sizeof(uint32_t);
+
+    // codes of the requests, also kept in recordings, so new ones are only appended
     enum FCode {
         CODE_HEAD,
         SET_DATA = CODE_HEAD,
@@ -51,6 +73,18 @@ protected:
         GET_SUMMARY,
         ADD_PRIVILEGE,
         SYNC,
+        QUERY_KEYS,
+        SUBSCRIBE,
+        UNSUBSCRIBE,
+        SET_BATCH_DATA,
+        APPEND_RECORD,
+        REPLACE_RECORD,
+        SET_TRACE_ENABLED,
+        DUMP_TRACE,
+        DUMP_STATS,
+        SET_RECORD_ENABLED,
+        GET_PREVIEW,
+        ENUMERATE_FOLDER,
         CODE_BUTT
     };
 };
@@ -80,6 +80,25 @@ int32_t UdmfServiceClient::SetData(CustomOption &option, UnifiedData &unifiedDat
     return udmfProxy_->SetData(option, unifiedData, key);
 }
 
+int32_t UdmfServiceClient::SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+    std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->SetBatchData(option, unifiedDatas, keys);
+}
+
+int32_t UdmfServiceClient::AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->AppendRecord(query, record);
+}
+
+int32_t UdmfServiceClient::ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->ReplaceRecord(query, record);
+}
+
 int32_t UdmfServiceClient::GetData(QueryOption &query, UnifiedData &unifiedData)
 {
     LOG_INFO(UDMF_SERVICE, "start");
@@ -92,6 +111,37 @@ int32_t UdmfServiceClient::GetSummary(QueryOption &query, Summary &summary)
     return udmfProxy_->GetSummary(query, summary);
 }
 
+int32_t UdmfServiceClient::GetPreview(QueryOption &query, Preview &preview)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->GetPreview(query, preview);
+}
+
+int32_t UdmfServiceClient::EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor,
+    uint32_t count, FolderBatch &batch)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->EnumerateFolder(query, uri, cursor, count, batch);
+}
+
+int32_t UdmfServiceClient::QueryKeys(QueryCondition &condition, std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->QueryKeys(condition, keys);
+}
+
+int32_t UdmfServiceClient::Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->Subscribe(option, observer);
+}
+
+int32_t UdmfServiceClient::Unsubscribe(sptr<IRemoteObject> observer)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->Unsubscribe(observer);
+}
+
 int32_t UdmfServiceClient::AddPrivilege(QueryOption &query, Privilege &privilege)
 {
     LOG_INFO(UDMF_SERVICE, "start");
@@ -103,5 +153,29 @@ int32_t UdmfServiceClient::Sync(const QueryOption &query, const std::vector<std:
     LOG_INFO(UDMF_SERVICE, "start");
     return udmfProxy_->Sync(query, devices);
 }
+
+int32_t UdmfServiceClient::SetTraceEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->SetTraceEnabled(enabled);
+}
+
+int32_t UdmfServiceClient::DumpTrace(std::string &events)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->DumpTrace(events);
+}
+
+int32_t UdmfServiceClient::DumpStats(std::string &stats)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->DumpStats(stats);
+}
+
+int32_t UdmfServiceClient::SetRecordEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return udmfProxy_->SetRecordEnabled(enabled);
+}
 } // namespace UDMF
 } // namespace OHOS
\ No newline at end of file
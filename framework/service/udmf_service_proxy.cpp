@@ -17,34 +17,41 @@
 
 #include "ipc_types.h"
 
-#include "preprocess_utils.h"
+#include "udmf_memory.h"
+#include "udmf_tracer.h"
 #include "udmf_types_util.h"
 
 namespace OHOS {
 namespace UDMF {
-#define IPC_SEND(code, reply, ...)                                     \
-    ({                                                                 \
-        int32_t __status = E_OK;                                       \
-        do {                                                           \
-            MessageParcel request;                                     \
-            if (!request.WriteInterfaceToken(GetDescriptor())) {       \
-                __status = E_WRITE_PARCEL_ERROR;                       \
-                break;                                                 \
-            }                                                          \
-            if (!ITypesUtil::Marshal(request, ##__VA_ARGS__)) {        \
-                __status = E_WRITE_PARCEL_ERROR;                       \
-                break;                                                 \
-            }                                                          \
-            MessageOption option;                                      \
-            auto result = SendRequest((code), request, reply, option); \
-            if (result != 0) {                                         \
-                __status = E_IPC;                                      \
-                break;                                                 \
-            }                                                          \
-                                                                       \
-            ITypesUtil::Unmarshal(reply, __status);                    \
-        } while (0);                                                   \
-        __status;                                                      \
+#define IPC_SEND(code, reply, ...)                                          \
+    ({                                                                      \
+        int32_t __status = E_OK;                                            \
+        do {                                                                \
+            MessageParcel request;                                          \
+            if (!WriteHead(request)) {                                      \
+                __status = E_WRITE_PARCEL_ERROR;                            \
+                break;                                                      \
+            }                                                               \
+            bool __marshalled = false;                                      \
+            {                                                               \
+                UDMF_TRACE_SPAN("proxy.Marshal");                           \
+                __marshalled = ITypesUtil::Marshal(request, ##__VA_ARGS__); \
+                __marshalled = __marshalled && WriteTrailer(request);       \
+            }                                                               \
+            if (!__marshalled) {                                            \
+                __status = E_WRITE_PARCEL_ERROR;                            \
+                break;                                                      \
+            }                                                               \
+            MessageOption option;                                           \
+            auto result = SendRequest((code), request, reply, option);      \
+            if (result != 0) {                                              \
+                __status = E_IPC;                                           \
+                break;                                                      \
+            }                                                               \
+                                                                            \
+            ITypesUtil::Unmarshal(reply, __status);                         \
+        } while (0);                                                        \
+        __status;                                                           \
     })
 
 static constexpr int32_t UDMF_MAX_DATA_SIZE = 5 * 1024 * 1024;
@@ -78,6 +85,89 @@ int32_t UdmfServiceProxy::SetData(CustomOption &option, UnifiedData &unifiedData
     return status;
 }
 
+int32_t UdmfServiceProxy::SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+    std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_SERVICE, "start, tag: %{public}d, count: %{public}zu", option.intention, unifiedDatas.size());
+    if (!UnifiedDataUtils::IsValidIntention(option.intention)) {
+        LOG_ERROR(UDMF_SERVICE, "Invalid intention");
+        return E_INVALID_PARAMETERS;
+    }
+    if (unifiedDatas.empty()) {
+        LOG_ERROR(UDMF_SERVICE, "Invalid data!");
+        return E_INVALID_VALUE;
+    }
+    int64_t totalSize = 0;
+    for (auto &unifiedData : unifiedDatas) {
+        if (unifiedData.GetRecords().empty()) {
+            LOG_ERROR(UDMF_SERVICE, "Invalid data!");
+            return E_INVALID_VALUE;
+        }
+        totalSize += unifiedData.GetSize();
+    }
+    // the whole batch goes in one parcel, so it shares the limit of a single data
+    if (totalSize > UDMF_MAX_DATA_SIZE) {
+        LOG_ERROR(UDMF_SERVICE, "Exceeded the limit!");
+        return E_INVALID_VALUE;
+    }
+    MessageParcel reply;
+    int32_t status = IPC_SEND(SET_BATCH_DATA, reply, option, unifiedDatas);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, count:%{public}zu", status, unifiedDatas.size());
+        return status;
+    }
+    ITypesUtil::Unmarshal(reply, keys);
+    LOG_DEBUG(UDMF_SERVICE, "end.");
+    return status;
+}
+
+int32_t UdmfServiceProxy::AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_SERVICE, "start, tag: %{public}s", query.key.c_str());
+    UnifiedKey key(query.key);
+    if (!key.IsValid() || record == nullptr) {
+        LOG_ERROR(UDMF_SERVICE, "invalid key or record");
+        return E_INVALID_PARAMETERS;
+    }
+    if (record->GetSize() > UDMF_MAX_DATA_SIZE) {
+        LOG_ERROR(UDMF_SERVICE, "Exceeded the limit!");
+        return E_INVALID_VALUE;
+    }
+    MessageParcel reply;
+    int32_t status = IPC_SEND(APPEND_RECORD, reply, query, record);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, key:%{public}s", status, query.key.c_str());
+        return status;
+    }
+    std::string uid;
+    ITypesUtil::Unmarshal(reply, uid);
+    record->SetUid(uid);
+    LOG_DEBUG(UDMF_SERVICE, "end.");
+    return status;
+}
+
+int32_t UdmfServiceProxy::ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_SERVICE, "start, tag: %{public}s", query.key.c_str());
+    UnifiedKey key(query.key);
+    if (!key.IsValid() || record == nullptr || record->GetUid().empty()) {
+        LOG_ERROR(UDMF_SERVICE, "invalid key or record");
+        return E_INVALID_PARAMETERS;
+    }
+    if (record->GetSize() > UDMF_MAX_DATA_SIZE) {
+        LOG_ERROR(UDMF_SERVICE, "Exceeded the limit!");
+        return E_INVALID_VALUE;
+    }
+    MessageParcel reply;
+    int32_t status = IPC_SEND(REPLACE_RECORD, reply, query, record);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, key:%{public}s", status, query.key.c_str());
+        return status;
+    }
+    LOG_DEBUG(UDMF_SERVICE, "end.");
+    return status;
+}
+
 int32_t UdmfServiceProxy::GetData(QueryOption &query, UnifiedData &unifiedData)
 {
     LOG_INFO(UDMF_SERVICE, "start, tag: %{public}s", query.key.c_str());
@@ -88,11 +178,14 @@ int32_t UdmfServiceProxy::GetData(QueryOption &query, UnifiedData &unifiedData)
     }
     MessageParcel reply;
     int32_t status = IPC_SEND(GET_DATA, reply, query);
+    if (status == E_NOT_MODIFIED) {
+        return status;
+    }
     if (status != E_OK) {
         LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, key:%{public}s", status, query.key.c_str());
         return status;
     }
-    ITypesUtil::Unmarshal(reply, unifiedData);
+    ITypesUtil::Unmarshal(reply, unifiedData, query.validator);
     LOG_DEBUG(UDMF_SERVICE, "end.");
     return status;
 }
@@ -107,15 +200,102 @@ int32_t UdmfServiceProxy::GetSummary(QueryOption &query, Summary &summary)
     }
     MessageParcel reply;
     int32_t status = IPC_SEND(GET_SUMMARY, reply, query);
+    if (status == E_NOT_MODIFIED) {
+        return status;
+    }
     if (status != E_OK) {
         LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, key:%{public}s", status, query.key.c_str());
         return status;
     }
-    ITypesUtil::Unmarshal(reply, summary);
+    ITypesUtil::Unmarshal(reply, summary, query.validator);
     LOG_DEBUG(UDMF_SERVICE, "end.");
     return status;
 }
 
+int32_t UdmfServiceProxy::GetPreview(QueryOption &query, Preview &preview)
+{
+    LOG_INFO(UDMF_SERVICE, "start, tag: %{public}s", query.key.c_str());
+    UnifiedKey key(query.key);
+    if (!key.IsValid()) {
+        LOG_ERROR(UDMF_SERVICE, "invalid key");
+        return E_INVALID_PARAMETERS;
+    }
+    MessageParcel reply;
+    int32_t status = IPC_SEND(GET_PREVIEW, reply, query);
+    if (status == E_NOT_MODIFIED) {
+        return status;
+    }
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, key:%{public}s", status, query.key.c_str());
+        return status;
+    }
+    ITypesUtil::Unmarshal(reply, preview, query.validator);
+    LOG_DEBUG(UDMF_SERVICE, "end.");
+    return status;
+}
+
+int32_t UdmfServiceProxy::EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor,
+    uint32_t count, FolderBatch &batch)
+{
+    LOG_INFO(UDMF_SERVICE, "start, tag: %{public}s", query.key.c_str());
+    UnifiedKey key(query.key);
+    if (!key.IsValid()) {
+        LOG_ERROR(UDMF_SERVICE, "invalid key");
+        return E_INVALID_PARAMETERS;
+    }
+    MessageParcel reply;
+    int32_t status = IPC_SEND(ENUMERATE_FOLDER, reply, query, uri, cursor, count);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, key:%{public}s", status, query.key.c_str());
+        return status;
+    }
+    ITypesUtil::Unmarshal(reply, batch);
+    LOG_DEBUG(UDMF_SERVICE, "end.");
+    return status;
+}
+
+int32_t UdmfServiceProxy::QueryKeys(QueryCondition &condition, std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_SERVICE, "start, intention: %{public}d", condition.intention);
+    MessageParcel reply;
+    int32_t status = IPC_SEND(QUERY_KEYS, reply, condition);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, intention:%{public}d", status, condition.intention);
+        return status;
+    }
+    ITypesUtil::Unmarshal(reply, keys, condition.cursor);
+    LOG_DEBUG(UDMF_SERVICE, "end.");
+    return status;
+}
+
+int32_t UdmfServiceProxy::Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer)
+{
+    LOG_INFO(UDMF_SERVICE, "start, intention: %{public}d", option.intention);
+    MessageParcel request;
+    if (!WriteHead(request) || !ITypesUtil::Marshal(request, option)) {
+        return E_WRITE_PARCEL_ERROR;
+    }
+    int32_t status = SendObserver(SUBSCRIBE, request, observer);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x, intention:%{public}d", status, option.intention);
+    }
+    return status;
+}
+
+int32_t UdmfServiceProxy::Unsubscribe(sptr<IRemoteObject> observer)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    MessageParcel request;
+    if (!WriteHead(request)) {
+        return E_WRITE_PARCEL_ERROR;
+    }
+    int32_t status = SendObserver(UNSUBSCRIBE, request, observer);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x", status);
+    }
+    return status;
+}
+
 int32_t UdmfServiceProxy::AddPrivilege(QueryOption &query, Privilege &privilege)
 {
     LOG_INFO(UDMF_SERVICE, "start, key: %{public}s", query.key.c_str());
@@ -150,6 +330,79 @@ int32_t UdmfServiceProxy::Sync(const QueryOption &query, const std::vector<std::
     return status;
 }
 
+int32_t UdmfServiceProxy::SetTraceEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_SERVICE, "start, enabled: %{public}d", enabled);
+    MessageParcel reply;
+    int32_t status = IPC_SEND(SET_TRACE_ENABLED, reply, enabled);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x", status);
+    }
+    return status;
+}
+
+int32_t UdmfServiceProxy::DumpTrace(std::string &events)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    MessageParcel reply;
+    int32_t status = IPC_SEND(DUMP_TRACE, reply);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x", status);
+        return status;
+    }
+    ITypesUtil::Unmarshal(reply, events);
+    return status;
+}
+
+int32_t UdmfServiceProxy::DumpStats(std::string &stats)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    MessageParcel reply;
+    int32_t status = IPC_SEND(DUMP_STATS, reply);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x", status);
+        return status;
+    }
+    ITypesUtil::Unmarshal(reply, stats);
+    return status;
+}
+
+int32_t UdmfServiceProxy::SetRecordEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_SERVICE, "start, enabled: %{public}d", enabled);
+    MessageParcel reply;
+    int32_t status = IPC_SEND(SET_RECORD_ENABLED, reply, enabled);
+    if (status != E_OK) {
+        LOG_ERROR(UDMF_SERVICE, "status:0x%{public}x", status);
+    }
+    return status;
+}
+
+bool UdmfServiceProxy::WriteHead(MessageParcel &request)
+{
+    return request.WriteInterfaceToken(GetDescriptor());
+}
+
+bool UdmfServiceProxy::WriteTrailer(MessageParcel &request)
+{
+    // the request id goes after the arguments, which a service reading only its arguments leaves alone
+    return request.WriteUint64(Tracer::GetRequestId()) && request.WriteUint32(REQUEST_ID_MARKER);
+}
+
+int32_t UdmfServiceProxy::SendObserver(IUdmfService::FCode code, MessageParcel &request, sptr<IRemoteObject> observer)
+{
+    if (observer == nullptr || !request.WriteRemoteObject(observer) || !WriteTrailer(request)) {
+        return E_WRITE_PARCEL_ERROR;
+    }
+    MessageParcel reply;
+    MessageOption option;
+    if (SendRequest(code, request, reply, option) != 0) {
+        return E_IPC;
+    }
+    int32_t status = E_OK;
+    ITypesUtil::Unmarshal(reply, status);
+    return status;
+}
 
 int32_t UdmfServiceProxy::SendRequest(
     IUdmfService::FCode code, MessageParcel &data, MessageParcel &reply, MessageOption &option)
@@ -158,7 +411,10 @@ int32_t UdmfServiceProxy::SendRequest(
     if (remote == nullptr) {
         return E_SA_DIED;
     }
+    UDMF_TRACE_SPAN("proxy.Binder");
+    MemoryCharge charge(MEMORY_PARCEL, static_cast<int64_t>(data.GetDataSize()));
     int err = remote->SendRequest(code, data, reply, option);
+    charge.Add(static_cast<int64_t>(reply.GetDataSize()));
     LOG_DEBUG(UDMF_SERVICE, "err: %{public}d", err);
     return err;
 }
@@ -35,14 +35,31 @@ public:
     explicit UdmfServiceProxy(const sptr<IRemoteObject> &object);
 
     int32_t SetData(CustomOption &option, UnifiedData &unifiedData, std::string &key) override;
+    int32_t SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+        std::vector<std::string> &keys) override;
+    int32_t AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record) override;
+    int32_t ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record) override;
     int32_t GetData(QueryOption &query, UnifiedData &unifiedData) override;
     int32_t GetSummary(QueryOption &query, Summary &summary) override;
+    int32_t GetPreview(QueryOption &query, Preview &preview) override;
+    int32_t EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor, uint32_t count,
+        FolderBatch &batch) override;
+    int32_t QueryKeys(QueryCondition &condition, std::vector<std::string> &keys) override;
+    int32_t Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer) override;
+    int32_t Unsubscribe(sptr<IRemoteObject> observer) override;
     int32_t AddPrivilege(QueryOption &query, Privilege &privilege) override;
     int32_t Sync(const QueryOption &query, const std::vector<std::string> &devices) override;
+    int32_t SetTraceEnabled(bool enabled) override;
+    int32_t DumpTrace(std::string &events) override;
+    int32_t DumpStats(std::string &stats) override;
+    int32_t SetRecordEnabled(bool enabled) override;
 
 private:
     static inline BrokerDelegator<UdmfServiceProxy> delegator_;
+    bool WriteHead(MessageParcel &request);
+    static bool WriteTrailer(MessageParcel &request);
     int32_t SendRequest(FCode code, MessageParcel &data, MessageParcel &reply, MessageOption &option);
+    int32_t SendObserver(FCode code, MessageParcel &request, sptr<IRemoteObject> observer);
 };
 } // namespace UDMF
 } // namespace OHOS
@@ -16,9 +16,14 @@
 #ifndef UDMF_CLIENT_H
 #define UDMF_CLIENT_H
 
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
+#include "iremote_object.h"
 #include "unified_data.h"
 #include "error_code.h"
 #include "unified_meta.h"
@@ -26,15 +31,79 @@
 
 namespace OHOS {
 namespace UDMF {
+class DataObserver {
+public:
+    virtual ~DataObserver() = default;
+    // called with the notices of the data saved since the previous call
+    virtual void OnChange(const std::vector<ChangeNotice> &notices) = 0;
+};
+
 class UdmfClient {
 public:
     static UdmfClient &GetInstance();
 
     Status SetData(CustomOption &option, UnifiedData &unifiedData, std::string &key);
+    // saves all the data with one call, the keys are in the order of the data
+    Status SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+        std::vector<std::string> &keys);
+    // appends the record to the saved data of the key and sets the uid given to the record, which is the uid
+    // to replace the record with later; only the producer of the data changes it
+    Status AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record);
+    Status ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record);
+    // results are cached in the process and revalidated with the service; each caller gets its own copy of the
+    // records of a cached data. A query carrying its own validator bypasses the cache and gets E_NOT_MODIFIED if
+    // its result is still valid.
     Status GetData(QueryOption &query, UnifiedData &unifiedData);
     Status GetSummary(QueryOption &query, Summary& summary);
+    // a thumbnail to show while hovering, read without reading or consuming the data; cached like the summary
+    Status GetPreview(QueryOption &query, Preview &preview);
+    // lists a batch of at most count children of the folder at uri, a folder record of the data or a folder in one,
+    // from the cursor of the previous batch or from the start if empty; the uris listed are granted to the caller
+    // batch by batch, and the data is not consumed
+    Status EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor, uint32_t count,
+        FolderBatch &batch);
+    Status QueryKeys(QueryCondition &condition, std::vector<std::string> &keys);
     Status AddPrivilege(QueryOption &query, Privilege &privilege);
     Status Sync(const QueryOption &query, const std::vector<std::string> &devices);
+    // tracing is off by default; when on, the spans of this process and of the service are kept in ring buffers
+    Status SetTraceEnabled(bool enabled);
+    // the latest spans of this process and of the service in the chrome trace format
+    Status DumpTrace(std::string &trace);
+    // the memory held in each category by the service and by this process, and the statistics of the stores
+    Status DumpStats(std::string &stats);
+    // when on, the service records the shape and timing of its requests for the replay tool
+    Status SetRecordEnabled(bool enabled);
+    Status Subscribe(const SubscribeOption &option, std::shared_ptr<DataObserver> observer);
+    Status Unsubscribe(std::shared_ptr<DataObserver> observer);
+
+private:
+    static constexpr size_t MAX_CACHE_COUNT = 16;
+    static constexpr size_t MAX_CACHED_DATA_SIZE = 512 * 1024;
+
+    template<typename T>
+    struct CacheEntry {
+        std::string validator;
+        T result;
+        // the bytes charged to the cache category of the memory account
+        int64_t size = 0;
+        std::list<std::string>::iterator recency;
+    };
+    template<typename T>
+    struct Cache {
+        std::map<std::string, CacheEntry<T>> entries;
+        // the keys from the most to the least recently used, the last one is evicted first
+        std::list<std::string> recency;
+    };
+
+    template<typename T, typename Fetch>
+    Status GetCached(QueryOption &query, Cache<T> &cache, T &result, Fetch fetch);
+
+    std::mutex cacheMutex_;
+    Cache<Summary> summaryCache_;
+    Cache<Preview> previewCache_;
+    Cache<UnifiedData> dataCache_;
+    std::mutex mutex_;
+    std::map<std::shared_ptr<DataObserver>, sptr<IRemoteObject>> observers_;
 };
 } // namespace UDMF
 } // namespace OHOS
@@ -48,6 +48,7 @@ enum Status : int32_t {
     E_IS_BEGINNING_PROCESSED,
     E_FORBIDDEN,
     E_UNKNOWN,
+    E_NOT_MODIFIED,
     E_BUTT,
 };
 } // namespace UDMF
@@ -110,7 +110,9 @@ enum Intention : int32_t {
 };
 
 static const std::unordered_map<int32_t, std::string> UD_INTENTION_MAP {
-    {UD_INTENTION_DRAG, "drag"}
+    {UD_INTENTION_DRAG, "drag"},
+    {UD_INTENTION_SYS, "sys"},
+    {UD_INTENTION_SHARE, "share"}
 };
 
 class UnifiedDataUtils {
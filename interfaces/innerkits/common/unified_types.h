@@ -16,8 +16,10 @@
 #ifndef UDMF_UNIFIED_TYPES_H
 #define UDMF_UNIFIED_TYPES_H
 
+#include <limits>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "unified_key.h"
 #include "unified_meta.h"
@@ -33,7 +35,40 @@ enum DataStatus : int32_t {
 
 struct Summary {
     std::map<std::string, int64_t> summary;
-    int64_t totalSize;
+    int64_t totalSize{};
+};
+
+// a thumbnail of the first pixel map of data, small enough to fetch while hovering over a target
+struct Preview {
+    int32_t width{};
+    int32_t height{};
+    // four bytes per pixel row by row, in the pixel format of the pixel map; empty if the data has no preview
+    std::vector<uint8_t> pixels;
+};
+
+// a child of a folder of data, as enumerated by the service
+struct FolderEntry {
+    std::string name;
+    // UDType::FILE or UDType::FOLDER
+    UDType type{ UDType::FILE };
+    // bytes of a file, 0 for a folder
+    int64_t size{};
+    // readable by the caller once the batch holding the entry is returned
+    std::string uri;
+};
+
+// a batch of the children of a folder, in the order of the file system
+struct FolderBatch {
+    std::vector<FolderEntry> entries;
+    // given back to get the next batch, empty once the folder is enumerated
+    std::string cursor;
+};
+
+// encodings of the raw data of a pixel map, a reader declares those it decodes by their bits (1 << encoding)
+enum PixelEncoding : int32_t {
+    PIXEL_ENCODING_RAW = 0,
+    PIXEL_ENCODING_QOI,
+    PIXEL_ENCODING_BUTT
 };
 
 struct Privilege {
@@ -74,11 +109,65 @@ struct CustomOption {
 /*
  * Options for querying data from UDMF.
  */
+enum ValidatorType : int32_t {
+    // changes with the version and the modification time of the data, checked by the runtime info only
+    VERSION_VALIDATOR = 0,
+    // digest of the stored records, unchanged as long as the records are
+    CONTENT_VALIDATOR,
+    VALIDATOR_BUTT
+};
+
 struct QueryOption {
     std::string key;
     int32_t tokenId{};
+    // version in the history of the key's bundle: positive for an absolute version, negative for a version
+    // relative to the key's one, 0 for the data of the key itself
+    int32_t version{};
+    // validator of the result held by the caller, E_NOT_MODIFIED is returned if the result is still valid;
+    // otherwise it is replaced by the validator of the result returned
+    std::string validator;
+    ValidatorType validatorType{VERSION_VALIDATOR};
+    // bits of the pixel map encodings the caller decodes, pixel maps in other encodings are returned raw
+    uint32_t encodings{};
+};
+
+/*
+ * Conditions for querying the keys of stored data page by page.
+ */
+struct QueryCondition {
+    Intention intention{};
+    // bundle which created the data, empty for all bundles
+    std::string bundleName;
+    // type of a record in the data, UD_BUTT for all types
+    UDType type{UD_BUTT};
+    // range of the creation time in milliseconds, both ends included
+    time_t beginTime{};
+    time_t endTime{std::numeric_limits<time_t>::max()};
+    // empty for the first page, the cursor returned with a page for the next one, empty after the last page
+    std::string cursor;
+    int32_t pageSize{};
+    int32_t tokenId{};
+    int32_t pid{};
+};
+
+/*
+ * Options for subscribing to the data saved with an intention.
+ */
+struct SubscribeOption {
+    Intention intention{};
+    // only the data holding a record of these types is notified, empty for all types
+    std::vector<UDType> types;
+    int32_t tokenId{};
     int32_t pid{};
 };
+
+/*
+ * Notice of data saved with a subscribed intention.
+ */
+struct ChangeNotice {
+    std::string key;
+    Summary summary;
+};
 } // namespace UDMF
 } // namespace OHOS
 #endif //UDMF_UNIFIED_TYPES_H
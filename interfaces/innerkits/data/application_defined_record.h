@@ -33,6 +33,7 @@ public:
 
     std::vector<uint8_t> GetRawData() const;
     void SetRawData(const std::vector<uint8_t> &rawData);
+    void SetRawData(std::vector<uint8_t> &&rawData);
 protected:
     std::string applicationDefinedType;
     std::vector<uint8_t> rawData_;
@@ -22,6 +22,9 @@ namespace OHOS {
 namespace UDMF {
 class File : public UnifiedRecord {
 public:
+    // int64 detail with the bytes on disk of the file, or of all the files in the folder, set by the service
+    static constexpr const char *FILE_SIZE = "fileSize";
+
     File();
     explicit File(const std::string &uri);
     int64_t GetSize() override;
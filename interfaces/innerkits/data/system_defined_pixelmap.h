@@ -17,20 +17,41 @@
 #define UDMF_SYSTEM_DEFINED_PIXELMAP_H
 
 #include "system_defined_record.h"
+#include "unified_types.h"
 
 namespace OHOS {
 namespace UDMF {
 class SystemDefinedPixelMap : public SystemDefinedRecord {
 public:
+    // int32 details giving the size of raw data made of four-byte pixels, row by row, for the service to make
+    // the preview of the data from
+    static constexpr const char *WIDTH = "width";
+    static constexpr const char *HEIGHT = "height";
+    // a preview made by the producer in the same layout, used instead of the raw data
+    static constexpr const char *PREVIEW = "preview";
+    static constexpr const char *PREVIEW_WIDTH = "previewWidth";
+    static constexpr const char *PREVIEW_HEIGHT = "previewHeight";
+
     SystemDefinedPixelMap();
     explicit SystemDefinedPixelMap(std::vector<uint8_t> &data);
 
+    // the size of the raw data, whether it is held encoded or not
     int64_t GetSize() override;
 
+    // the raw data, decoded if it is held encoded
     std::vector<uint8_t> GetRawData() const;
     void SetRawData(const std::vector<uint8_t> &rawData);
+    void SetRawData(std::vector<uint8_t> &&rawData);
+
+    // the data as held, stored and sent in its encoding without decoding it
+    int32_t GetEncoding() const;
+    const std::vector<uint8_t> &GetEncodedData() const;
+    bool SetEncodedData(std::vector<uint8_t> data, int32_t encoding);
+    // encodes the data held if that makes it smaller; PIXEL_ENCODING_RAW decodes it
+    bool Encode(int32_t encoding);
 private:
     std::vector<uint8_t> rawData_;
+    int32_t encoding_ = PIXEL_ENCODING_RAW;
 };
 } // namespace UDMF
 } // namespace OHOS
@@ -65,6 +65,7 @@ public:
     static napi_status SetValue(napi_env env, const std::vector<std::string> &in, napi_value &out);
 
     /* napi_value <-> std::vector<uint8_t> */
+    // takes the bytes of an ArrayBuffer, of any typed array or of a DataView, from the byte offset of the view
     static napi_status GetValue(napi_env env, napi_value in, std::vector<uint8_t> &out);
     static napi_status SetValue(napi_env env, const std::vector<uint8_t> &in, napi_value &out);
 
@@ -91,6 +92,9 @@ public:
         size_t count, napi_callback newcb);
 
 private:
+    // the bytes viewed by the value in place, valid until the JS code runs again
+    static napi_status GetBytes(napi_env env, napi_value in, uint8_t *&bytes, size_t &length);
+
     enum {
         /* std::map<key, value> to js::tuple<key, value> */
         TUPLE_KEY = 0,
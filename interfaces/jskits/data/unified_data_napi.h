@@ -31,9 +31,17 @@ public:
     std::shared_ptr<UnifiedData> value_;
 
 private:
+    // set once a record of the data is also held by a record object of JS, which the transfer cannot take along
+    bool recordsShared_ = false;
+
     static napi_value New(napi_env env, napi_callback_info info);
     static void Destructor(napi_env env, void *data, void *hint);
     static UnifiedDataNapi *GetUnifiedData(napi_env env, napi_callback_info info);
+    // lets the object be posted to a worker, which gets the same native data instead of a copy of its records,
+    // as long as no record of it is held by a record object of the sender
+    static void BindTransfer(napi_env env, napi_value object, UnifiedDataNapi *data);
+    static void *Detach(napi_env env, void *value, void *hint);
+    static napi_value Attach(napi_env env, void *value, void *hint);
 
     static napi_value AddRecord(napi_env env, napi_callback_info info);
     static napi_value GetRecords(napi_env env, napi_callback_info info);
@@ -37,12 +37,32 @@ public:
 
 private:
     int32_t OnSetData(MessageParcel &data, MessageParcel &reply);
+    int32_t OnSetBatchData(MessageParcel &data, MessageParcel &reply);
+    int32_t OnAppendRecord(MessageParcel &data, MessageParcel &reply);
+    int32_t OnReplaceRecord(MessageParcel &data, MessageParcel &reply);
     int32_t OnGetData(MessageParcel &data, MessageParcel &reply);
     int32_t OnGetSummary(MessageParcel &data, MessageParcel &reply);
+    int32_t OnGetPreview(MessageParcel &data, MessageParcel &reply);
+    int32_t OnEnumerateFolder(MessageParcel &data, MessageParcel &reply);
+    int32_t OnQueryKeys(MessageParcel &data, MessageParcel &reply);
+    int32_t OnSubscribe(MessageParcel &data, MessageParcel &reply);
+    int32_t OnUnsubscribe(MessageParcel &data, MessageParcel &reply);
     int32_t OnAddPrivilege(MessageParcel &data, MessageParcel &reply);
     int32_t OnSync(MessageParcel &data, MessageParcel &reply);
+    int32_t OnSetTraceEnabled(MessageParcel &data, MessageParcel &reply);
+    int32_t OnDumpTrace(MessageParcel &data, MessageParcel &reply);
+    int32_t OnDumpStats(MessageParcel &data, MessageParcel &reply);
+    int32_t OnSetRecordEnabled(MessageParcel &data, MessageParcel &reply);
 
     bool VerifyPermission(const std::string &permission);
+    static uint64_t ReadRequestId(MessageParcel &data);
+    static int32_t ReadStatus(MessageParcel &reply);
+    // tracing, recording and the stats dump are debugging facilities for native processes and the shell
+    bool IsDumpAllowed();
+
+    static constexpr size_t MAX_TRACE_CAPACITY = 512 * 1024;
+    // as many as the data manager saves in one batch
+    static constexpr int32_t MAX_BATCH_DATA_COUNT = 64;
 
     const std::string READ_PERMISSION = "ohos.permission.READ_UDMF_DATA";
     const std::string WRITE_PERMISSION = "ohos.permission.WRITE_UDMF_DATA";
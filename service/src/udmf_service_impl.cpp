@@ -22,6 +22,10 @@
 #include "lifecycle/lifecycle_manager.h"
 #include "logger.h"
 #include "preprocess_utils.h"
+#include "subscriber_manager.h"
+#include "udmf_memory.h"
+#include "udmf_recorder.h"
+#include "udmf_tracer.h"
 
 namespace OHOS {
 namespace UDMF {
@@ -49,6 +53,25 @@ int32_t UdmfServiceImpl::SetData(CustomOption &option, UnifiedData &unifiedData,
     return DataManager::GetInstance().SaveData(option, unifiedData, key);
 }
 
+int32_t UdmfServiceImpl::SetBatchData(CustomOption &option, std::vector<UnifiedData> &unifiedDatas,
+    std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return DataManager::GetInstance().SaveBatchData(option, unifiedDatas, keys);
+}
+
+int32_t UdmfServiceImpl::AppendRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return DataManager::GetInstance().AppendRecord(query, record);
+}
+
+int32_t UdmfServiceImpl::ReplaceRecord(QueryOption &query, std::shared_ptr<UnifiedRecord> record)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return DataManager::GetInstance().ReplaceRecord(query, record);
+}
+
 int32_t UdmfServiceImpl::GetData(QueryOption &query, UnifiedData &unifiedData)
 {
     LOG_INFO(UDMF_SERVICE, "start");
@@ -61,6 +84,37 @@ int32_t UdmfServiceImpl::GetSummary(QueryOption &query, Summary &summary)
     return DataManager::GetInstance().GetSummary(query, summary);
 }
 
+int32_t UdmfServiceImpl::GetPreview(QueryOption &query, Preview &preview)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return DataManager::GetInstance().GetPreview(query, preview);
+}
+
+int32_t UdmfServiceImpl::EnumerateFolder(QueryOption &query, const std::string &uri, const std::string &cursor,
+    uint32_t count, FolderBatch &batch)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return DataManager::GetInstance().EnumerateFolder(query, uri, cursor, count, batch);
+}
+
+int32_t UdmfServiceImpl::QueryKeys(QueryCondition &condition, std::vector<std::string> &keys)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return DataManager::GetInstance().QueryKeys(condition, keys);
+}
+
+int32_t UdmfServiceImpl::Subscribe(const SubscribeOption &option, sptr<IRemoteObject> observer)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return SubscriberManager::GetInstance().Subscribe(option, observer);
+}
+
+int32_t UdmfServiceImpl::Unsubscribe(sptr<IRemoteObject> observer)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    return SubscriberManager::GetInstance().Unsubscribe(observer);
+}
+
 int32_t UdmfServiceImpl::AddPrivilege(QueryOption &query, Privilege &privilege)
 {
     return DataManager::GetInstance().AddPrivilege(query, privilege);
@@ -71,9 +125,42 @@ int32_t UdmfServiceImpl::Sync(const QueryOption &query, const std::vector<std::s
     return DataManager::GetInstance().Sync(query, devices);
 }
 
+int32_t UdmfServiceImpl::SetTraceEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_SERVICE, "start, enabled: %{public}d", enabled);
+    Tracer::GetInstance().SetEnabled(enabled);
+    return E_OK;
+}
+
+int32_t UdmfServiceImpl::DumpTrace(std::string &events)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    events = Tracer::GetInstance().DumpEvents();
+    return E_OK;
+}
+
+int32_t UdmfServiceImpl::DumpStats(std::string &stats)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    stats = "memory:\n" + MemoryAccount::GetInstance().Dump() + "stores:\n";
+    return DataManager::GetInstance().DumpStats(stats);
+}
+
+int32_t UdmfServiceImpl::SetRecordEnabled(bool enabled)
+{
+    LOG_INFO(UDMF_SERVICE, "start, enabled: %{public}d", enabled);
+    if (!enabled) {
+        RequestRecorder::GetInstance().Stop();
+        return E_OK;
+    }
+    return RequestRecorder::GetInstance().Start(RECORDING_PATH);
+}
+
 int32_t UdmfServiceImpl::OnInitialize()
 {
     LOG_INFO(UDMF_SERVICE, "start");
+    // the cleanup below waits for the stores being warmed instead of opening them a second time
+    DataManager::GetInstance().PreWarm();
     Status status = LifeCycleManager::GetInstance().DeleteOnStart();
     if (status != E_OK) {
         LOG_ERROR(UDMF_SERVICE, "DeleteOnStart execute failed, status: %{public}d", status);
@@ -21,6 +21,9 @@
 #include "ipc_skeleton.h"
 
 #include "logger.h"
+#include "udmf_memory.h"
+#include "udmf_recorder.h"
+#include "udmf_tracer.h"
 #include "udmf_types_util.h"
 #include "unified_data.h"
 #include "unified_meta.h"
@@ -34,6 +37,18 @@ UdmfServiceStub::UdmfServiceStub()
     memberFuncMap_[static_cast<uint32_t>(GET_SUMMARY)] = &UdmfServiceStub::OnGetSummary;
     memberFuncMap_[static_cast<uint32_t>(ADD_PRIVILEGE)] = &UdmfServiceStub::OnAddPrivilege;
     memberFuncMap_[static_cast<uint32_t>(SYNC)] = &UdmfServiceStub::OnSync;
+    memberFuncMap_[static_cast<uint32_t>(QUERY_KEYS)] = &UdmfServiceStub::OnQueryKeys;
+    memberFuncMap_[static_cast<uint32_t>(SUBSCRIBE)] = &UdmfServiceStub::OnSubscribe;
+    memberFuncMap_[static_cast<uint32_t>(UNSUBSCRIBE)] = &UdmfServiceStub::OnUnsubscribe;
+    memberFuncMap_[static_cast<uint32_t>(SET_BATCH_DATA)] = &UdmfServiceStub::OnSetBatchData;
+    memberFuncMap_[static_cast<uint32_t>(APPEND_RECORD)] = &UdmfServiceStub::OnAppendRecord;
+    memberFuncMap_[static_cast<uint32_t>(REPLACE_RECORD)] = &UdmfServiceStub::OnReplaceRecord;
+    memberFuncMap_[static_cast<uint32_t>(SET_TRACE_ENABLED)] = &UdmfServiceStub::OnSetTraceEnabled;
+    memberFuncMap_[static_cast<uint32_t>(DUMP_TRACE)] = &UdmfServiceStub::OnDumpTrace;
+    memberFuncMap_[static_cast<uint32_t>(DUMP_STATS)] = &UdmfServiceStub::OnDumpStats;
+    memberFuncMap_[static_cast<uint32_t>(SET_RECORD_ENABLED)] = &UdmfServiceStub::OnSetRecordEnabled;
+    memberFuncMap_[static_cast<uint32_t>(GET_PREVIEW)] = &UdmfServiceStub::OnGetPreview;
+    memberFuncMap_[static_cast<uint32_t>(ENUMERATE_FOLDER)] = &UdmfServiceStub::OnEnumerateFolder;
 }
 
 UdmfServiceStub::~UdmfServiceStub()
@@ -53,11 +68,25 @@ int UdmfServiceStub::OnRemoteRequest(uint32_t code, MessageParcel &data, Message
     if (CODE_HEAD > code || code >= CODE_BUTT) {
         return -1;
     }
+    // the spans of the service are recorded under the request id of the client
+    TraceRequest request(ReadRequestId(data));
     auto itFunc = memberFuncMap_.find(code);
     if (itFunc != memberFuncMap_.end()) {
         auto memberFunc = itFunc->second;
         if (memberFunc != nullptr) {
-            return (this->*memberFunc)(data, reply);
+            UDMF_TRACE_SPAN("stub.OnRemoteRequest");
+            MemoryCharge charge(MEMORY_PARCEL, static_cast<int64_t>(data.GetDataSize()));
+            auto &recorder = RequestRecorder::GetInstance();
+            bool recording = recorder.IsRecording();
+            if (recording) {
+                recorder.Begin(code);
+            }
+            int32_t result = (this->*memberFunc)(data, reply);
+            charge.Add(static_cast<int64_t>(reply.GetDataSize()));
+            if (recording) {
+                recorder.End(result == E_OK ? ReadStatus(reply) : result);
+            }
+            return result;
         }
     }
     LOG_INFO(UDMF_SERVICE, "end##ret = -1");
@@ -73,10 +102,14 @@ int32_t UdmfServiceStub::OnSetData(MessageParcel &data, MessageParcel &reply)
         LOG_ERROR(UDMF_SERVICE, "Unmarshal option");
         return IPC_STUB_INVALID_DATA_ERR;
     }
+    MemoryCharge charge(MEMORY_DECODED_RECORD, unifiedData.GetSize());
     int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
     customOption.tokenId = token;
+    RequestRecorder::GetInstance().SetIntention(customOption.intention);
+    RequestRecorder::GetInstance().AddData(unifiedData);
     std::string key;
     int32_t status = SetData(customOption, unifiedData, key);
+    RequestRecorder::GetInstance().SetResult(key);
     if (!ITypesUtil::Marshal(reply, status, key)) {
         LOG_ERROR(UDMF_SERVICE, "Marshal key: %{public}s", key.c_str());
         return IPC_STUB_WRITE_PARCEL_ERR;
@@ -84,6 +117,88 @@ int32_t UdmfServiceStub::OnSetData(MessageParcel &data, MessageParcel &reply)
     return E_OK;
 }
 
+int32_t UdmfServiceStub::OnSetBatchData(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    CustomOption customOption{};
+    std::vector<UnifiedData> unifiedDatas;
+    if (!ITypesUtil::Unmarshal(data, customOption)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal option");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    // the vector reader allocates all the data it is told of, so the count is checked before
+    size_t position = data.GetReadPosition();
+    int32_t count = data.ReadInt32();
+    if (count <= 0 || count > MAX_BATCH_DATA_COUNT || !data.RewindRead(position) ||
+        !ITypesUtil::Unmarshal(data, unifiedDatas)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal data, count: %{public}d", count);
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    MemoryCharge charge(MEMORY_DECODED_RECORD, 0);
+    for (auto &unifiedData : unifiedDatas) {
+        charge.Add(unifiedData.GetSize());
+    }
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    customOption.tokenId = token;
+    RequestRecorder::GetInstance().SetIntention(customOption.intention);
+    for (auto &unifiedData : unifiedDatas) {
+        RequestRecorder::GetInstance().AddData(unifiedData);
+    }
+    std::vector<std::string> keys;
+    int32_t status = SetBatchData(customOption, unifiedDatas, keys);
+    RequestRecorder::GetInstance().SetResult(keys);
+    if (!ITypesUtil::Marshal(reply, status, keys)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal keys, count: %{public}zu", keys.size());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnAppendRecord(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    QueryOption query;
+    std::shared_ptr<UnifiedRecord> record;
+    if (!ITypesUtil::Unmarshal(data, query, record)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal query and record");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    MemoryCharge charge(MEMORY_DECODED_RECORD, record == nullptr ? 0 : record->GetSize());
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    query.tokenId = token;
+    RequestRecorder::GetInstance().SetQuery(query.key, query.version);
+    RequestRecorder::GetInstance().AddRecord(record);
+    int32_t status = AppendRecord(query, record);
+    std::string uid = status == E_OK ? record->GetUid() : "";
+    if (!ITypesUtil::Marshal(reply, status, uid)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal uid, key: %{public}s", query.key.c_str());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnReplaceRecord(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    QueryOption query;
+    std::shared_ptr<UnifiedRecord> record;
+    if (!ITypesUtil::Unmarshal(data, query, record)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal query and record");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    MemoryCharge charge(MEMORY_DECODED_RECORD, record == nullptr ? 0 : record->GetSize());
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    query.tokenId = token;
+    RequestRecorder::GetInstance().SetQuery(query.key, query.version);
+    RequestRecorder::GetInstance().AddRecord(record);
+    int32_t status = ReplaceRecord(query, record);
+    if (!ITypesUtil::Marshal(reply, status)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal status, key: %{public}s", query.key.c_str());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
 int32_t UdmfServiceStub::OnGetData(MessageParcel &data, MessageParcel &reply)
 {
     LOG_INFO(UDMF_SERVICE, "start");
@@ -96,9 +211,12 @@ int32_t UdmfServiceStub::OnGetData(MessageParcel &data, MessageParcel &reply)
     query.tokenId = token;
     int32_t pid = static_cast<int>(IPCSkeleton::GetCallingPid());
     query.pid = pid;
+    RequestRecorder::GetInstance().SetQuery(query.key, query.version);
     UnifiedData unifiedData;
     int32_t status = GetData(query, unifiedData);
-    if (!ITypesUtil::Marshal(reply, status, unifiedData)) {
+    RequestRecorder::GetInstance().AddData(unifiedData);
+    MemoryCharge charge(MEMORY_DECODED_RECORD, unifiedData.GetSize());
+    if (!ITypesUtil::Marshal(reply, status, unifiedData, query.validator)) {
         LOG_ERROR(UDMF_SERVICE, "Marshal ud data, key: %{public}s", query.key.c_str());
         return IPC_STUB_WRITE_PARCEL_ERR;
     }
@@ -115,15 +233,127 @@ int32_t UdmfServiceStub::OnGetSummary(MessageParcel &data, MessageParcel &reply)
     }
     int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
     query.tokenId = token;
+    RequestRecorder::GetInstance().SetQuery(query.key, query.version);
     Summary summary;
     int32_t status = GetSummary(query, summary);
-    if (!ITypesUtil::Marshal(reply, status, summary)) {
+    if (!ITypesUtil::Marshal(reply, status, summary, query.validator)) {
         LOG_ERROR(UDMF_SERVICE, "Marshal summary, key: %{public}s", query.key.c_str());
         return IPC_STUB_WRITE_PARCEL_ERR;
     }
     return E_OK;
 }
 
+int32_t UdmfServiceStub::OnGetPreview(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    QueryOption query;
+    if (!ITypesUtil::Unmarshal(data, query)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal query");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    query.tokenId = token;
+    int32_t pid = static_cast<int>(IPCSkeleton::GetCallingPid());
+    query.pid = pid;
+    RequestRecorder::GetInstance().SetQuery(query.key, query.version);
+    Preview preview;
+    int32_t status = GetPreview(query, preview);
+    if (!ITypesUtil::Marshal(reply, status, preview, query.validator)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal preview, key: %{public}s", query.key.c_str());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnEnumerateFolder(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    QueryOption query;
+    std::string uri;
+    std::string cursor;
+    uint32_t count = 0;
+    if (!ITypesUtil::Unmarshal(data, query, uri, cursor, count)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal query");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    query.tokenId = token;
+    int32_t pid = static_cast<int>(IPCSkeleton::GetCallingPid());
+    query.pid = pid;
+    RequestRecorder::GetInstance().SetQuery(query.key, query.version);
+    FolderBatch batch;
+    int32_t status = EnumerateFolder(query, uri, cursor, count, batch);
+    if (!ITypesUtil::Marshal(reply, status, batch)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal folder batch, key: %{public}s", query.key.c_str());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnQueryKeys(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    QueryCondition condition;
+    if (!ITypesUtil::Unmarshal(data, condition)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal condition");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    condition.tokenId = token;
+    int32_t pid = static_cast<int>(IPCSkeleton::GetCallingPid());
+    condition.pid = pid;
+    RequestRecorder::GetInstance().SetIntention(condition.intention);
+    std::vector<std::string> keys;
+    int32_t status = QueryKeys(condition, keys);
+    RequestRecorder::GetInstance().SetResult(keys);
+    if (!ITypesUtil::Marshal(reply, status, keys, condition.cursor)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal keys, intention: %{public}d", condition.intention);
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnSubscribe(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    SubscribeOption option;
+    if (!ITypesUtil::Unmarshal(data, option)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal option");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    sptr<IRemoteObject> observer = data.ReadRemoteObject();
+    if (observer == nullptr) {
+        LOG_ERROR(UDMF_SERVICE, "Read observer");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t token = static_cast<int>(IPCSkeleton::GetCallingTokenID());
+    option.tokenId = token;
+    // the notices tell the keys of the data saved by others, so the subscriber is authorized here against the read
+    // permission of udmf data once, and then told of every data saved to the intention
+    int32_t status = VerifyPermission(READ_PERMISSION) ? Subscribe(option, observer) : E_NO_PERMISSION;
+    if (!ITypesUtil::Marshal(reply, status)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal status: %{public}d", status);
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnUnsubscribe(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    sptr<IRemoteObject> observer = data.ReadRemoteObject();
+    if (observer == nullptr) {
+        LOG_ERROR(UDMF_SERVICE, "Read observer");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t status = Unsubscribe(observer);
+    if (!ITypesUtil::Marshal(reply, status)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal status: %{public}d", status);
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
 int32_t UdmfServiceStub::OnAddPrivilege(MessageParcel &data, MessageParcel &reply)
 {
     LOG_INFO(UDMF_SERVICE, "start");
@@ -162,6 +392,94 @@ int32_t UdmfServiceStub::OnSync(MessageParcel &data, MessageParcel &reply)
     return E_OK;
 }
 
+int32_t UdmfServiceStub::OnSetTraceEnabled(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    bool enabled = false;
+    if (!ITypesUtil::Unmarshal(data, enabled)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal enabled");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t status = IsDumpAllowed() ? SetTraceEnabled(enabled) : E_NO_PERMISSION;
+    if (!ITypesUtil::Marshal(reply, status)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal status: %{public}d", status);
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnDumpTrace(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    std::string events;
+    int32_t status = IsDumpAllowed() ? DumpTrace(events) : E_NO_PERMISSION;
+    // a full ring buffer of spans is larger than the default capacity of a parcel
+    reply.SetMaxCapacity(MAX_TRACE_CAPACITY);
+    if (!ITypesUtil::Marshal(reply, status, events)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal trace, size: %{public}zu", events.size());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnDumpStats(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    std::string stats;
+    int32_t status = IsDumpAllowed() ? DumpStats(stats) : E_NO_PERMISSION;
+    if (!ITypesUtil::Marshal(reply, status, stats)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal stats, size: %{public}zu", stats.size());
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+int32_t UdmfServiceStub::OnSetRecordEnabled(MessageParcel &data, MessageParcel &reply)
+{
+    LOG_INFO(UDMF_SERVICE, "start");
+    bool enabled = false;
+    if (!ITypesUtil::Unmarshal(data, enabled)) {
+        LOG_ERROR(UDMF_SERVICE, "Unmarshal enabled");
+        return IPC_STUB_INVALID_DATA_ERR;
+    }
+    int32_t status = IsDumpAllowed() ? SetRecordEnabled(enabled) : E_NO_PERMISSION;
+    if (!ITypesUtil::Marshal(reply, status)) {
+        LOG_ERROR(UDMF_SERVICE, "Marshal status: %{public}d", status);
+        return IPC_STUB_WRITE_PARCEL_ERR;
+    }
+    return E_OK;
+}
+
+uint64_t UdmfServiceStub::ReadRequestId(MessageParcel &data)
+{
+    // the id is in the trailer of the request, a client sending none has its requests traced under no id
+    size_t position = data.GetReadPosition();
+    size_t size = data.GetDataSize();
+    if (size < position + REQUEST_ID_TRAILER_SIZE) {
+        return 0;
+    }
+    data.RewindRead(size - REQUEST_ID_TRAILER_SIZE);
+    uint64_t requestId = data.ReadUint64();
+    uint32_t marker = data.ReadUint32();
+    data.RewindRead(position);
+    return marker == REQUEST_ID_MARKER ? requestId : 0;
+}
+
+int32_t UdmfServiceStub::ReadStatus(MessageParcel &reply)
+{
+    // every reply starts with the status, which is read ahead and left for the caller
+    size_t position = reply.GetReadPosition();
+    int32_t status = reply.ReadInt32();
+    reply.RewindRead(position);
+    return status;
+}
+
+bool UdmfServiceStub::IsDumpAllowed()
+{
+    auto tokenType = Security::AccessToken::AccessTokenKit::GetTokenTypeFlag(IPCSkeleton::GetCallingTokenID());
+    return tokenType == Security::AccessToken::TOKEN_NATIVE || tokenType == Security::AccessToken::TOKEN_SHELL;
+}
+
 /*
  * Check whether the caller has the permission to access data.
  */